@@ -1,28 +1,98 @@
 #include "fx_canvas.h"
 
+#include <string.h>
+
 #include "matrix_ws2812.h"
 #include "esp_log.h"
 
 static const char *TAG = "FX_CANVAS";
 
-/* RGB буфер: 3 байта на пиксель */
-static uint8_t s_buf[(uint32_t)MATRIX_W * (uint32_t)MATRIX_H * 3u];
+/* RGB буфер: 3 байта на пиксель. Выровнен на 4: bulk-ядра ниже работают словами. */
+#define FX_CANVAS_ROW_BYTES   ((uint32_t)MATRIX_W * 3u)
+#define FX_CANVAS_BYTES       (FX_CANVAS_ROW_BYTES * (uint32_t)MATRIX_H)
+
+/* Банки базы (fx_canvas_bank_select): s_buf/s_row0 — текущий банк, у остальных кольцо
+ * хранится в s_bank_row0 до обратного переключения. */
+static uint8_t  s_bank_buf[FX_CANVAS_BANKS][FX_CANVAS_BYTES] __attribute__((aligned(4)));
+static uint16_t s_bank_row0[FX_CANVAS_BANKS];
+static uint8_t  s_bank = 0;
+
+static uint8_t *s_buf = s_bank_buf[0];
+
+/* Кольцевое смещение строк: логическая строка y лежит в физической (y + s_row0) % MATRIX_H.
+ * Скролл на строку = сдвиг s_row0 + заливка одной новой строки (O(W) вместо O(W*H)).
+ * Маппинг разворачивается только в fx_canvas_present(). */
+static uint16_t s_row0 = 0;
+
+/* Подмена базы на один present (fx_canvas_present_source): строки смежные, без кольца */
+static const uint8_t *s_present_src = NULL;
+
+static inline uint32_t phys_row(uint16_t y)
+{
+    uint32_t r = (uint32_t)y + s_row0;
+    if (r >= MATRIX_H) r -= MATRIX_H;
+    return r;
+}
 
 static inline uint32_t idx_of(uint16_t x, uint16_t y)
 {
-    return ((uint32_t)y * (uint32_t)MATRIX_W + (uint32_t)x) * 3u;
+    return (phys_row(y) * (uint32_t)MATRIX_W + (uint32_t)x) * 3u;
 }
 
-void fx_canvas_clear(uint8_t r, uint8_t g, uint8_t b)
+/* ============================================================
+ * Bulk-ядра (portable C, без SIMD-интринсиков)
+ * ============================================================ */
+
+/* Заливка строки цветом. 4 пикселя = 12 байт = 3 слова: паттерн собирается один раз,
+ * дальше пишутся слова. Хвост строки (W не кратно 4) — побайтно. */
+static void fill_row(uint8_t *row, uint8_t r, uint8_t g, uint8_t b)
 {
-    for (uint16_t y = 0; y < MATRIX_H; y++) {
-        for (uint16_t x = 0; x < MATRIX_W; x++) {
-            const uint32_t i = idx_of(x, y);
-            s_buf[i + 0] = r;
-            s_buf[i + 1] = g;
-            s_buf[i + 2] = b;
+    uint8_t pat_b[12];
+    for (uint32_t i = 0; i < 12u; i += 3u) {
+        pat_b[i + 0] = r;
+        pat_b[i + 1] = g;
+        pat_b[i + 2] = b;
+    }
+    uint32_t pat[3];
+    memcpy(pat, pat_b, sizeof(pat));
+
+    uint32_t x = 0;
+    if ((((uintptr_t)row) & 3u) == 0) {
+        uint32_t *w = (uint32_t *)row;
+        for (; x + 4u <= MATRIX_W; x += 4u, w += 3) {
+            w[0] = pat[0];
+            w[1] = pat[1];
+            w[2] = pat[2];
         }
     }
+    for (; x < MATRIX_W; x++) {
+        row[x * 3u + 0] = r;
+        row[x * 3u + 1] = g;
+        row[x * 3u + 2] = b;
+    }
+}
+
+void fx_canvas_clear(uint8_t r, uint8_t g, uint8_t b)
+{
+    if (MATRIX_H == 0 || MATRIX_W == 0) return;
+
+    s_row0 = 0;   // весь кадр перезаписывается: кольцо можно сбросить
+
+    if (r == g && g == b) {
+        memset(s_buf, r, FX_CANVAS_BYTES);
+        return;
+    }
+
+    fill_row(s_buf, r, g, b);
+    for (uint32_t y = 1; y < MATRIX_H; y++) {
+        memcpy(&s_buf[y * FX_CANVAS_ROW_BYTES], s_buf, FX_CANVAS_ROW_BYTES);
+    }
+}
+
+uint8_t *fx_canvas_row(uint16_t y)
+{
+    if (y >= MATRIX_H) return NULL;
+    return &s_buf[idx_of(0, y)];
 }
 
 void fx_canvas_set(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
@@ -46,47 +116,62 @@ bool fx_canvas_get(uint16_t x, uint16_t y, uint8_t *r, uint8_t *g, uint8_t *b)
 
 void fx_canvas_dim(uint8_t scale)
 {
-    /* scale 0..255: (v*scale)/255 */
-    const uint32_t n = (uint32_t)MATRIX_W * (uint32_t)MATRIX_H * 3u;
-    for (uint32_t i = 0; i < n; i++) {
-        const uint16_t v = s_buf[i];
-        s_buf[i] = (uint8_t)((v * (uint16_t)scale) / 255u);
+    /* scale 0..255: (v*scale)/255, результат бит-в-бит как у деления.
+     *
+     * Деление заменено на x/255 == (x + 1 + (x >> 8)) >> 8 (точно для x <= 65534,
+     * у нас x <= 255*255). SWAR: слово = 4 байта, чётные/нечётные байты разносятся
+     * в две пары 16-битных полос; v*scale и промежуточная сумма (<= 65280) в полосу
+     * влезают, переносов между полосами нет.
+     */
+    if (scale == 255u) return;
+    if (scale == 0u) {
+        memset(s_buf, 0, FX_CANVAS_BYTES);
+        return;
+    }
+
+    const uint32_t m  = 0x00FF00FFu;
+    const uint32_t s  = scale;
+    uint32_t *w = (uint32_t *)s_buf;
+    const uint32_t nw = FX_CANVAS_BYTES / 4u;
+
+    for (uint32_t i = 0; i < nw; i++) {
+        const uint32_t v  = w[i];
+        uint32_t lo = (v & m) * s;
+        uint32_t hi = ((v >> 8) & m) * s;
+        lo = ((lo + 0x00010001u + ((lo >> 8) & m)) >> 8) & m;
+        hi = ((hi + 0x00010001u + ((hi >> 8) & m)) >> 8) & m;
+        w[i] = lo | (hi << 8);
+    }
+
+    /* хвост, если размер кадра не кратен 4 */
+    for (uint32_t i = nw * 4u; i < FX_CANVAS_BYTES; i++) {
+        const uint32_t x = (uint32_t)s_buf[i] * s;
+        s_buf[i] = (uint8_t)((x + 1u + (x >> 8)) >> 8);
     }
 }
 
+/* Сдвиги: данные не двигаются, меняется только s_row0 (+ заливка одной новой строки) */
+
 void fx_canvas_shift_down(uint8_t fill_r, uint8_t fill_g, uint8_t fill_b)
 {
     if (MATRIX_H == 0 || MATRIX_W == 0) return;
 
-    for (int y = (int)MATRIX_H - 1; y >= 1; y--) {
-        for (uint16_t x = 0; x < MATRIX_W; x++) {
-            uint8_t r, g, b;
-            (void)fx_canvas_get(x, (uint16_t)(y - 1), &r, &g, &b);
-            fx_canvas_set(x, (uint16_t)y, r, g, b);
-        }
-    }
+    /* dest[y] = src[y-1]: логическая 0 уезжает в 1 -> row0 на строку назад */
+    s_row0 = (uint16_t)((s_row0 == 0) ? (MATRIX_H - 1u) : (s_row0 - 1u));
 
     /* top row fill */
-    for (uint16_t x = 0; x < MATRIX_W; x++) {
-        fx_canvas_set(x, 0, fill_r, fill_g, fill_b);
-    }
+    fill_row(&s_buf[idx_of(0, 0)], fill_r, fill_g, fill_b);
 }
 
 void fx_canvas_shift_towards_y0(uint8_t r0, uint8_t g0, uint8_t b0)
 {
-    // Двигаем всё к меньшим y: dest[y] = src[y+1]
-    for (int y = 0; y < (int)MATRIX_H - 1; y++) {
-        for (int x = 0; x < (int)MATRIX_W; x++) {
-            uint8_t r, g, b;
-            fx_canvas_get((uint16_t)x, (uint16_t)(y + 1), &r, &g, &b);
-            fx_canvas_set((uint16_t)x, (uint16_t)y, r, g, b);
-        }
-    }
+    if (MATRIX_H == 0 || MATRIX_W == 0) return;
+
+    // Двигаем всё к меньшим y: dest[y] = src[y+1] -> row0 на строку вперёд
+    s_row0 = (uint16_t)phys_row(1);
 
     // Верхнюю строку заполняем фоном
-    for (int x = 0; x < (int)MATRIX_W; x++) {
-        fx_canvas_set((uint16_t)x, (uint16_t)(MATRIX_H - 1), r0, g0, b0);
-    }
+    fill_row(&s_buf[idx_of(0, (uint16_t)(MATRIX_H - 1u))], r0, g0, b0);
 }
 
 
@@ -94,26 +179,378 @@ void fx_canvas_shift_up(uint8_t fill_r, uint8_t fill_g, uint8_t fill_b)
 {
     if (MATRIX_H == 0 || MATRIX_W == 0) return;
 
-    for (uint16_t y = 0; y + 1 < MATRIX_H; y++) {
-        for (uint16_t x = 0; x < MATRIX_W; x++) {
-            uint8_t r, g, b;
-            (void)fx_canvas_get(x, (uint16_t)(y + 1), &r, &g, &b);
-            fx_canvas_set(x, y, r, g, b);
+    s_row0 = (uint16_t)phys_row(1);
+
+    /* bottom row fill */
+    fill_row(&s_buf[idx_of(0, (uint16_t)(MATRIX_H - 1u))], fill_r, fill_g, fill_b);
+}
+
+void fx_canvas_load(const uint8_t *rgb)
+{
+    if (!rgb) return;
+    s_row0 = 0;
+    memcpy(s_buf, rgb, FX_CANVAS_BYTES);
+}
+
+void fx_canvas_bank_select(uint8_t bank)
+{
+    if (bank >= FX_CANVAS_BANKS || bank == s_bank) return;
+    s_bank_row0[s_bank] = s_row0;
+    s_bank = bank;
+    s_buf = s_bank_buf[bank];
+    s_row0 = s_bank_row0[bank];
+}
+
+uint8_t fx_canvas_bank_current(void)
+{
+    return s_bank;
+}
+
+void fx_canvas_bank_copy(uint8_t dst, uint8_t src)
+{
+    if (dst >= FX_CANVAS_BANKS || src >= FX_CANVAS_BANKS || dst == src) return;
+    s_bank_row0[s_bank] = s_row0;
+    memcpy(s_bank_buf[dst], s_bank_buf[src], FX_CANVAS_BYTES);
+    s_bank_row0[dst] = s_bank_row0[src];
+    if (dst == s_bank) s_row0 = s_bank_row0[dst];
+}
+
+/* ============================================================
+ * Слои (compositor)
+ *
+ * Слой = RGBA (4 байта/px, логические координаты без кольца) + blend + dirty rect.
+ * a == 0 — пиксель прозрачен; для ADD/MAX a только помечает покрытие,
+ * для ALPHA — непрозрачность. Слои живут один кадр: present() сводит их
+ * поверх базы и чистит только dirty rect.
+ * ============================================================ */
+
+#define FX_LAYER_ROW_BYTES   ((uint32_t)MATRIX_W * 4u)
+
+typedef struct {
+    uint8_t    px[(uint32_t)MATRIX_W * (uint32_t)MATRIX_H * 4u];
+    fx_blend_t blend;
+    bool       dirty;
+    uint16_t   x0, y0, x1, y1;   // dirty rect, [x0,x1) x [y0,y1)
+} fx_layer_buf_t;
+
+static fx_layer_buf_t s_layers[FX_LAYER_COUNT] = {
+    [FX_LAYER_PARTICLES] = { .blend = FX_BLEND_ADD },
+    [FX_LAYER_OVERLAY]   = { .blend = FX_BLEND_REPLACE },
+};
+
+static inline void layer_touch(fx_layer_buf_t *l, uint16_t x, uint16_t y)
+{
+    if (!l->dirty) {
+        l->dirty = true;
+        l->x0 = x; l->x1 = (uint16_t)(x + 1u);
+        l->y0 = y; l->y1 = (uint16_t)(y + 1u);
+        return;
+    }
+    if (x <  l->x0) l->x0 = x;
+    if (x >= l->x1) l->x1 = (uint16_t)(x + 1u);
+    if (y <  l->y0) l->y0 = y;
+    if (y >= l->y1) l->y1 = (uint16_t)(y + 1u);
+}
+
+void fx_layer_set_blend(fx_layer_t layer, fx_blend_t mode)
+{
+    if ((unsigned)layer >= FX_LAYER_COUNT) return;
+    s_layers[layer].blend = mode;
+}
+
+void fx_layer_clear(fx_layer_t layer)
+{
+    if ((unsigned)layer >= FX_LAYER_COUNT) return;
+    fx_layer_buf_t *l = &s_layers[layer];
+    if (!l->dirty) return;
+
+    const uint32_t n = (uint32_t)(l->x1 - l->x0) * 4u;
+    for (uint16_t y = l->y0; y < l->y1; y++) {
+        memset(&l->px[(uint32_t)y * FX_LAYER_ROW_BYTES + (uint32_t)l->x0 * 4u], 0, n);
+    }
+    l->dirty = false;
+}
+
+void fx_layer_set(fx_layer_t layer, uint16_t x, uint16_t y,
+                  uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+    if ((unsigned)layer >= FX_LAYER_COUNT || x >= MATRIX_W || y >= MATRIX_H) return;
+    fx_layer_buf_t *l = &s_layers[layer];
+    uint8_t *p = &l->px[(uint32_t)y * FX_LAYER_ROW_BYTES + (uint32_t)x * 4u];
+    p[0] = r;
+    p[1] = g;
+    p[2] = b;
+    p[3] = a;
+    layer_touch(l, x, y);
+}
+
+bool fx_layer_get_dirty(fx_layer_t layer, uint16_t *x0, uint16_t *y0, uint16_t *x1, uint16_t *y1)
+{
+    if ((unsigned)layer >= FX_LAYER_COUNT) return false;
+    const fx_layer_buf_t *l = &s_layers[layer];
+    if (!l->dirty) return false;
+    if (x0) *x0 = l->x0;
+    if (y0) *y0 = l->y0;
+    if (x1) *x1 = l->x1;
+    if (y1) *y1 = l->y1;
+    return true;
+}
+
+static inline uint8_t qadd8(uint8_t a, uint8_t b)
+{
+    const uint16_t s = (uint16_t)a + b;
+    return (uint8_t)(s > 255u ? 255u : s);
+}
+
+/* ============================================================
+ * HDR-накопитель (16 бит/канал)
+ *
+ * Аддитивные частицы складываются без clamp; в present сумма база+HDR проходит
+ * один tone-map: пиксель, у которого канал вылез за 255, не режется по каналам,
+ * а "перетекает в белый" с сохранением суммы каналов (r+g+b). Для пикселей в
+ * пределах 8 бит tone-map — тождество, поэтому база вне искр не меняется.
+ * Gamma и яркость остаются в выходном каскаде matrix_ws2812 (один проход на байт).
+ * ============================================================ */
+
+#if FX_CANVAS_HDR_ENABLE
+static uint16_t s_hdr[(uint32_t)MATRIX_W * (uint32_t)MATRIX_H * 3u];
+static uint32_t s_hdr_cols[MATRIX_H];   // по строке: биты x, в которые что-то добавлено за кадр
+static bool     s_hdr_dirty = false;
+static uint16_t s_hdr_y0, s_hdr_y1;     // строки с ненулевой маской лежат в [y0,y1)
+
+/* Искры редкие: rect по всем записям кадра почти всегда весь экран, а тронуто 10-30% пикселей.
+ * Маска столбцов на строку: tone-map и очистка идут только по тронутым пикселям. */
+_Static_assert(MATRIX_W <= 32u, "s_hdr_cols: one 32-bit word per row");
+
+void fx_canvas_hdr_add(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (x >= MATRIX_W || y >= MATRIX_H) return;
+
+    /* запас 16 бит: >250 полных белых сложений в пиксель за кадр, на практике недостижимо */
+    uint16_t *p = &s_hdr[((uint32_t)y * MATRIX_W + x) * 3u];
+    p[0] = (uint16_t)(p[0] + r);
+    p[1] = (uint16_t)(p[1] + g);
+    p[2] = (uint16_t)(p[2] + b);
+    s_hdr_cols[y] |= 1u << x;
+
+    if (!s_hdr_dirty) {
+        s_hdr_dirty = true;
+        s_hdr_y0 = y; s_hdr_y1 = (uint16_t)(y + 1u);
+        return;
+    }
+    if (y <  s_hdr_y0) s_hdr_y0 = y;
+    if (y >= s_hdr_y1) s_hdr_y1 = (uint16_t)(y + 1u);
+}
+
+static void hdr_clear(void)
+{
+    if (!s_hdr_dirty) return;
+    for (uint16_t y = s_hdr_y0; y < s_hdr_y1; y++) {
+        uint16_t *h = &s_hdr[(uint32_t)y * MATRIX_W * 3u];
+        for (uint32_t m = s_hdr_cols[y]; m; m &= m - 1u) {
+            uint16_t *p = &h[(uint32_t)__builtin_ctz(m) * 3u];
+            p[0] = p[1] = p[2] = 0;
         }
+        s_hdr_cols[y] = 0;
     }
+    s_hdr_dirty = false;
+}
 
-    /* bottom row fill */
-    for (uint16_t x = 0; x < MATRIX_W; x++) {
-        fx_canvas_set(x, (uint16_t)(MATRIX_H - 1), fill_r, fill_g, fill_b);
+static inline bool hdr_row_dirty(uint16_t y)
+{
+    return s_hdr_cols[y] != 0u;
+}
+
+/* база + HDR -> 8 бит (tone-map только там, где есть переполнение).
+ * Строка HDR расходуется: пиксели и маска обнуляются здесь же, hdr_clear() их уже не трогает. */
+static void hdr_tonemap_row(uint16_t y, uint8_t *dst)
+{
+    uint16_t *h = &s_hdr[(uint32_t)y * MATRIX_W * 3u];
+    const uint32_t cols = s_hdr_cols[y];
+    s_hdr_cols[y] = 0;
+
+    for (uint32_t mask = cols; mask; mask &= mask - 1u) {
+        const uint32_t x = (uint32_t)__builtin_ctz(mask);
+        uint16_t *s = &h[x * 3u];
+        uint8_t *d = &dst[x * 3u];
+
+        const uint32_t r = (uint32_t)d[0] + s[0];
+        const uint32_t g = (uint32_t)d[1] + s[1];
+        const uint32_t b = (uint32_t)d[2] + s[2];
+        s[0] = s[1] = s[2] = 0;
+
+        uint32_t m = r;
+        if (g > m) m = g;
+        if (b > m) m = b;
+
+        if (m <= 255u) {
+            d[0] = (uint8_t)r; d[1] = (uint8_t)g; d[2] = (uint8_t)b;
+            continue;
+        }
+
+        const uint32_t sum = r + g + b;
+        if (sum >= 765u) {
+            d[0] = d[1] = d[2] = 255;
+            continue;
+        }
+
+        /* out_i = 255 - k*(m - c_i), k = (765 - sum) / (3m - sum): max -> 255, сумма сохраняется */
+        const uint32_t num = 765u - sum;
+        const uint32_t den = 3u * m - sum;
+        const uint32_t c[3] = { r, g, b };
+        for (int i = 0; i < 3; i++) {
+            const uint32_t dn = (num * (m - c[i])) / den;
+            d[i] = (uint8_t)(dn >= 255u ? 0u : 255u - dn);
+        }
     }
 }
+#else
+/* HDR выключен: накопление в слой частиц с насыщением */
+void fx_canvas_hdr_add(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
+{
+    fx_layer_add(FX_LAYER_PARTICLES, x, y, r, g, b);
+}
 
-void fx_canvas_present(void)
+static inline void hdr_clear(void) {}
+static inline bool hdr_row_dirty(uint16_t y) { (void)y; return false; }
+static inline void hdr_tonemap_row(uint16_t y, uint8_t *dst) { (void)y; (void)dst; }
+#endif
+
+void fx_layer_add(fx_layer_t layer, uint16_t x, uint16_t y,
+                  uint8_t r, uint8_t g, uint8_t b)
+{
+    if ((unsigned)layer >= FX_LAYER_COUNT || x >= MATRIX_W || y >= MATRIX_H) return;
+    fx_layer_buf_t *l = &s_layers[layer];
+    uint8_t *p = &l->px[(uint32_t)y * FX_LAYER_ROW_BYTES + (uint32_t)x * 4u];
+    p[0] = qadd8(p[0], r);
+    p[1] = qadd8(p[1], g);
+    p[2] = qadd8(p[2], b);
+    p[3] = 255;
+    layer_touch(l, x, y);
+}
+
+/* (a*b)/255 без деления, точно для 8x8 бит */
+static inline uint8_t mul255(uint32_t a, uint32_t b)
+{
+    const uint32_t x = a * b;
+    return (uint8_t)((x + 1u + (x >> 8)) >> 8);
+}
+
+/* Свести полосу [x0,x1) одного слоя в строку RGB dst */
+static void layer_blend_row(const fx_layer_buf_t *l, uint16_t y, uint8_t *dst)
 {
+    const uint8_t *src = &l->px[(uint32_t)y * FX_LAYER_ROW_BYTES];
+
+    for (uint16_t x = l->x0; x < l->x1; x++) {
+        const uint8_t *s = &src[(uint32_t)x * 4u];
+        const uint8_t a = s[3];
+        if (a == 0) continue;
+
+        uint8_t *d = &dst[(uint32_t)x * 3u];
+        switch (l->blend) {
+        case FX_BLEND_REPLACE:
+            d[0] = s[0]; d[1] = s[1]; d[2] = s[2];
+            break;
+        case FX_BLEND_ADD:
+            d[0] = qadd8(d[0], s[0]); d[1] = qadd8(d[1], s[1]); d[2] = qadd8(d[2], s[2]);
+            break;
+        case FX_BLEND_MAX:
+            if (s[0] > d[0]) d[0] = s[0];
+            if (s[1] > d[1]) d[1] = s[1];
+            if (s[2] > d[2]) d[2] = s[2];
+            break;
+        case FX_BLEND_ALPHA:
+        default: {
+            const uint32_t ia = 255u - a;
+            d[0] = (uint8_t)(mul255(s[0], a) + mul255(d[0], ia));
+            d[1] = (uint8_t)(mul255(s[1], a) + mul255(d[1], ia));
+            d[2] = (uint8_t)(mul255(s[2], a) + mul255(d[2], ia));
+            break;
+        }
+        }
+    }
+}
+
+void fx_canvas_present_source(const uint8_t *rgb)
+{
+    s_present_src = rgb;
+}
+
+void fx_canvas_flatten(const uint8_t *src, uint8_t *dst)
+{
+    if (!dst) return;
+
+    const fx_layer_buf_t *l = &s_layers[FX_LAYER_PARTICLES];
     for (uint16_t y = 0; y < MATRIX_H; y++) {
-        for (uint16_t x = 0; x < MATRIX_W; x++) {
-            const uint32_t i = idx_of(x, y);
-            matrix_ws2812_set_pixel_xy(x, y, s_buf[i + 0], s_buf[i + 1], s_buf[i + 2]);
+        uint8_t *d = &dst[(uint32_t)y * FX_CANVAS_ROW_BYTES];
+        memcpy(d, src ? &src[(uint32_t)y * FX_CANVAS_ROW_BYTES] : &s_buf[idx_of(0, y)], FX_CANVAS_ROW_BYTES);
+        if (hdr_row_dirty(y)) hdr_tonemap_row(y, d);
+        if (l->dirty && y >= l->y0 && y < l->y1) layer_blend_row(l, y, d);
+    }
+
+    hdr_clear();
+    fx_layer_clear(FX_LAYER_PARTICLES);
+}
+
+static inline const uint8_t *present_row(uint16_t y)
+{
+    return s_present_src ? &s_present_src[(uint32_t)y * FX_CANVAS_ROW_BYTES] : &s_buf[idx_of(0, y)];
+}
+
+void fx_canvas_present(void)
+{
+    /* Один проход по логическим строкам:
+     *   - строки без грязных слоёв уходят bulk-куском прямо из базы
+     *     (кольцо s_row0 режет кадр максимум на два куска);
+     *   - строка под dirty rect HDR или любого слоя: база -> tmp, +HDR/tone-map,
+     *     слои по порядку, tmp -> WS2812.
+     * База не меняется (эффекты с персистентным canvas видят свой кадр без оверлеев). */
+    uint8_t tmp[FX_CANVAS_ROW_BYTES];
+
+    uint16_t y = 0;
+    while (y < MATRIX_H) {
+        bool dirty = hdr_row_dirty(y);
+        for (uint32_t li = 0; li < FX_LAYER_COUNT; li++) {
+            const fx_layer_buf_t *l = &s_layers[li];
+            if (l->dirty && y >= l->y0 && y < l->y1) { dirty = true; break; }
+        }
+
+        if (dirty) {
+            memcpy(tmp, present_row(y), FX_CANVAS_ROW_BYTES);
+            if (hdr_row_dirty(y)) hdr_tonemap_row(y, tmp);
+            for (uint32_t li = 0; li < FX_LAYER_COUNT; li++) {
+                const fx_layer_buf_t *l = &s_layers[li];
+                if (l->dirty && y >= l->y0 && y < l->y1) layer_blend_row(l, y, tmp);
+            }
+            matrix_ws2812_blit_rows(tmp, y, 1);
+            y++;
+            continue;
+        }
+
+        /* серия чистых строк до следующего dirty rect или до шва кольца */
+        uint16_t end = MATRIX_H;
+        const uint16_t seam = (uint16_t)(MATRIX_H - s_row0);
+        if (!s_present_src && y < seam && seam < end) end = seam;
+        for (uint32_t li = 0; li < FX_LAYER_COUNT; li++) {
+            const fx_layer_buf_t *l = &s_layers[li];
+            if (l->dirty && l->y0 > y && l->y0 < end) end = l->y0;
         }
+#if FX_CANVAS_HDR_ENABLE
+        if (s_hdr_dirty) {
+            for (uint16_t yy = (uint16_t)(y + 1u); yy < end && yy < s_hdr_y1; yy++) {
+                if (s_hdr_cols[yy]) { end = yy; break; }
+            }
+        }
+#endif
+
+        matrix_ws2812_blit_rows(present_row(y), y, (uint16_t)(end - y));
+        y = end;
+    }
+
+    /* HDR, слои и подмена базы живут один кадр */
+    s_present_src = NULL;
+    hdr_clear();
+    for (uint32_t li = 0; li < FX_LAYER_COUNT; li++) {
+        fx_layer_clear((fx_layer_t)li);
     }
 }
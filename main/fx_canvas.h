@@ -14,14 +14,25 @@ extern "C" {
  *   - Позволяет делать fade/shift и прочие штуки без readback из WS2812.
  *
  * Модель:
- *   - Эффект пишет в canvas.
- *   - В конце кадра вызывает fx_canvas_present(), который копирует в matrix_ws2812.
+ *   - Эффект пишет в canvas (база, персистентна между кадрами).
+ *   - Частицы/оверлеи пишут в слои (fx_layer_*): RGBA + режим смешивания + dirty rect,
+ *     без readback базы (get/set round-trip).
+ *   - fx_canvas_present() вызывает только matrix_anim (после эффекта и оверлеев): один проход
+ *     база + слои -> back-буфер matrix_ws2812. Строки вне dirty rect всех слоёв копируются
+ *     bulk-кусками, чистые слои не трогаются вообще. После present слои очищаются
+ *     (в пределах dirty rect), база остаётся как есть.
+ *   - Строки хранятся кольцом (логическое смещение строк): shift_* — O(W), данные не двигаются,
+ *     get/set/row работают в логических координатах, маппинг разворачивается в present().
  * ============================================================ */
 
 void fx_canvas_clear(uint8_t r, uint8_t g, uint8_t b);
 void fx_canvas_set(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b);
 bool fx_canvas_get(uint16_t x, uint16_t y, uint8_t *r, uint8_t *g, uint8_t *b);
 
+/* Прямой доступ к логической строке canvas (RGB, MATRIX_W*3 байт). NULL если y вне диапазона.
+ * Указатель валиден до следующего shift_*: строки между собой не смежны. */
+uint8_t *fx_canvas_row(uint16_t y);
+
 /* Уменьшение яркости всех пикселей: scale=255 -> без изменений, 0 -> в ноль */
 void fx_canvas_dim(uint8_t scale);
 
@@ -31,9 +42,74 @@ void fx_canvas_shift_down(uint8_t fill_r, uint8_t fill_g, uint8_t fill_b);
 void fx_canvas_shift_towards_y0(uint8_t r0, uint8_t g0, uint8_t b0);
 void fx_canvas_shift_up(uint8_t fill_r, uint8_t fill_g, uint8_t fill_b);
 
-/* Копирование canvas -> matrix_ws2812_set_pixel_xy(...) */
+/* Загрузить целый кадр в базу (row-major RGB, MATRIX_W*MATRIX_H*3 байт), сбрасывает кольцо */
+void fx_canvas_load(const uint8_t *rgb);
+
+/* ---------------- Банки базы ---------------- */
+
+/* Независимые базы (со своим кольцом строк) для перехода между эффектами: уходящий и входящий
+ * рисуют каждый в свой банк, не затирая друг другу персистентный canvas. Все fx_canvas_*
+ * (кроме слоёв и HDR — они общие) работают с текущим банком. Переключает только fx_engine. */
+#define FX_CANVAS_BANKS     2
+
+void    fx_canvas_bank_select(uint8_t bank);
+uint8_t fx_canvas_bank_current(void);
+/* Копия банка целиком (вместе с кольцом): входящий эффект стартует с картинки уходящего */
+void    fx_canvas_bank_copy(uint8_t dst, uint8_t src);
+
+/* ---------------- Слои ---------------- */
+
+typedef enum {
+    FX_LAYER_PARTICLES = 0,   // частицы эффекта (по умолчанию ADD)
+    FX_LAYER_OVERLAY,         // системные оверлеи поверх эффекта (по умолчанию REPLACE)
+    FX_LAYER_COUNT
+} fx_layer_t;
+
+typedef enum {
+    FX_BLEND_REPLACE = 0,     // dst = src
+    FX_BLEND_ADD,             // dst = sat(dst + src)
+    FX_BLEND_ALPHA,           // dst = lerp(dst, src, a)
+    FX_BLEND_MAX,             // dst = max(dst, src) по каналам
+} fx_blend_t;
+
+void fx_layer_set_blend(fx_layer_t layer, fx_blend_t mode);
+void fx_layer_clear(fx_layer_t layer);
+/* a == 0 — пиксель прозрачен (слой его не трогает) */
+void fx_layer_set(fx_layer_t layer, uint16_t x, uint16_t y,
+                  uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+/* Насыщающее сложение внутри слоя (накопление частиц), a = 255 */
+void fx_layer_add(fx_layer_t layer, uint16_t x, uint16_t y,
+                  uint8_t r, uint8_t g, uint8_t b);
+/* Dirty rect слоя [x0,x1) x [y0,y1) (телеметрия/тесты). false — слой чистый: present его не сводит.
+ * Указатели могут быть NULL. */
+bool fx_layer_get_dirty(fx_layer_t layer, uint16_t *x0, uint16_t *y0, uint16_t *x1, uint16_t *y1);
+
+/* ---------------- HDR-накопитель ---------------- */
+
+/* 16 бит/канал поверх базы: аддитивные частицы без clamp на каждой записи.
+ * В present: база + HDR -> один tone-map (переполнение уходит в белый с сохранением r+g+b)
+ * -> слои. Живёт один кадр. При FX_CANVAS_HDR_ENABLE=0 — fx_layer_add(FX_LAYER_PARTICLES). */
+#ifndef FX_CANVAS_HDR_ENABLE
+#define FX_CANVAS_HDR_ENABLE    1
+#endif
+
+void fx_canvas_hdr_add(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b);
+
+/* Композитинг база + HDR + слои -> back-буфер WS2812 (bulk, matrix_ws2812_blit_rows).
+ * Зовёт matrix_anim раз в кадр; эффекты present не вызывают. */
 void fx_canvas_present(void);
 
+/* Подмена базы на один present (post-processing, fx_post): кадр row-major RGB в логических
+ * строках (y=0 — низ), MATRIX_W*MATRIX_H*3 байт. Сама база не меняется — эффекты с
+ * персистентным canvas не получают blur/bloom обратно в следующий кадр. NULL — без подмены. */
+void fx_canvas_present_source(const uint8_t *rgb);
+
+/* Свести кадр (src — row-major RGB как у present_source, NULL — база текущего банка) + HDR +
+ * слой частиц в dst (row-major RGB, логические строки), затем очистить HDR и слой частиц.
+ * OVERLAY не трогается. Нужен переходам: кадр эффекта фиксируется до того, как в общие
+ * HDR/слои начнёт писать другой эффект. */
+void fx_canvas_flatten(const uint8_t *src, uint8_t *dst);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,311 @@
+#include "fx_clip.h"
+
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+
+static const char *TAG = "FX_CLIP";
+
+/* ============================================================
+ * Формат пакета (см. fx_clip.h)
+ * ============================================================ */
+
+#define CPK_MAGIC           0x4B50434Au   // "JCPK"
+#define CPK_VERSION         1u
+#define CPK_HDR_BYTES       12u
+#define CPK_ENTRY_BYTES     (FX_CLIP_NAME_LEN + 4u)
+#define CLIP_HDR_BYTES      16u
+
+#define CLIP_FRAME_KEY      0u
+#define CLIP_FRAME_DELTA    1u
+
+#define CLIP_PIXELS         (MATRIX_W * MATRIX_H)
+
+struct fx_clip_s {
+    uint8_t w, h;
+    uint8_t frames[2], fps_x10[2], pal_n[2], key_every[2], rsv[2], size[4];
+    uint8_t body[];           // palette, frame table, frames
+};
+
+static const uint8_t *s_pack = NULL;
+static uint32_t       s_pack_size = 0;
+static uint16_t       s_count = 0;
+
+static esp_partition_mmap_handle_t s_mmap_handle;
+static bool                        s_mmapped = false;
+
+static inline uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | ((uint16_t)p[1] << 8)); }
+static inline uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline const uint8_t *clip_base(const fx_clip_t *c) { return (const uint8_t *)c; }
+static inline uint16_t clip_pal_n(const fx_clip_t *c) { return rd16(c->pal_n); }
+static inline uint32_t clip_size(const fx_clip_t *c) { return rd32(c->size); }
+static inline const uint8_t *clip_table(const fx_clip_t *c) { return c->body + (uint32_t)clip_pal_n(c) * 3u; }
+
+static inline uint32_t frame_ofs(const fx_clip_t *c, uint16_t f)
+{
+    return rd32(clip_table(c) + (uint32_t)f * 4u);
+}
+
+/* Конец кадра f: начало следующего или конец клипа */
+static inline uint32_t frame_end(const fx_clip_t *c, uint16_t f)
+{
+    return ((uint32_t)f + 1u < rd16(c->frames)) ? frame_ofs(c, (uint16_t)(f + 1u)) : clip_size(c);
+}
+
+/* ============================================================
+ * Подключение пакета
+ * ============================================================ */
+
+static bool clip_valid(const uint8_t *pack, uint32_t total, uint32_t ofs)
+{
+    if (ofs + CLIP_HDR_BYTES > total) return false;
+
+    const fx_clip_t *c = (const fx_clip_t *)(pack + ofs);
+    const uint16_t frames = rd16(c->frames);
+    const uint16_t pal_n  = clip_pal_n(c);
+    const uint32_t size   = clip_size(c);
+
+    if (c->w != MATRIX_W || c->h != MATRIX_H) return false;
+    if (frames == 0 || pal_n == 0 || pal_n > 256u || rd16(c->fps_x10) == 0) return false;
+    if (size > total - ofs) return false;
+
+    const uint32_t data0 = CLIP_HDR_BYTES + (uint32_t)pal_n * 3u + (uint32_t)frames * 4u;
+    if (data0 > size) return false;
+
+    // таблица кадров: по возрастанию, внутри клипа, каждый кадр — хотя бы байт типа
+    uint32_t prev = data0;
+    for (uint16_t f = 0; f < frames; f++) {
+        const uint32_t o = frame_ofs(c, f);
+        if (o < prev || o >= size) return false;
+        if (f > 0 && o == prev) return false;
+        prev = o;
+    }
+    return clip_base(c)[frame_ofs(c, 0)] == CLIP_FRAME_KEY;
+}
+
+esp_err_t fx_clip_attach(const void *pack, size_t size)
+{
+    s_pack = NULL;
+    s_pack_size = 0;
+    s_count = 0;
+
+    if (!pack || size < CPK_HDR_BYTES) return ESP_ERR_INVALID_ARG;
+
+    const uint8_t *p = (const uint8_t *)pack;
+    if (rd32(p) != CPK_MAGIC || rd16(p + 4) != CPK_VERSION) return ESP_ERR_INVALID_VERSION;
+
+    const uint16_t count = rd16(p + 6);
+    const uint32_t total = rd32(p + 8);
+    if (total > size || CPK_HDR_BYTES + (uint32_t)count * CPK_ENTRY_BYTES > total) return ESP_ERR_INVALID_SIZE;
+
+    for (uint16_t i = 0; i < count; i++) {
+        const uint32_t ofs = rd32(p + CPK_HDR_BYTES + (uint32_t)i * CPK_ENTRY_BYTES + FX_CLIP_NAME_LEN);
+        if (!clip_valid(p, total, ofs)) return ESP_ERR_INVALID_SIZE;
+    }
+
+    s_pack = p;
+    s_pack_size = total;
+    s_count = count;
+    return ESP_OK;
+}
+
+esp_err_t fx_clip_init(void)
+{
+    if (s_mmapped) {
+        esp_partition_munmap(s_mmap_handle);
+        s_mmapped = false;
+    }
+    (void)fx_clip_attach(NULL, 0);
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ESP_PARTITION_SUBTYPE_ANY,
+                                                           FX_CLIP_PART_LABEL);
+    if (!part) {
+        ESP_LOGW(TAG, "partition '%s' not found", FX_CLIP_PART_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void *ptr = NULL;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &s_mmap_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "mmap '%s' failed: %s", FX_CLIP_PART_LABEL, esp_err_to_name(err));
+        return err;
+    }
+    s_mmapped = true;
+
+    err = fx_clip_attach(ptr, part->size);
+    if (err != ESP_OK) {
+        // пустой раздел — не ошибка прошивки: эффект CLIP просто скрыт
+        ESP_LOGW(TAG, "no clip pack in '%s': %s", FX_CLIP_PART_LABEL, esp_err_to_name(err));
+        esp_partition_munmap(s_mmap_handle);
+        s_mmapped = false;
+        return err;
+    }
+
+    ESP_LOGI(TAG, "clip pack: %u clips, %u bytes", (unsigned)s_count, (unsigned)s_pack_size);
+    return ESP_OK;
+}
+
+uint16_t fx_clip_count(void)
+{
+    return s_count;
+}
+
+const fx_clip_t *fx_clip_at(uint16_t idx)
+{
+    if (!s_pack || idx >= s_count) return NULL;
+    const uint32_t ofs = rd32(s_pack + CPK_HDR_BYTES + (uint32_t)idx * CPK_ENTRY_BYTES + FX_CLIP_NAME_LEN);
+    return (const fx_clip_t *)(s_pack + ofs);
+}
+
+const fx_clip_t *fx_clip_find(const char *name)
+{
+    if (!s_pack || !name) return NULL;
+    for (uint16_t i = 0; i < s_count; i++) {
+        const char *n = (const char *)(s_pack + CPK_HDR_BYTES + (uint32_t)i * CPK_ENTRY_BYTES);
+        if (strncmp(n, name, FX_CLIP_NAME_LEN) == 0) return fx_clip_at(i);
+    }
+    return NULL;
+}
+
+uint16_t fx_clip_frames(const fx_clip_t *c)  { return c ? rd16(c->frames) : 0; }
+uint16_t fx_clip_fps_x10(const fx_clip_t *c) { return c ? rd16(c->fps_x10) : 0; }
+
+uint16_t fx_clip_frame_at(const fx_clip_t *c, uint32_t anim_ms)
+{
+    const uint16_t frames = fx_clip_frames(c);
+    if (frames == 0) return 0;
+    const uint64_t f = ((uint64_t)anim_ms * fx_clip_fps_x10(c)) / 10000u;
+    return (uint16_t)(f % frames);
+}
+
+/* ============================================================
+ * Декод
+ * ============================================================ */
+
+static void decode_key(uint8_t *idx, const uint8_t *p, const uint8_t *end)
+{
+    uint32_t i = 0;
+    while (i < CLIP_PIXELS && p < end) {
+        const uint8_t c = *p++;
+        uint32_t n = (uint32_t)(c & 0x7Fu) + 1u;
+        if (n > CLIP_PIXELS - i) n = CLIP_PIXELS - i;
+
+        if (c & 0x80u) {
+            if (p >= end) break;
+            memset(&idx[i], *p++, n);
+        } else {
+            const uint32_t lit = (uint32_t)(c & 0x7Fu) + 1u;
+            if (n > (uint32_t)(end - p)) n = (uint32_t)(end - p);
+            memcpy(&idx[i], p, n);
+            p += (lit < (uint32_t)(end - p)) ? lit : (uint32_t)(end - p);
+        }
+        i += n;
+    }
+}
+
+static void decode_delta(uint8_t *idx, const uint8_t *p, const uint8_t *end)
+{
+    uint32_t i = 0;
+    while (i < CLIP_PIXELS && p < end) {
+        const uint8_t c = *p++;
+
+        if (c < 0x80u) {                         // пропуск
+            i += (uint32_t)c + 1u;
+            continue;
+        }
+
+        uint32_t n = (uint32_t)(c & 0x3Fu) + 1u;
+        if (n > CLIP_PIXELS - i) n = CLIP_PIXELS - i;
+
+        if (c < 0xC0u) {                         // повтор
+            if (p >= end) break;
+            memset(&idx[i], *p++, n);
+        } else {                                 // литерал
+            const uint32_t lit = (uint32_t)(c & 0x3Fu) + 1u;
+            if (n > (uint32_t)(end - p)) n = (uint32_t)(end - p);
+            memcpy(&idx[i], p, n);
+            p += (lit < (uint32_t)(end - p)) ? lit : (uint32_t)(end - p);
+        }
+        i += n;
+    }
+}
+
+static void apply_frame(fx_clip_player_t *pl, uint16_t f)
+{
+    const fx_clip_t *c = pl->clip;
+    const uint8_t *base = clip_base(c);
+    const uint8_t *p    = base + frame_ofs(c, f);
+    const uint8_t *end  = base + frame_end(c, f);
+
+    const uint8_t type = *p++;
+    if (type == CLIP_FRAME_KEY) decode_key(pl->idx, p, end);
+    else                        decode_delta(pl->idx, p, end);
+}
+
+static inline bool is_key(const fx_clip_t *c, uint16_t f)
+{
+    return clip_base(c)[frame_ofs(c, f)] == CLIP_FRAME_KEY;
+}
+
+/* индексы (верхняя строка первой) -> RGB в порядке строк canvas (y=0 — низ) */
+static void expand_rgb(fx_clip_player_t *pl)
+{
+    for (uint32_t sy = 0; sy < MATRIX_H; sy++) {
+        const uint8_t *src = &pl->idx[sy * MATRIX_W];
+        uint8_t *dst = &pl->rgb[(MATRIX_H - 1u - sy) * MATRIX_W * 3u];
+        for (uint32_t x = 0; x < MATRIX_W; x++) {
+            const uint8_t *c = pl->pal[src[x]];
+            dst[0] = c[0];
+            dst[1] = c[1];
+            dst[2] = c[2];
+            dst += 3;
+        }
+    }
+}
+
+void fx_clip_player_open(fx_clip_player_t *p, const fx_clip_t *c)
+{
+    if (!p) return;
+    memset(p, 0, sizeof(*p));
+    p->cur  = -1;
+    p->clip = c;
+    if (!c) return;
+
+    // индексы за палитрой остаются чёрными
+    const uint16_t n = clip_pal_n(c);
+    memcpy(p->pal, c->body, (size_t)n * 3u);
+}
+
+bool fx_clip_player_seek(fx_clip_player_t *p, uint16_t frame)
+{
+    if (!p || !p->clip) return false;
+
+    const uint16_t frames = rd16(p->clip->frames);
+    frame = (uint16_t)(frame % frames);
+    if ((int32_t)frame == p->cur) {
+        p->decode_us = 0;
+        return false;
+    }
+
+    const int64_t t0 = esp_timer_get_time();
+
+    // ближайший key <= frame
+    uint16_t k = frame;
+    while (k > 0 && !is_key(p->clip, k)) k--;
+
+    // вперёд от текущего дешевле, если он не раньше этого key
+    uint16_t f = (p->cur >= (int32_t)k && p->cur < (int32_t)frame) ? (uint16_t)(p->cur + 1) : k;
+    for (; f <= frame; f++) apply_frame(p, f);
+
+    expand_rgb(p);
+    p->cur = frame;
+    p->decode_us = (uint32_t)(esp_timer_get_time() - t0);
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "matrix_ws2812.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ * fx_clip.h
+ *
+ * Зачем:
+ *   - Заранее отрендеренные анимации (ручная анимация, офлайн-симуляция жидкости):
+ *     то, что дорого считать на лампе, считается на ПК и проигрывается почти бесплатно.
+ *
+ * Хранение:
+ *   - Пакет клипов лежит в data-разделе "anim" (partitions_voice.csv), собирается
+ *     tools/fx_clip_encode.py (PNG/GIF -> клип), шьётся отдельно от прошивки.
+ *   - fx_clip_init() делает esp_partition_mmap() один раз: кадры читаются прямо из flash.
+ *
+ * Формат (little-endian):
+ *   pack:  "JCPK" u32 magic, u16 version, u16 count, u32 total_size,
+ *          count * { char name[12], u32 offset }
+ *   clip:  u8 w, u8 h, u16 frames, u16 fps_x10, u16 pal_n (1..256), u16 key_every, u16 rsv, u32 size,
+ *          pal_n * { r, g, b },
+ *          frames * u32 frame_ofs,                        // от начала клипа
+ *          кадры: u8 type (0 = key, 1 = delta) + поток токенов по w*h индексам,
+ *                 пиксели row-major, верхняя строка картинки первой.
+ *   key:   c & 0x80 -> повтор (c & 0x7F) + 1 раз следующего индекса, иначе (c + 1) литералов.
+ *   delta: 0x00..0x7F — пропуск (c + 1) пикселей (как в прошлом кадре),
+ *          0x80..0xBF — повтор (c & 0x3F) + 1 раз следующего индекса,
+ *          0xC0..0xFF — (c & 0x3F) + 1 литеральных индексов.
+ *   Кадр 0 — всегда key. key_every — шаг keyframe'ов (перемотка назад/цикл без декода с начала).
+ *
+ * Плеер:
+ *   - fx_clip_player_seek(): декод только при смене кадра (вперёд — дельтами от текущего,
+ *     иначе от ближайшего key), результат — готовый RGB кадр в порядке строк canvas.
+ * ============================================================ */
+
+#ifndef FX_CLIP_PART_LABEL
+#define FX_CLIP_PART_LABEL      "anim"
+#endif
+
+#define FX_CLIP_NAME_LEN        12
+
+typedef struct fx_clip_s fx_clip_t;   // непрозрачный: данные в flash (mmap)
+
+typedef struct {
+    const fx_clip_t *clip;
+    int32_t  cur;                                 // декодированный кадр, -1 = нет
+    uint8_t  idx[MATRIX_H * MATRIX_W];            // индексы текущего кадра (порядок клипа)
+    uint8_t  rgb[MATRIX_H * MATRIX_W * 3];        // RGB для fx_canvas_load (y=0 — низ)
+    uint8_t  pal[256][3];
+    uint32_t decode_us;                           // последний декод (0, если кадр не менялся)
+} fx_clip_player_t;
+
+/* mmap раздела FX_CLIP_PART_LABEL + проверка пакета (ESP_ERR_NOT_FOUND — раздела нет). */
+esp_err_t fx_clip_init(void);
+
+/* Подключить пакет из памяти (rodata/тест на хосте). Блоб должен жить, пока используется. */
+esp_err_t fx_clip_attach(const void *pack, size_t size);
+
+uint16_t         fx_clip_count(void);
+const fx_clip_t *fx_clip_at(uint16_t idx);
+const fx_clip_t *fx_clip_find(const char *name);
+
+uint16_t fx_clip_frames(const fx_clip_t *c);
+uint16_t fx_clip_fps_x10(const fx_clip_t *c);
+
+/* Кадр по времени анимации (anim_ms уже масштабирован speed), по кругу */
+uint16_t fx_clip_frame_at(const fx_clip_t *c, uint32_t anim_ms);
+
+void fx_clip_player_open(fx_clip_player_t *p, const fx_clip_t *c);
+
+/* Довести плеер до кадра frame. true — кадр сменился (p->rgb обновлён). */
+bool fx_clip_player_seek(fx_clip_player_t *p, uint16_t frame);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,39 @@
+// main/fx_effects_clip.c
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fx_engine.h"
+#include "fx_canvas.h"
+#include "fx_clip.h"
+
+/* ============================================================
+ * fx_effects_clip.c
+ *
+ * 0xCA04 CLIP — проигрывание готового клипа из раздела "anim" (fx_clip).
+ *   - Кадр — по ctx->anim_ms и fps клипа (speed/pause работают как у всех эффектов).
+ *   - Декод только при смене кадра; в остальных кадрах — только fx_canvas_load() готового RGB.
+ *   - Играет первый клип пакета. Без пакета эффект скрыт в registry (fx_clip_count() == 0).
+ * ============================================================ */
+
+static fx_clip_player_t s_clip;
+static bool s_clip_open = false;
+
+void fx_clip_render(fx_ctx_t *ctx)
+{
+    if (!ctx) return;
+
+    const fx_clip_t *c = fx_clip_at(0);
+    if (!c) {
+        s_clip_open = false;
+        fx_canvas_clear(0, 0, 0);
+        return;
+    }
+
+    if (!s_clip_open || s_clip.clip != c) {
+        fx_clip_player_open(&s_clip, c);
+        s_clip_open = true;
+    }
+
+    (void)fx_clip_player_seek(&s_clip, fx_clip_frame_at(c, ctx->anim_ms));
+    fx_canvas_load(s_clip.rgb);
+}
@@ -16,12 +16,12 @@ bool j_doa_debug_log_enabled(void) { return (J_DOA_DEBUG_LOG_ENABLE != 0); }
 
 
 #include <string.h>
-#include <math.h>
 
 #include "esp_log.h"
 
 #include "fx_engine.h"
 #include "fx_canvas.h"
+#include "fx_math.h"
 #include "matrix_ws2812.h"
 
 #include "asr_debug.h"
@@ -36,15 +36,15 @@ static const char *TAG = "FX_DOA_DEBUG";
 #define DOA_H   48u
 
 // Угол -> X
-#define DOA_OFFSET_DEG       0.0f     // можно потом вынести в cfg
+#define DOA_OFFSET_DEG       0        // целые градусы, можно потом вынести в cfg
 #define DOA_INVERT           0        // 0=по часовой, 1=инвертировать
 
-// Сила голоса (0..1) -> Y
-// Ниже этого порога пиксель не рисуем вообще
-#define DOA_LEVEL_MIN        0.05f
+// Сила голоса (0..1, Q15) -> Y
+// Ниже этого порога пиксель не рисуем вообще (0.05)
+#define DOA_LEVEL_MIN_Q15    1638
 
-// На этом уровне (и выше) пиксель уходит в верхнюю границу диапазона Y
-#define DOA_LEVEL_FULL       0.70f
+// На этом уровне (и выше) пиксель уходит в верхнюю границу диапазона Y (0.70)
+#define DOA_LEVEL_FULL_Q15   22938
 
 // Диапазон Y, который используем под индикацию (0..DOA_H-1).
 // Можно сузить диапазон, если хочешь “не по всему экрану”.
@@ -57,59 +57,46 @@ static const char *TAG = "FX_DOA_DEBUG";
 
 /* ------------------------------ Helpers ------------------------------ */
 
-static float clampf(float v, float lo, float hi)
-{
-    if (v < lo) return lo;
-    if (v > hi) return hi;
-    return v;
-}
+/* Вся математика — целочисленная (fx_math.h): float только на входе (азимут из doa_probe). */
 
-static float fade_from_age_ms(uint32_t age_ms)
+// Q15: 1.0 до START, линейно до 0 к END
+static int32_t fade_from_age_ms_q15(uint32_t age_ms)
 {
-    if (age_ms <= DOA_FADE_START_MS) return 1.0f;
-    if (age_ms >= DOA_FADE_END_MS)   return 0.0f;
+    if (age_ms <= DOA_FADE_START_MS) return FX_Q15_ONE;
+    if (age_ms >= DOA_FADE_END_MS)   return 0;
 
-    const float span = (float)(DOA_FADE_END_MS - DOA_FADE_START_MS);
-    const float x    = (float)(age_ms - DOA_FADE_START_MS) / span;
-    return 1.0f - clampf(x, 0.0f, 1.0f);
+    const int32_t span = (int32_t)(DOA_FADE_END_MS - DOA_FADE_START_MS);
+    const int32_t x    = ((int32_t)(age_ms - DOA_FADE_START_MS) * FX_Q15_ONE) / span;
+    return FX_Q15_ONE - fx_clamp_i32(x, 0, FX_Q15_ONE);
 }
 
 static uint8_t map_deg_to_x(float deg)
 {
-    // deg expected [0..360)
-    deg += DOA_OFFSET_DEG;
-
-    // wrap
-    while (deg >= 360.0f) deg -= 360.0f;
-    while (deg <  0.0f)   deg += 360.0f;
+    // deg expected [0..360) -> binary angle (wrap бесплатно, 65536 = 360°)
+    uint16_t a = (uint16_t)(int32_t)(deg * (65536.0f / 360.0f));
+    a = (uint16_t)(a + (uint16_t)((DOA_OFFSET_DEG * 65536) / 360));
 
     if (DOA_INVERT) {
-        deg = 360.0f - deg;
-        if (deg >= 360.0f) deg -= 360.0f;
+        a = (uint16_t)(0u - a);
     }
 
-    // 0..360 -> 0..15
-    // Важно: 360 не должен давать 16
-    const float x_f = (deg / 360.0f) * (float)DOA_W;
-    int x = (int)floorf(x_f);
-
-    if (x < 0) x = 0;
-    if (x >= (int)DOA_W) x = (int)DOA_W - 1;
-    return (uint8_t)x;
+    // 0..360 -> 0..15 (floor); 360 не может дать 16: угол < 65536
+    return (uint8_t)(((uint32_t)a * DOA_W) >> 16);
 }
 
-static bool map_level_to_y(float level01, uint8_t *out_y, float *out_norm01)
+static bool map_level_to_y(int32_t level_q15, uint8_t *out_y, int32_t *out_norm_q15)
 {
-    if (level01 < DOA_LEVEL_MIN) return false;
+    if (level_q15 < DOA_LEVEL_MIN_Q15) return false;
 
-    const float norm = (level01 - DOA_LEVEL_MIN) / (DOA_LEVEL_FULL - DOA_LEVEL_MIN);
-    const float n01  = clampf(norm, 0.0f, 1.0f);
+    const int32_t norm = ((level_q15 - DOA_LEVEL_MIN_Q15) * FX_Q15_ONE)
+                       / (DOA_LEVEL_FULL_Q15 - DOA_LEVEL_MIN_Q15);
+    const int32_t n    = fx_clamp_i32(norm, 0, FX_Q15_ONE);
 
-    const uint32_t y_span = (uint32_t)(DOA_Y_MAX - DOA_Y_MIN);
-    const uint32_t y      = DOA_Y_MAX - (uint32_t)lroundf(n01 * (float)y_span);
+    const int32_t y_span = (int32_t)(DOA_Y_MAX - DOA_Y_MIN);
+    const int32_t y      = (int32_t)DOA_Y_MAX - (n * y_span + FX_Q15_ONE / 2) / FX_Q15_ONE;
 
-    if (out_y)      *out_y      = (uint8_t)y;
-    if (out_norm01) *out_norm01 = n01;
+    if (out_y)        *out_y        = (uint8_t)y;
+    if (out_norm_q15) *out_norm_q15 = n;
     return true;
 }
 
@@ -120,39 +107,37 @@ void fx_doa_debug_render(fx_ctx_t *fx, uint32_t t_ms)
     (void)fx;
     (void)t_ms;
 
-    // Clear frame (движок canvas не использует, поэтому чистим матрицу напрямую)
-    for (uint8_t yy = 0; yy < DOA_H; yy++) {
-        for (uint8_t xx = 0; xx < DOA_W; xx++) {
-            matrix_ws2812_set_pixel_xy((uint16_t)xx, (uint16_t)yy, 0, 0, 0);
-        }
-    }
+    // Clear frame
+    fx_canvas_clear(0, 0, 0);
 
     // DOA angle snapshot
     doa_snapshot_t s;
     const bool have = doa_probe_get_snapshot(&s);
     if (!have) return;
 
-    // Voice level (0..1)
-    const float level01 = clampf(asr_debug_get_level(), 0.0f, 1.0f);
+    // Voice level (0..1, Q15)
+    const int32_t level_q15 = fx_clamp_i32((int32_t)asr_debug_get_level() * FX_Q15_ONE, 0, FX_Q15_ONE);
 
     uint8_t y = 0;
-    float level_norm01 = 0.0f;
-    if (!map_level_to_y(level01, &y, &level_norm01)) {
+    int32_t level_norm_q15 = 0;
+    if (!map_level_to_y(level_q15, &y, &level_norm_q15)) {
         return;
     }
 
     const uint8_t x = map_deg_to_x(s.azimuth_deg);
 
-    const float fade_age = fade_from_age_ms(s.age_ms);
-    const float bri      = clampf(0.25f + 0.75f * level_norm01, 0.0f, 1.0f) * fade_age;
+    // bri = (0.25 + 0.75 * norm) * fade, Q15
+    const int32_t fade_age = fade_from_age_ms_q15(s.age_ms);
+    const int32_t bri      = fx_mul_q15(fx_clamp_i32(8192 + fx_mul_q15(24575, level_norm_q15), 0, FX_Q15_ONE),
+                                        fade_age);
 
-    const uint8_t v = (uint8_t)lroundf(255.0f * clampf(bri, 0.0f, 1.0f));
+    const uint8_t v = (uint8_t)((fx_clamp_i32(bri, 0, FX_Q15_ONE) * 255 + FX_Q15_ONE / 2) / FX_Q15_ONE);
 
     const uint8_t r = (uint8_t)(v / 12u);
     const uint8_t g = v;
     const uint8_t b = v;
 
-    matrix_ws2812_set_pixel_xy((uint16_t)x, (uint16_t)y, r, g, b);
+    fx_canvas_set((uint16_t)x, (uint16_t)y, r, g, b);
 
     (void)TAG;
 }
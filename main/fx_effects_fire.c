@@ -5,9 +5,11 @@
 // main/fx_effects_fire.c
 #include "fx_engine.h"
 #include "fx_canvas.h"
+#include "fx_particles.h"
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>     // memcpy
 
 #include "esp_random.h" // esp_random()
 
@@ -52,6 +54,10 @@
 #define FIRE_SIM_SPEED_PCT          100u  // 100=как сейчас. 120=быстрее, 80=медленнее (меняет step_ms).
 #endif
 #define FIRE_DT_CAP_MS              120u// cap провалов dt (лаг/пауза). Обычно не трогать
+#define FIRE_MAX_CATCHUP_STEPS      3u  // потолок шагов сима за кадр (fx_fixed_step). Обычно не трогать
+#ifndef FIRE_INTERP_ENABLE
+#define FIRE_INTERP_ENABLE          1   // 1 = render смешивает прошлый и текущий шаг поля (плавно при любом FPS)
+#endif
 
 
 /* --- A2) SAFETY / BRIGHTNESS CLAMPS ---
@@ -253,7 +259,10 @@
 
 /* Искры - отдельные частицы у низа (точки/микро-кометы). */
 #define FIRE_SPARKS_ENABLE          1   // 1=вкл, 0=выкл
-#define FIRE_SPARKS_MAX             12  // ↑ больше одновременно, ↓ меньше. Шаг: 2..4
+#define FIRE_SPARKS_MAX             12  // ёмкость пула fx_psys, как в baseline. При BURST 1 раз в 2.5..8 s
+                                        // живых 0..2: ёмкость больше ничего не даёт. Шаг: 4..8
+                                        // x5..10 из user-020 вынесено: см. docs/AnimationInfo.md (fx_particles)
+#define FIRE_SPARK_BURST            1   // ↑ искр за одно событие, ↓ меньше. Шаг: 1..2
 
 #define FIRE_SPARK_MIN_MS           2500u // ↑ реже, ↓ чаще. Шаг: 500..1000 ms
 #define FIRE_SPARK_MAX_MS           8000u // ↑ реже (длиннее пауза), ↓ чаще. Шаг: 500..1500 ms
@@ -307,11 +316,34 @@
 #define FIRE_TIP_COLOR_HIGH_B       0
 
 
+/* ==================== COST TIERS (runtime LOD) ====================
+ * ctx->tier (fx_engine понижает его при повторных промахах бюджета кадра).
+ * Значение = минимальный tier, при котором стадия работает (FX_TIER_LOW = всегда).
+ * Compile-time *_ENABLE выше по-прежнему выключают стадию целиком.
+ *  HIGH: всё;  MID: без islands и tip drive;  LOW: только тело огня (+ кромка без профиля).
+ */
+#define FIRE_TIER_ISLANDS           FX_TIER_HIGH
+#define FIRE_TIER_TIP_DRIVE         FX_TIER_HIGH
+#define FIRE_TIER_JETS              FX_TIER_MID
+#define FIRE_TIER_PETALS            FX_TIER_MID
+#define FIRE_TIER_SPARKS            FX_TIER_MID
+#define FIRE_TIER_TIP_PROFILE       FX_TIER_MID  // LOW = аварийный режим: кромка без профиля
+
+
+
 
 
 
 
 
+/* -------------------- Cost tier -------------------- */
+static uint8_t s_tier = FX_TIER_HIGH;   /* tier текущего кадра (из ctx) */
+
+static inline bool fire_stage_on(uint8_t min_tier)
+{
+    return s_tier >= min_tier;
+}
+
 
 /* -------------------- Helpers -------------------- */
 static inline uint8_t u8_clamp_i32(int v)
@@ -528,19 +560,13 @@ typedef struct {
 
 } petal_t;
 
-typedef struct {
-    bool    alive;
-    int16_t x_q8;
-    int16_t y_q8;
-    int16_t vx_q8;
-    int16_t vy_q8;
-    uint8_t r, g, b;
-    uint8_t life;      // steps
-    uint8_t tail;      // 0 point, 1..2 tail length
-} spark_t;
 
 /* Field buffers */
 static uint8_t s_heat[FIRE_H][FIRE_W];
+#if FIRE_INTERP_ENABLE
+static uint8_t s_heat_prev[FIRE_H][FIRE_W];   // поле до последнего шага сима
+static uint8_t s_heat_alpha_q8 = 255;         // доля пути prev -> heat (fx_fixed_step)
+#endif
 static uint8_t s_tmp [FIRE_H][FIRE_W];
 
 /* Persistent column "fuel personality" to avoid ring look */
@@ -562,7 +588,7 @@ static int16_t s_jet_life = 0;
 
 /* Petals + sparks */
 static petal_t s_pet[FIRE_PETALS_MAX];
-static spark_t s_spk[FIRE_SPARKS_MAX];
+FX_PSYS_DEFINE(s_spk, FIRE_SPARKS_MAX);   // искры: SoA-пул fx_particles
 static uint32_t s_next_spark_ms = 0;
 
 #if FIRE_ISLANDS_ENABLE && FIRE_ISLANDS_WHITE_ENABLE
@@ -629,10 +655,18 @@ static uint16_t s_tip_drive_timer_ms[FIRE_W]; /* retarget timers */
 /* Timing / init */
 static bool     s_inited = false;
 static uint32_t s_last_ms = 0;
-static uint32_t s_accum_ms = 0;
+static fx_fixed_step_t s_step;
 static uint32_t s_ignite_ms = 0;
 static uint32_t s_last_seen_frame = 0;
 
+/* step size (compile-time): smaller ms per step => more steps */
+static uint32_t fire_step_ms(void)
+{
+    uint32_t step_ms = (FIRE_BASE_STEP_MS * 100u + (FIRE_SIM_SPEED_PCT / 2u)) / FIRE_SIM_SPEED_PCT;
+    if (step_ms < 8u) step_ms = 8u;
+    return step_ms;
+}
+
 /* -------------------- Reset / init -------------------- */
 static void fire_reset(uint32_t t_ms)
 {
@@ -640,6 +674,9 @@ static void fire_reset(uint32_t t_ms)
         for (int x = 0; x < FIRE_W; x++) {
             s_heat[y][x] = 0;
             s_tmp[y][x]  = 0;
+#if FIRE_INTERP_ENABLE
+            s_heat_prev[y][x] = 0;
+#endif
         }
     }
 
@@ -666,12 +703,12 @@ static void fire_reset(uint32_t t_ms)
     s_jet_life = 0;
 
     for (int i = 0; i < FIRE_PETALS_MAX; i++) s_pet[i].alive = false;
-    for (int i = 0; i < FIRE_SPARKS_MAX; i++) s_spk[i].alive = false;
+    fx_psys_init(&s_spk, FIRE_W, FIRE_H, true, FIRE_SPARK_LIFE_MAX, 80);
 
     s_next_spark_ms = t_ms + FIRE_SPARK_MIN_MS + (rnd_u32() % (FIRE_SPARK_MAX_MS - FIRE_SPARK_MIN_MS + 1u));
 
     s_last_ms = t_ms;
-    s_accum_ms = 0;
+    fx_fixed_step_init(&s_step, fire_step_ms(), FIRE_MAX_CATCHUP_STEPS);
     s_ignite_ms = 0;
     #if FIRE_TIP_PROFILE_ENABLE
     s_tip_init = false;
@@ -743,6 +780,11 @@ static void fire_tongues_update(uint32_t dt_ms)
 static void fire_jets_update(void)
 {
 #if FIRE_JETS_ENABLE
+    if (!fire_stage_on(FIRE_TIER_JETS)) {
+        s_jet_life = 0;   /* tier ниже: активная струя гаснет, boost/inject от неё тоже */
+        return;
+    }
+
     if (s_jet_life > 0) {
         s_jet_life--;
         return;
@@ -880,6 +922,8 @@ static inline uint8_t islands_env_u8(uint16_t age, uint16_t life)
 static void fire_islands(void)
 {
 #if FIRE_ISLANDS_ENABLE
+    if (!fire_stage_on(FIRE_TIER_ISLANDS)) return;
+
     /* 1) Спавн: сохраняем прежнюю схему rnd_u8(), чтобы не менять RNG-поток проекта.
      * Было: 1 вызов на проверку + 3 вызова на x/y/rad. Оставляем те же 4 вызова.
      */
@@ -1028,14 +1072,41 @@ static void fire_islands(void)
 
 
 /* -------------------- Field step (advection + diffusion + cooling) -------------------- */
-static void fire_step_field(uint8_t upflow, uint8_t diffuse, uint8_t cool_base, uint8_t cool_slope, int16_t wind_q8)
+/* Cooling noise: детерминированный хэш (step, x, y) вместо rnd_u8().
+ * Нужен для dual-core: полосы считаются параллельно, а результат обязан совпадать
+ * с последовательным (и не зависеть от порядка вызовов RNG). */
+static uint32_t s_step_seq = 0;
+
+static inline uint8_t fire_noise_bit(uint32_t step, int x, int y)
 {
+    uint32_t h = step * 0x9E3779B1u ^ (uint32_t)((y << 8) | x) * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 13;
+    return (uint8_t)(h & 1u);
+}
+
+typedef struct {
+    uint8_t  upflow;
+    uint8_t  diffuse;
+    uint8_t  cool_base;
+    uint8_t  cool_slope;
+    int16_t  wind_q8;
+    uint32_t step;
+} fire_step_args_t;
+
+/* Полоса строк поля: читает только s_heat, пишет только s_tmp[y] своих строк (parallel-safe).
+ * Band в координатах fx_engine_parallel_rows: i=0 соответствует y=1. */
+static void fire_step_band(void *arg, int i0, int i1)
+{
+    const fire_step_args_t *a = (const fire_step_args_t *)arg;
+
     /* For each cell y>=1, advect from y-1 with small wind shift.
      * Use Q8 wind: shift = (wind_q8 * y) / (something) for slightly more sway near top.
      */
-    for (int y = FIRE_H - 1; y >= 1; y--) {
+    for (int y = i0 + 1; y < i1 + 1; y++) {
         /* wind shift fraction */
-        int16_t wy_q8 = (int16_t)((wind_q8 * (int16_t)(y + 6)) / 20); // stronger with height
+        int16_t wy_q8 = (int16_t)((a->wind_q8 * (int16_t)(y + 6)) / 20); // stronger with height
         int x_shift = (int)(wy_q8 >> 8);
         uint8_t frac = (uint8_t)(wy_q8 & 0xFF);
 
@@ -1044,15 +1115,15 @@ static void fire_step_field(uint8_t upflow, uint8_t diffuse, uint8_t cool_base,
             int sx0 = wrap_x(x - x_shift);
             int sx1 = wrap_x(sx0 - ((wy_q8 >= 0) ? 1 : -1));
 
-            uint8_t a = s_heat[y - 1][sx0];
-            uint8_t b = s_heat[y - 1][sx1];
+            uint8_t pa = s_heat[y - 1][sx0];
+            uint8_t pb = s_heat[y - 1][sx1];
 
             /* interpolate horizontally */
-            uint8_t src = (uint8_t)(((uint16_t)a * (uint16_t)(255 - frac) + (uint16_t)b * (uint16_t)frac) / 255u);
+            uint8_t src = (uint8_t)(((uint16_t)pa * (uint16_t)(255 - frac) + (uint16_t)pb * (uint16_t)frac) / 255u);
 
             /* apply upflow (mix with existing heat for stability) */
             uint8_t cur = s_heat[y][x];
-            uint8_t adv = u8_lerp(cur, src, upflow);
+            uint8_t adv = u8_lerp(cur, src, a->upflow);
 
             /* diffusion (neighbor average) - inline fast path */
             const int xm1 = wrap_x(x - 1);
@@ -1067,17 +1138,32 @@ static void fire_step_field(uint8_t upflow, uint8_t diffuse, uint8_t cool_base,
             const uint8_t avg = (uint8_t)((uint16_t)(n0 + n1 + n2 + n3 + n4) / 5u);
 
 
-            uint8_t diff = u8_lerp(adv, avg, diffuse);
+            uint8_t diff = u8_lerp(adv, avg, a->diffuse);
 
             /* cooling by height */
-            int cool = (int)cool_base + ((int)cool_slope * y) / 8;
-            cool += (int)(rnd_u8() & 1); // tiny stochastic to avoid banding
+            int cool = (int)a->cool_base + ((int)a->cool_slope * y) / 8;
+            cool += (int)fire_noise_bit(a->step, x, y); // tiny stochastic to avoid banding
             int v = (int)diff - cool;
             if (v < 0) v = 0;
 
             s_tmp[y][x] = (uint8_t)v;
         }
     }
+}
+
+static void fire_step_field(uint8_t upflow, uint8_t diffuse, uint8_t cool_base, uint8_t cool_slope, int16_t wind_q8)
+{
+    const fire_step_args_t args = {
+        .upflow = upflow,
+        .diffuse = diffuse,
+        .cool_base = cool_base,
+        .cool_slope = cool_slope,
+        .wind_q8 = wind_q8,
+        .step = s_step_seq++,
+    };
+
+    /* rows 1..H-1: split across cores (fx_engine fork/join) */
+    fx_engine_parallel_rows(FIRE_H - 1, fire_step_band, (void *)&args);
 
     /* bottom row cooling (keep alive but not over-saturate) */
     for (int x = 0; x < FIRE_W; x++) {
@@ -1087,11 +1173,7 @@ static void fire_step_field(uint8_t upflow, uint8_t diffuse, uint8_t cool_base,
     }
 
     /* swap tmp -> heat */
-    for (int y = 0; y < FIRE_H; y++) {
-        for (int x = 0; x < FIRE_W; x++) {
-            s_heat[y][x] = s_tmp[y][x];
-        }
-    }
+    memcpy(s_heat, s_tmp, sizeof(s_heat));
 }
 
 /* -------------------- Tip height estimation (for ragged edge & petals) -------------------- */
@@ -1110,7 +1192,7 @@ static void fire_tip_profile_update_q8(int16_t tip_raw_q8[FIRE_W], uint32_t dt_m
 {
 #if FIRE_TIP_DRIVE_ENABLE
     /* drive: per-column target noise with smoothing (adds "activity") */
-    for (int x = 0; x < FIRE_W; x++) {
+    for (int x = 0; x < FIRE_W && fire_stage_on(FIRE_TIER_TIP_DRIVE); x++) {
         if (s_tip_drive_timer_ms[x] <= dt_ms) {
             /* retarget */
             uint16_t span = (uint16_t)(FIRE_TIP_DRIVE_MAX_MS - FIRE_TIP_DRIVE_MIN_MS + 1);
@@ -1196,6 +1278,7 @@ static void fire_tip_profile_update_q8(int16_t tip_raw_q8[FIRE_W], uint32_t dt_m
 static void petals_spawn_from_tip(int x, int tip_y, int16_t wind_q8)
 {
 #if FIRE_PETALS_ENABLE
+    if (!fire_stage_on(FIRE_TIER_PETALS)) return;
     if ((rnd_u8() % FIRE_PETAL_RATE) != 0) return;
 
     /* spawn slightly above tip, only if tip is in active range */
@@ -1238,8 +1321,12 @@ static void petals_spawn_from_tip(int x, int tip_y, int16_t wind_q8)
 static void petals_step_and_render(uint8_t bri, int16_t wind_q8)
 {
 #if FIRE_PETALS_ENABLE
+    if (!fire_stage_on(FIRE_TIER_PETALS)) {
+        for (int i = 0; i < FIRE_PETALS_MAX; i++) s_pet[i].alive = false;
+        return;
+    }
 
-    /* local helper: additive draw logical pixel */
+    /* local helper: additive draw logical pixel (HDR-накопитель, без readback и clamp) */
     #define ADD_LPX(_lx, _ly, _r, _g, _b, _k) do {                  \
         int __ly = (_ly);                                          \
         if (__ly < 0 || __ly >= FIRE_H) break;                     \
@@ -1249,12 +1336,7 @@ static void petals_step_and_render(uint8_t bri, int16_t wind_q8)
         uint8_t __ar = scale_u8((_r), (_k));                       \
         uint8_t __ag = scale_u8((_g), (_k));                       \
         uint8_t __ab = scale_u8((_b), (_k));                       \
-        uint8_t __cr, __cg, __cb;                                  \
-        (void)fx_canvas_get(__cx, __cy, &__cr, &__cg, &__cb);       \
-        __cr = u8_clamp_i32((int)__cr + (int)__ar);                \
-        __cg = u8_clamp_i32((int)__cg + (int)__ag);                \
-        __cb = u8_clamp_i32((int)__cb + (int)__ab);                \
-        fx_canvas_set(__cx, __cy, __cr, __cg, __cb);               \
+        fx_canvas_hdr_add(__cx, __cy, __ar, __ag, __ab);           \
     } while (0)
 
     /* small deterministic hash (no extra state needed) */
@@ -1393,43 +1475,41 @@ static void petals_step_and_render(uint8_t bri, int16_t wind_q8)
 static void sparks_spawn(uint32_t t_ms)
 {
 #if FIRE_SPARKS_ENABLE
+    if (!fire_stage_on(FIRE_TIER_SPARKS)) return;
     if (t_ms < s_next_spark_ms) return;
 
     s_next_spark_ms = t_ms + FIRE_SPARK_MIN_MS + (rnd_u32() % (FIRE_SPARK_MAX_MS - FIRE_SPARK_MIN_MS + 1u));
 
-    for (int i = 0; i < FIRE_SPARKS_MAX; i++) {
-        spark_t *s = &s_spk[i];
-        if (s->alive) continue;
+    for (int n = 0; n < FIRE_SPARK_BURST; n++) {
+        const int i = fx_psys_spawn(&s_spk);
+        if (i < 0) return;
 
-        s->alive = true;
         int x = (int)(rnd_u8() % FIRE_W);
-        s->x_q8 = (int16_t)(x * 256 + (int16_t)((int)(rnd_u8() & 0x7F) - 64));
-        s->y_q8 = (int16_t)((int)(rnd_u8() % 3) * 256);
+        s_spk.x_q8[i] = (int16_t)(x * 256 + (int16_t)((int)(rnd_u8() & 0x7F) - 64));
+        s_spk.y_q8[i] = (int16_t)((int)(rnd_u8() % 3) * 256);
 
         /* upward and a little sideways */
-        s->vy_q8 = (int16_t)(
+        s_spk.vy_q8[i] = (int16_t)(
             FIRE_SPARK_VY_MIN_Q8 +
             (int16_t)(rnd_u8() % (uint8_t)(FIRE_SPARK_VY_MAX_Q8 - FIRE_SPARK_VY_MIN_Q8 + 1))
         );
 
-        s->vx_q8 = (int16_t)((int)(rnd_u8() % 101) - 50);
+        s_spk.vx_q8[i] = (int16_t)((int)(rnd_u8() % 101) - 50);
 
         #if FIRE_DEBUG_COLOR_SPLIT
-        s->r = FIRE_DEBUG_SPARK_R;
-        s->g = FIRE_DEBUG_SPARK_G;
-        s->b = FIRE_DEBUG_SPARK_B;
+        s_spk.r[i] = FIRE_DEBUG_SPARK_R;
+        s_spk.g[i] = FIRE_DEBUG_SPARK_G;
+        s_spk.b[i] = FIRE_DEBUG_SPARK_B;
         #else
         /* choose color: blue/cyan/green */
         uint8_t sel = (uint8_t)(rnd_u8() % 3);
-        if (sel == 0) { s->r = 10; s->g = 40;  s->b = 220; } // blue
-        else if (sel == 1) { s->r = 10; s->g = 170; s->b = 200; } // cyan
-        else { s->r = 10; s->g = 220; s->b = 50; } // green
+        if (sel == 0) { s_spk.r[i] = 10; s_spk.g[i] = 40;  s_spk.b[i] = 220; } // blue
+        else if (sel == 1) { s_spk.r[i] = 10; s_spk.g[i] = 170; s_spk.b[i] = 200; } // cyan
+        else { s_spk.r[i] = 10; s_spk.g[i] = 220; s_spk.b[i] = 50; } // green
         #endif
 
-
-        s->life = (uint8_t)(FIRE_SPARK_LIFE_MIN + (rnd_u8() % (FIRE_SPARK_LIFE_MAX - FIRE_SPARK_LIFE_MIN + 1)));
-        s->tail = (uint8_t)(rnd_u8() & 1 ? 0 : (uint8_t)(1 + (rnd_u8() & 1))); // point or tiny comet (1..2)
-        return;
+        s_spk.life[i] = (uint8_t)(FIRE_SPARK_LIFE_MIN + (rnd_u8() % (FIRE_SPARK_LIFE_MAX - FIRE_SPARK_LIFE_MIN + 1)));
+        s_spk.tail[i] = (uint8_t)(rnd_u8() & 1 ? 0 : (uint8_t)(1 + (rnd_u8() & 1))); // point or tiny comet (1..2)
     }
 #else
     (void)t_ms;
@@ -1439,61 +1519,16 @@ static void sparks_spawn(uint32_t t_ms)
 static void sparks_step_and_render(uint8_t bri, int16_t wind_q8)
 {
 #if FIRE_SPARKS_ENABLE
-    for (int i = 0; i < FIRE_SPARKS_MAX; i++) {
-        spark_t *s = &s_spk[i];
-        if (!s->alive) continue;
-
-        if (s->life == 0) { s->alive = false; continue; }
-        s->life--;
-
-        /* wind influence */
-        s->vx_q8 = (int16_t)(s->vx_q8 + (wind_q8 / 60));
-
-        s->x_q8 = (int16_t)(s->x_q8 + s->vx_q8);
-        s->y_q8 = (int16_t)(s->y_q8 + s->vy_q8);
-
-        int x = wrap_x((int)(s->x_q8 >> 8));
-        int y = (int)(s->y_q8 >> 8);
-
-        if (y < 0 || y >= FIRE_H) { s->alive = false; continue; }
-
-        /* life fade: map remaining life -> 80..255 (never fully off mid-flight) */
-        uint8_t life_k = (uint8_t)(
-            80 + (uint16_t)s->life * 175u / (uint16_t)FIRE_SPARK_LIFE_MAX
-        );
+    if (!fire_stage_on(FIRE_TIER_SPARKS)) {
+        fx_psys_clear(&s_spk);
+        return;
+    }
 
-        /* render head + tail (additive) */
-        for (int t = 0; t <= (int)s->tail; t++) {
-            int yy = y - t;
-            if (yy < 0) break;
+    /* один тик на кадр: ветер как ускорение по x, движение/wrap/kill — в fx_psys */
+    fx_psys_integrate(&s_spk, (int16_t)(wind_q8 / 60), 0, 256u);
 
-            uint16_t cx, cy;
-            map_to_canvas(x, yy, &cx, &cy);
-
-            /* tail attenuation */
-            uint8_t tail_k = 255;
-            if (t == 1) tail_k = 140;
-            else if (t >= 2) tail_k = 90;
-
-            uint8_t k = scale_u8(life_k, tail_k);
-
-            uint8_t r = scale_u8(s->r, k);
-            uint8_t g = scale_u8(s->g, k);
-            uint8_t b = scale_u8(s->b, k);
-
-            /* apply global brightness (variant A uses bri passed in) */
-            r = scale_u8(r, bri);
-            g = scale_u8(g, bri);
-            b = scale_u8(b, bri);
-
-            uint8_t cr, cg, cb;
-            (void)fx_canvas_get(cx, cy, &cr, &cg, &cb);
-            cr = u8_clamp_i32((int)cr + r);
-            cg = u8_clamp_i32((int)cg + g);
-            cb = u8_clamp_i32((int)cb + b);
-            fx_canvas_set(cx, cy, cr, cg, cb);
-        }
-    }
+    /* head + tail, life fade 80..255; additive в HDR, tone-map один раз в fx_canvas_present() */
+    fx_psys_splat(&s_spk, map_to_canvas, bri, FX_PSYS_SPLAT_HDR_ADD);
 #else
     (void)bri; (void)wind_q8;
 #endif
@@ -1501,12 +1536,14 @@ static void sparks_step_and_render(uint8_t bri, int16_t wind_q8)
 
 
 /* -------------------- Render field -------------------- */
-static void fire_render_field(uint8_t bri)
+/* Полоса логических строк [ly0,ly1): каждый (lx,ly) пишет свой пиксель canvas,
+ * состояние только читается (parallel-safe). */
+static void fire_render_band(void *arg, int ly0, int ly1)
 {
-    fx_canvas_clear(0, 0, 0);
+    const uint8_t bri = *(const uint8_t *)arg;
 
     /* Render logical field to physical canvas with mapping */
-    for (int ly = 0; ly < FIRE_H; ly++) {
+    for (int ly = ly0; ly < ly1; ly++) {
         for (int lx = 0; lx < FIRE_W; lx++) {
 
             int ly_src = ly;
@@ -1531,7 +1568,14 @@ static void fire_render_field(uint8_t bri)
     #endif
 
 
+#if FIRE_INTERP_ENABLE
+            /* между шагами сима: lerp(prev, heat, alpha) — движение не "щёлкает" при FPS != 1/step */
+            const uint8_t h0 = s_heat_prev[ly_src][lx];
+            const uint8_t h1 = s_heat[ly_src][lx];
+            uint8_t h = (uint8_t)((int32_t)h0 + ((((int32_t)h1 - (int32_t)h0) * (int32_t)s_heat_alpha_q8) >> 8));
+#else
             uint8_t h = s_heat[ly_src][lx];
+#endif
             if (h == 0) continue;
 
             uint16_t cx = s_map_cx[ly][lx];
@@ -1666,6 +1710,14 @@ static void fire_render_field(uint8_t bri)
     }
 }
 
+static void fire_render_field(uint8_t bri)
+{
+    fx_canvas_clear(0, 0, 0);
+
+    /* per-pixel shading: split across cores (fx_engine fork/join) */
+    fx_engine_parallel_rows(FIRE_H, fire_render_band, &bri);
+}
+
 
 /* -------------------- Main effect -------------------- */
 void fx_fire_render(fx_ctx_t *ctx)
@@ -1691,6 +1743,9 @@ void fx_fire_render(fx_ctx_t *ctx)
     // paused = frozen anim time (render still runs)
     const bool paused = (ctx->anim_dt_ms == 0u);
 
+    // cost tier этого кадра (fx_engine): какие необязательные стадии считаем
+    s_tier = ctx->tier;
+
     /* brightness Variant A (+ floor for 0) */
     uint8_t bri = ctx->brightness;
     if (bri == 0) bri = FIRE_BRI_FLOOR0;
@@ -1711,8 +1766,9 @@ void fx_fire_render(fx_ctx_t *ctx)
 
 
     if (!paused) {
-        /* accumulate time and convert to simulation steps */
-        s_accum_ms += dt_ms;
+        /* anim-время -> фиксированные шаги сима (fx_fixed_step: остаток копится, потолок догоняния) */
+        const uint8_t steps = fx_fixed_step_advance(&s_step, dt_ms);
+        const uint32_t step_ms = s_step.step_ms;
 
         /* ignition ramp 0..255 */
         if (s_ignite_ms < FIRE_IGNITE_MS) {
@@ -1721,12 +1777,8 @@ void fx_fire_render(fx_ctx_t *ctx)
         }
         uint8_t ignite_k = (uint8_t)((s_ignite_ms * 255u) / FIRE_IGNITE_MS);
 
-        /* step size (compile-time): smaller ms per step => more steps */
-        uint32_t step_ms = (FIRE_BASE_STEP_MS * 100u + (FIRE_SIM_SPEED_PCT / 2u)) / FIRE_SIM_SPEED_PCT;
-        if (step_ms < 8u) step_ms = 8u;
-
         #if FIRE_ISLANDS_ENABLE && FIRE_ISLANDS_WHITE_ENABLE
-        if (s_accum_ms >= step_ms) {
+        if (steps > 0) {
             for (int y = 0; y < FIRE_H; y++) {
                 for (int x = 0; x < FIRE_W; x++) s_island_mark[y][x] = 0;
             }
@@ -1734,8 +1786,10 @@ void fx_fire_render(fx_ctx_t *ctx)
         #endif
 
 
-        while (s_accum_ms >= step_ms) {
-            s_accum_ms -= step_ms;
+        for (uint8_t st = 0; st < steps; st++) {
+#if FIRE_INTERP_ENABLE
+            memcpy(s_heat_prev, s_heat, sizeof(s_heat));
+#endif
 
             /* update controls */
             fire_wind_update(step_ms);
@@ -1758,13 +1812,18 @@ void fx_fire_render(fx_ctx_t *ctx)
 #endif
             fire_step_field(up, FIRE_DIFFUSE, FIRE_COOL_BASE, FIRE_COOL_Y_SLOPE, s_wind_q8);
 #if FIRE_TIP_PROFILE_ENABLE
-            int16_t tip_raw_q8[FIRE_W];
-            for (int x = 0; x < FIRE_W; x++) {
-                int tip = fire_tip_y_of_col(x);
-                if (tip > FIRE_JET_TOP_Y) tip = FIRE_JET_TOP_Y;
-                tip_raw_q8[x] = (int16_t)(tip << 8);
+            if (fire_stage_on(FIRE_TIER_TIP_PROFILE)) {
+                int16_t tip_raw_q8[FIRE_W];
+                for (int x = 0; x < FIRE_W; x++) {
+                    int tip = fire_tip_y_of_col(x);
+                    if (tip > FIRE_JET_TOP_Y) tip = FIRE_JET_TOP_Y;
+                    tip_raw_q8[x] = (int16_t)(tip << 8);
+                }
+                fire_tip_profile_update_q8(tip_raw_q8, dt_ms);
+            } else {
+                /* профиль выключен: render_field не применяет ramp, при возврате — ре-инициализация */
+                s_tip_init = false;
             }
-            fire_tip_profile_update_q8(tip_raw_q8, dt_ms);
 #endif
 
             /* hot islands */
@@ -1788,10 +1847,13 @@ void fx_fire_render(fx_ctx_t *ctx)
                 if (tipR > FIRE_JET_TOP_Y) tipR = FIRE_JET_TOP_Y;
 
 #if FIRE_TIP_PROFILE_ENABLE
-                /* apply tip-profile delta so petals match the visually amplified ragged edge */
-                tip  += (int)s_tip_delta_px[x];
-                tipL += (int)s_tip_delta_px[xL];
-                tipR += (int)s_tip_delta_px[xR];
+                /* apply tip-profile delta so petals match the visually amplified ragged edge
+                 * (профиль мог быть выключен tier'ом -> дельты не актуальны) */
+                if (s_tip_init) {
+                    tip  += (int)s_tip_delta_px[x];
+                    tipL += (int)s_tip_delta_px[xL];
+                    tipR += (int)s_tip_delta_px[xR];
+                }
 
                 if (tip < 0) {
                 tip = 0;
@@ -1829,12 +1891,12 @@ void fx_fire_render(fx_ctx_t *ctx)
     }
 
     /* render base field */
+#if FIRE_INTERP_ENABLE
+    s_heat_alpha_q8 = fx_fixed_step_alpha_q8(&s_step);
+#endif
     fire_render_field(bri);
 
-    /* overlays (wind-coupled) */
+    /* overlays (wind-coupled): HDR-накопитель, present — в matrix_anim */
     petals_step_and_render(bri, s_wind_q8);
     sparks_step_and_render(bri, s_wind_q8);
-
-    /* push to WS2812 buffer */
-    fx_canvas_present();
 }
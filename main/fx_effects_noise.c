@@ -0,0 +1,110 @@
+// main/fx_effects_noise.c
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fx_engine.h"
+#include "fx_canvas.h"
+#include "fx_noise.h"
+#include "fx_palette.h"
+
+/* ============================================================
+ * fx_effects_noise.c
+ *
+ * Органические эффекты на fx_noise (целочисленный fBm, кэш крупных октав):
+ *   - 0xCA02 PLASMA — row shader: кэш октав и палитра в shade_prep, строки на обоих ядрах;
+ *   - 0xCA03 LAVA   — render: prep + fx_noise_fill_band() полосами через fx_engine_parallel_rows.
+ *
+ * Время — только ctx->anim_ms (pause = заморозка z, кэш не пересчитывается).
+ * Сложность по tier: на LOW живых октав меньше (кэш тот же).
+ * ============================================================ */
+
+/* ---------------- PLASMA ---------------- */
+
+#define PLASMA_OCTAVES          3
+#define PLASMA_CACHED           1
+#define PLASMA_SCALE_Q8         40      // ~0.16 ячейки на пиксель: крупные пятна
+#define PLASMA_Z_PER_MS_Q8      1       // z (Q8) за 1 ms anim: одна ячейка за ~0.26 s
+#define PLASMA_KEY_DZ_Q8        512     // ключ кэша раз в ~0.5 s anim
+#define PLASMA_HUE_DIV_MS       40u     // дрейф палитры
+#define PLASMA_VALUE            220
+
+static fx_fbm_t        s_plasma;
+static bool            s_plasma_init = false;
+static const uint8_t  *s_plasma_pal;
+static uint32_t        s_plasma_z;
+static uint8_t         s_plasma_hue;
+
+void fx_plasma_prep(fx_ctx_t *ctx)
+{
+    if (!s_plasma_init) {
+        fx_fbm_init(&s_plasma, PLASMA_OCTAVES, PLASMA_CACHED, PLASMA_SCALE_Q8, PLASMA_KEY_DZ_Q8, 0);
+        s_plasma_init = true;
+    }
+
+    // LOW tier: без верхней октавы
+    fx_fbm_set_octaves(&s_plasma, (ctx->tier == FX_TIER_LOW) ? (PLASMA_OCTAVES - 1u) : PLASMA_OCTAVES);
+
+    s_plasma_z   = ctx->anim_ms * PLASMA_Z_PER_MS_Q8;
+    s_plasma_hue = (uint8_t)(ctx->anim_ms / PLASMA_HUE_DIV_MS);
+    s_plasma_pal = fx_palette_get(FX_PAL_RAINBOW, PLASMA_VALUE);
+
+    fx_fbm_prep(&s_plasma, s_plasma_z);
+}
+
+void fx_plasma_shade_row(const fx_ctx_t *ctx, uint16_t y, uint8_t *out_rgb)
+{
+    (void)ctx;
+    uint8_t n[MATRIX_W];
+    fx_fbm_row(&s_plasma, y, s_plasma_z, n);
+
+    const uint8_t *pal = s_plasma_pal;
+    for (uint16_t x = 0; x < MATRIX_W; x++, out_rgb += 3) {
+        // x2: шум собран к середине диапазона, растягиваем на весь круг палитры
+        fx_pal_rgb(pal, (uint8_t)(n[x] * 2u + s_plasma_hue), &out_rgb[0], &out_rgb[1], &out_rgb[2]);
+    }
+}
+
+/* ---------------- LAVA ---------------- */
+
+#define LAVA_OCTAVES            3
+#define LAVA_CACHED             2
+#define LAVA_SCALE_Q8           28      // крупные "капли"
+#define LAVA_Z_PER_MS_Q8        1
+#define LAVA_KEY_DZ_Q8          384
+#define LAVA_DRIFT_Q8           96      // подъём: ~0.4 px на ячейку z
+#define LAVA_VALUE              255
+
+static fx_fbm_t        s_lava;
+static bool            s_lava_init = false;
+
+typedef struct {
+    uint32_t       z;
+    const uint8_t *pal;
+} lava_band_args_t;
+
+static void lava_band(void *arg, int y0, int y1)
+{
+    const lava_band_args_t *a = (const lava_band_args_t *)arg;
+    fx_noise_fill_band(&s_lava, a->z, a->pal, 0, y0, y1);
+}
+
+void fx_lava_render(fx_ctx_t *ctx)
+{
+    if (!ctx) return;
+
+    if (!s_lava_init) {
+        fx_fbm_init(&s_lava, LAVA_OCTAVES, LAVA_CACHED, LAVA_SCALE_Q8, LAVA_KEY_DZ_Q8, LAVA_DRIFT_Q8);
+        s_lava_init = true;
+    }
+
+    // LOW tier: только кэшированные октавы
+    fx_fbm_set_octaves(&s_lava, (ctx->tier == FX_TIER_LOW) ? LAVA_CACHED : LAVA_OCTAVES);
+
+    lava_band_args_t a = {
+        .z   = ctx->anim_ms * LAVA_Z_PER_MS_Q8,
+        .pal = fx_palette_get(FX_PAL_LAVA, LAVA_VALUE),
+    };
+
+    fx_fbm_prep(&s_lava, a.z);
+    fx_engine_parallel_rows(MATRIX_H, lava_band, &a);
+}
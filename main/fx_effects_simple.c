@@ -1,10 +1,13 @@
 // main/fx_effects_simple.c
 #include <stdint.h>
 #include <stdbool.h>
-#include <math.h>
+#include <string.h>     // memcpy
 
 #include "fx_engine.h"
 #include "fx_canvas.h"
+#include "fx_math.h"
+#include "fx_palette.h"
+#include "fx_particles.h"
 #include "matrix_ws2812.h"
 #include "esp_random.h"
 
@@ -32,158 +35,211 @@ static inline uint32_t xorshift32_u32(uint32_t *s)
 
 static inline uint32_t xorshift32(uint32_t *state) { return xorshift32_u32(state); }
 
-static inline void hsv_to_rgb(uint8_t h, uint8_t s, uint8_t v, uint8_t *r, uint8_t *g, uint8_t *b)
-{
-    const uint8_t region = h / 43;
-    const uint8_t rem = (h - (region * 43)) * 6;
-
-    const uint8_t p = (uint8_t)((v * (255 - s)) >> 8);
-    const uint8_t q = (uint8_t)((v * (255 - ((s * rem) >> 8))) >> 8);
-    const uint8_t t = (uint8_t)((v * (255 - ((s * (255 - rem)) >> 8))) >> 8);
-
-    switch (region) {
-        default:
-        case 0: *r = v; *g = t; *b = p; break;
-        case 1: *r = q; *g = v; *b = p; break;
-        case 2: *r = p; *g = v; *b = t; break;
-        case 3: *r = p; *g = q; *b = v; break;
-        case 4: *r = t; *g = p; *b = v; break;
-        case 5: *r = v; *g = p; *b = q; break;
-    }
-}
-
-/* small local framebuffer for confetti */
+/* small local framebuffers for confetti: текущий и предыдущий шаг (fx_fixed_step) */
 static rgb8_t s_conf[MATRIX_LEDS_TOTAL];
+static rgb8_t s_conf_prev[MATRIX_LEDS_TOTAL];
 static uint8_t s_conf_init = 0;
 
 static inline void conf_fade(uint8_t keep)
 {
     for (uint16_t i = 0; i < MATRIX_LEDS_TOTAL; i++) {
-        s_conf[i].r = (uint8_t)((uint16_t)s_conf[i].r * keep / 255u);
-        s_conf[i].g = (uint8_t)((uint16_t)s_conf[i].g * keep / 255u);
-        s_conf[i].b = (uint8_t)((uint16_t)s_conf[i].b * keep / 255u);
+        s_conf[i].r = (uint8_t)fx_div255((uint32_t)s_conf[i].r * keep);
+        s_conf[i].g = (uint8_t)fx_div255((uint32_t)s_conf[i].g * keep);
+        s_conf[i].b = (uint8_t)fx_div255((uint32_t)s_conf[i].b * keep);
     }
 }
 
-static inline void conf_present(void)
+/* кадр между шагами: lerp(prev, cur, alpha) прямо в строки canvas */
+static inline void conf_present(uint8_t alpha_q8)
 {
     for (uint16_t y = 0; y < MATRIX_H; y++) {
+        uint8_t *row = fx_canvas_row(y);
+        if (!row) continue;
+
+        const rgb8_t *a = &s_conf_prev[y * MATRIX_W];
+        const rgb8_t *b = &s_conf[y * MATRIX_W];
         for (uint16_t x = 0; x < MATRIX_W; x++) {
-            const uint16_t i = (uint16_t)(y * MATRIX_W + x);
-            matrix_ws2812_set_pixel_xy(x, y, s_conf[i].r, s_conf[i].g, s_conf[i].b);
+            row[x * 3u + 0u] = fx_lerp8(a[x].r, b[x].r, alpha_q8);
+            row[x * 3u + 1u] = fx_lerp8(a[x].g, b[x].g, alpha_q8);
+            row[x * 3u + 2u] = fx_lerp8(a[x].b, b[x].b, alpha_q8);
         }
     }
 }
 
 static inline void fill_black(void)
 {
-    for (uint16_t y = 0; y < MATRIX_H; y++) {
-        for (uint16_t x = 0; x < MATRIX_W; x++) {
-            matrix_ws2812_set_pixel_xy(x, y, 0, 0, 0);
-        }
-    }
+    fx_canvas_clear(0, 0, 0);
 }
 
 /* ---------------- FX: SNOW FALL ---------------- */
 
+/* Снежинки — частицы fx_psys: падают со своей скоростью и лёгким сносом,
+ * след оставляет fx_canvas_dim() по базе (раньше — сдвиг всего кадра на строку за кадр). */
+#define SNOW_FLAKES_MAX     192     // ёмкость пула (на экране ~2..4 новых за кадр * ~48 кадров падения)
+#define SNOW_TICK_MS        45u     // шаг, в котором заданы скорости (≈ fps_pref 22)
+#define SNOW_VY_Q8          256     // базовая скорость: 1 строка за тик
+#define SNOW_VY_VAR_Q8      64      // + разброс 0..63
+#define SNOW_VX_VAR_Q8      24      // снос по x: -24..+23
+
+FX_PSYS_DEFINE(s_snow, SNOW_FLAKES_MAX);
+static uint8_t s_snow_init = 0;
+
 void fx_snow_fall_render(fx_ctx_t *ctx)
 {
     if (!ctx) return;
 
+    if (!s_snow_init) {
+        // fade_min=255: снежинка не гаснет в полёте, жизнь заканчивается у низа
+        fx_psys_init(&s_snow, MATRIX_W, MATRIX_H, true, 255, 255);
+        s_snow_init = 1;
+    }
+
     uint8_t dim = 243;
     const uint32_t dt = ctx->anim_dt_ms;
     if (dt >= 90u)  dim = 247;
     if (dt >= 140u) dim = 250;
 
     fx_canvas_dim(dim);
-    fx_canvas_shift_towards_y0(0, 0, 0);
+
+    const uint32_t dt_c = (dt > 200u) ? 200u : dt;
+    fx_psys_integrate(&s_snow, 0, 0, (uint16_t)(dt_c * 256u / SNOW_TICK_MS));
 
     uint8_t flakes = 2;
     if (ctx->anim_dt_ms >= 80u)  flakes = 3;
     if (ctx->anim_dt_ms >= 120u) flakes = 4;
 
-    for (uint8_t i = 0; i < flakes; i++) {
+    for (uint8_t n = 0; n < flakes; n++) {
+        const int i = fx_psys_spawn(&s_snow);
+        if (i < 0) break;
+
         const uint32_t r = esp_random();
-        const uint16_t x = (uint16_t)(r % MATRIX_W);
         const uint8_t  v = (uint8_t)(200 + (r & 0x37));
-        fx_canvas_set(x, (uint16_t)(MATRIX_H - 1), v, v, v);
+        s_snow.x_q8[i]  = (int16_t)((r % MATRIX_W) * 256u + 128u);
+        s_snow.y_q8[i]  = (int16_t)((MATRIX_H - 1) * 256);
+        s_snow.vx_q8[i] = (int16_t)((int)((r >> 8) % (2u * SNOW_VX_VAR_Q8)) - SNOW_VX_VAR_Q8);
+        s_snow.vy_q8[i] = (int16_t)(-(SNOW_VY_Q8 + (int)((r >> 16) % SNOW_VY_VAR_Q8)));
+        s_snow.r[i] = v; s_snow.g[i] = v; s_snow.b[i] = v;
+        s_snow.life[i] = 255;
+        s_snow.tail[i] = 0;
     }
 
-    fx_canvas_present();
+    fx_psys_splat(&s_snow, NULL, 255, FX_PSYS_SPLAT_BASE_MAX);
 }
 
 /* ---------------- FX: CONFETTI ---------------- */
 
+/* Фиксированный шаг (fx_fixed_step): затухание и вспышки идут в anim-времени,
+ * а не "за кадр" с порогами по dt; кадр — lerp между двумя последними шагами. */
+#define CONF_STEP_MS        22u     // ~45 шагов/с
+#define CONF_FADE           244u    // keep за шаг (~232 за прежний кадр 45 ms)
+#define CONF_POPS_PER_STEP  1u      // ~2 вспышки за 45 ms, как раньше
+#define CONF_MAX_STEPS      8u      // потолок догоняния (~176 ms)
+
+static fx_fixed_step_t s_conf_step;
+static uint32_t        s_conf_rng;
+
 void fx_confetti_render(fx_ctx_t *ctx)
 {
     if (!s_conf_init) {
-        for (uint16_t i = 0; i < MATRIX_LEDS_TOTAL; i++) s_conf[i] = (rgb8_t){0,0,0};
+        for (uint16_t i = 0; i < MATRIX_LEDS_TOTAL; i++) {
+            s_conf[i] = (rgb8_t){0,0,0};
+            s_conf_prev[i] = (rgb8_t){0,0,0};
+        }
+        fx_fixed_step_init(&s_conf_step, CONF_STEP_MS, CONF_MAX_STEPS);
+        s_conf_rng = 0xC0FF377u ^ esp_random();
+        if (s_conf_rng == 0) s_conf_rng = 0xC0FF377u;
         s_conf_init = 1;
     }
 
     if (!ctx) return;
 
-    const uint32_t dt = ctx->anim_dt_ms; // already speed-scaled by master clock
-
-    const uint8_t fade = (dt >= 120u) ? 210u : ((dt >= 80u) ? 220u : 232u);
-    conf_fade(fade);
+    const uint8_t steps = fx_fixed_step_advance(&s_conf_step, ctx->anim_dt_ms);
 
-    const uint32_t phase = (ctx->anim_ms / 20u);
-    uint32_t s = (uint32_t)(0xC0FF377u ^ (phase * 33u) ^ (ctx->wall_ms * 17u));
+    const uint8_t *pal = fx_palette_get(FX_PAL_RAINBOW, 220);
 
-    uint8_t pops = 1u + (uint8_t)(dt / 35u);
-    if (pops > 6u) pops = 6u;
+    for (uint8_t st = 0; st < steps; st++) {
+        memcpy(s_conf_prev, s_conf, sizeof(s_conf));
+        conf_fade(CONF_FADE);
 
-    for (uint8_t k = 0; k < pops; k++) {
-        const uint32_t r0 = xorshift32_u32(&s);
-        const uint16_t x = (uint16_t)(r0 % MATRIX_W);
-        const uint16_t y = (uint16_t)((r0 >> 8) % MATRIX_H);
+        for (uint8_t k = 0; k < CONF_POPS_PER_STEP; k++) {
+            const uint32_t r0 = xorshift32_u32(&s_conf_rng);
+            const uint16_t x = (uint16_t)(r0 % MATRIX_W);
+            const uint16_t y = (uint16_t)((r0 >> 8) % MATRIX_H);
 
-        uint8_t rr, gg, bb;
-        const uint8_t hue = (uint8_t)(r0 >> 16);
-        hsv_to_rgb(hue, 255, 220, &rr, &gg, &bb);
+            uint8_t rr, gg, bb;
+            const uint8_t hue = (uint8_t)(r0 >> 16);
+            fx_pal_rgb(pal, hue, &rr, &gg, &bb);
 
-        const uint16_t i = (uint16_t)(y * MATRIX_W + x);
-        s_conf[i] = (rgb8_t){ rr, gg, bb };
+            const uint16_t i = (uint16_t)(y * MATRIX_W + x);
+            s_conf[i] = (rgb8_t){ rr, gg, bb };
+        }
     }
 
-    conf_present();
+    conf_present(fx_fixed_step_alpha_q8(&s_conf_step));
+}
+
+/* ---------------- Row shaders ----------------
+ * DIAG / GLITTER / RIPPLE — чистые функции (x, y, t): fx_desc_t.shade_row.
+ * Движок зовёт их построчно прямо в canvas (present делает matrix_anim).
+ * Всё, что не зависит от x, считается один раз на строку.
+ * Палитры берутся в shade_prep (однопоточно), shader только читает LUT.
+ */
+
+static const uint8_t *s_pal_diag;
+static const uint8_t *s_pal_glitter;
+static const uint8_t *s_pal_ripple;       // v = 200
+static const uint8_t *s_pal_ripple_hi;    // v = 255 (гребень волны)
+
+static inline void pal_put(const uint8_t *lut, uint8_t i, uint8_t *out_rgb)
+{
+    fx_pal_rgb(lut, i, &out_rgb[0], &out_rgb[1], &out_rgb[2]);
 }
 
 /* ---------------- FX: DIAG RAINBOW ---------------- */
 
-void fx_diag_rainbow_render(fx_ctx_t *ctx)
+void fx_diag_rainbow_prep(fx_ctx_t *ctx)
 {
-    if (!ctx) return;
+    (void)ctx;
+    s_pal_diag = fx_palette_get(FX_PAL_RAINBOW, 210);
+}
 
-    const uint32_t phase = (ctx->anim_ms / 20u);
+void fx_diag_rainbow_shade_row(const fx_ctx_t *ctx, uint16_t y, uint8_t *out_rgb)
+{
+    /* per-row: h(x) = phase + 9y + 7x */
+    uint8_t h = (uint8_t)((ctx->anim_ms / 20u) + (y * 9u));
+    const uint8_t *pal = s_pal_diag;
 
-    for (uint16_t y = 0; y < MATRIX_H; y++) {
-        for (uint16_t x = 0; x < MATRIX_W; x++) {
-            const uint8_t h = (uint8_t)(phase + (x * 7u) + (y * 9u));
-            uint8_t r,g,b;
-            hsv_to_rgb(h, 255, 210, &r,&g,&b);
-            matrix_ws2812_set_pixel_xy(x, y, r, g, b);
-        }
+    for (uint16_t x = 0; x < MATRIX_W; x++, h = (uint8_t)(h + 7u), out_rgb += 3) {
+        pal_put(pal, h, out_rgb);
     }
 }
 
 /* ---------------- FX: GLITTER RAINBOW ---------------- */
 
-void fx_glitter_rainbow_render(fx_ctx_t *ctx)
+void fx_glitter_rainbow_prep(fx_ctx_t *ctx)
 {
-    if (!ctx) return;
+    (void)ctx;
+    s_pal_glitter = fx_palette_get(FX_PAL_RAINBOW, 180);
+}
 
-    const uint32_t phase = (ctx->anim_ms / 20u);
+void fx_glitter_rainbow_shade_row(const fx_ctx_t *ctx, uint16_t y, uint8_t *out_rgb)
+{
+    /* фон не зависит от y: все строки одинаковые */
+    (void)y;
+    uint8_t h = (uint8_t)(ctx->anim_ms / 20u);
+    const uint8_t *pal = s_pal_glitter;
 
-    for (uint16_t y = 0; y < MATRIX_H; y++) {
-        for (uint16_t x = 0; x < MATRIX_W; x++) {
-            const uint8_t h = (uint8_t)(phase + x * 6u);
-            uint8_t r,g,b;
-            hsv_to_rgb(h, 255, 180, &r,&g,&b);
-            matrix_ws2812_set_pixel_xy(x, y, r, g, b);
-        }
+    for (uint16_t x = 0; x < MATRIX_W; x++, h = (uint8_t)(h + 6u), out_rgb += 3) {
+        pal_put(pal, h, out_rgb);
     }
+}
+
+/* post-pass поверх фона (render для shader-эффекта: без present) */
+void fx_glitter_rainbow_post(fx_ctx_t *ctx)
+{
+    if (!ctx) return;
+
+    const uint32_t phase = (ctx->anim_ms / 20u);
 
     // small glitter, deterministic from time
     uint32_t s = (uint32_t)(0x9E3779B9u ^ (phase * 33u) ^ (ctx->wall_ms * 17u));
@@ -191,36 +247,38 @@ void fx_glitter_rainbow_render(fx_ctx_t *ctx)
         const uint32_t rr = xorshift32(&s);
         const uint16_t x = (uint16_t)(rr % MATRIX_W);
         const uint16_t y = (uint16_t)((rr >> 8) % MATRIX_H);
-        matrix_ws2812_set_pixel_xy(x, y, 255, 255, 255);
+        fx_canvas_set(x, y, 255, 255, 255);
     }
 }
 
 /* ---------------- FX: RADIAL RIPPLE ---------------- */
 
-void fx_radial_ripple_render(fx_ctx_t *ctx)
+void fx_radial_ripple_prep(fx_ctx_t *ctx)
 {
-    if (!ctx) return;
+    (void)ctx;
+    s_pal_ripple    = fx_palette_get(FX_PAL_RAINBOW, 200);
+    s_pal_ripple_hi = fx_palette_get(FX_PAL_RAINBOW, 255);
+}
 
+void fx_radial_ripple_shade_row(const fx_ctx_t *ctx, uint16_t y, uint8_t *out_rgb)
+{
     const uint32_t phase = (ctx->anim_ms / 18u);
 
     const int16_t cx = (int16_t)(MATRIX_W / 2u);
     const int16_t cy = (int16_t)(MATRIX_H / 2u);
 
-    for (uint16_t y = 0; y < MATRIX_H; y++) {
-        for (uint16_t x = 0; x < MATRIX_W; x++) {
-            const int16_t dx = (int16_t)x - cx;
-            const int16_t dy = (int16_t)y - cy;
-            const uint16_t dist = (uint16_t)(abs(dx) + abs(dy)); // cheap "radius"
-            const uint8_t h = (uint8_t)(phase + dist * 9u);
-
-            uint8_t v = 200;
-            const uint8_t m = (uint8_t)((phase + dist * 12u) & 0xFFu);
-            if (m < 40u) v = 255;
-
-            uint8_t r,g,b;
-            hsv_to_rgb(h, 255, v, &r,&g,&b);
-            matrix_ws2812_set_pixel_xy(x, y, r, g, b);
-        }
+    /* per-row: |dy| */
+    int16_t ady = (int16_t)((int16_t)y - cy);
+    if (ady < 0) ady = (int16_t)-ady;
+
+    for (uint16_t x = 0; x < MATRIX_W; x++, out_rgb += 3) {
+        int16_t adx = (int16_t)((int16_t)x - cx);
+        if (adx < 0) adx = (int16_t)-adx;
+        const uint16_t dist = (uint16_t)(adx + ady); // cheap "radius"
+        const uint8_t h = (uint8_t)(phase + dist * 9u);
+
+        const uint8_t m = (uint8_t)((phase + dist * 12u) & 0xFFu);
+        pal_put((m < 40u) ? s_pal_ripple_hi : s_pal_ripple, h, out_rgb);
     }
 }
 
@@ -237,26 +295,31 @@ void fx_cubes_render(fx_ctx_t *ctx)
     const int cx = w / 2;
     const int cy = h / 2;
 
-    const float t = (float)ctx->anim_ms * 0.0020f;
+    /* 0.002 rad/ms ~ 20.86 ед. binary angle/ms (fx_math.h) */
+    const uint16_t t = fx_angle_at(ctx->anim_ms, 1367131u);
+
+    const uint8_t *pal = fx_palette_get(FX_PAL_RAINBOW, 200);
 
     for (int k = 0; k < 4; k++) {
-        const float pulse = 0.55f + 0.45f * sinf(t + (float)k * 0.9f);
-        int hw = (int)((10 + k * 6) * pulse);
-        int hh = (int)((5  + k * 3) * pulse);
+        /* pulse = 0.55 + 0.45*sin(t + 0.9k), Q15; 0.9 rad ~ 9387 ед. */
+        const int32_t s = fx_sin_q15((uint16_t)(t + (uint16_t)(k * 9387)));
+        const int32_t pulse = 18022 + fx_mul_q15(14746, s);
+        int hw = (int)(((10 + k * 6) * pulse) >> 15);
+        int hh = (int)(((5  + k * 3) * pulse) >> 15);
 
         if (hw < 2) hw = 2;
         if (hh < 2) hh = 2;
 
         const uint8_t hue = (uint8_t)((ctx->anim_ms >> 4) + (uint8_t)(k * 50));
         uint8_t r,g,b;
-        hsv_to_rgb(hue, 255, 200, &r,&g,&b);
+        fx_pal_rgb(pal, hue, &r,&g,&b);
 
         for (int x = cx - hw; x <= cx + hw; x++) {
             const int y1 = cy - hh;
             const int y2 = cy + hh;
             if ((unsigned)x < MATRIX_W) {
-                if ((unsigned)y1 < MATRIX_H) matrix_ws2812_set_pixel_xy((uint16_t)x, (uint16_t)y1, r,g,b);
-                if ((unsigned)y2 < MATRIX_H) matrix_ws2812_set_pixel_xy((uint16_t)x, (uint16_t)y2, r,g,b);
+                if ((unsigned)y1 < MATRIX_H) fx_canvas_set((uint16_t)x, (uint16_t)y1, r,g,b);
+                if ((unsigned)y2 < MATRIX_H) fx_canvas_set((uint16_t)x, (uint16_t)y2, r,g,b);
             }
         }
 
@@ -264,8 +327,8 @@ void fx_cubes_render(fx_ctx_t *ctx)
             const int x1 = cx - hw;
             const int x2 = cx + hw;
             if ((unsigned)y < MATRIX_H) {
-                if ((unsigned)x1 < MATRIX_W) matrix_ws2812_set_pixel_xy((uint16_t)x1, (uint16_t)y, r,g,b);
-                if ((unsigned)x2 < MATRIX_W) matrix_ws2812_set_pixel_xy((uint16_t)x2, (uint16_t)y, r,g,b);
+                if ((unsigned)x1 < MATRIX_W) fx_canvas_set((uint16_t)x1, (uint16_t)y, r,g,b);
+                if ((unsigned)x2 < MATRIX_W) fx_canvas_set((uint16_t)x2, (uint16_t)y, r,g,b);
             }
         }
     }
@@ -275,52 +338,52 @@ void fx_cubes_render(fx_ctx_t *ctx)
         const uint32_t rr = xorshift32(&seed);
         const uint16_t x = (uint16_t)(rr % MATRIX_W);
         const uint16_t y = (uint16_t)((rr >> 8) % MATRIX_H);
-        matrix_ws2812_set_pixel_xy(x, y, 255, 255, 255);
+        fx_canvas_set(x, y, 255, 255, 255);
     }
 }
 
 /* ---------------- FX: ORBIT DOTS ---------------- */
 
+/* Точка на окружности радиуса r (px) вокруг центра матрицы ((W-1)/2, (H-1)/2), Q8.
+ * Деление на 256 (а не >>8) — усечение к нулю, как у прежнего (int)float. */
+static inline void orbit_point(uint16_t a, int32_t r, int *x, int *y)
+{
+    const int32_t cx_q8 = (int32_t)(MATRIX_W - 1) * 128;
+    const int32_t cy_q8 = (int32_t)(MATRIX_H - 1) * 128;
+    *x = (int)((cx_q8 + ((fx_cos_q15(a) * r) >> 7)) / 256);
+    *y = (int)((cy_q8 + ((fx_sin_q15(a) * r) >> 7)) / 256);
+}
+
 void fx_orbit_dots_render(fx_ctx_t *ctx)
 {
     if (!ctx) return;
 
     const uint32_t t = ctx->anim_ms;
-    const float tf = (float)t * 0.0012f;
-
-    const float cx = (float)(MATRIX_W - 1) * 0.5f;
-    const float cy = (float)(MATRIX_H - 1) * 0.5f;
-
-    const float r0 = 4.0f;
-    const float r1 = 6.0f;
-    const float r2 = 8.0f;
-
-    const float a0 = tf;
-    const float a1 = -tf * 1.3f;
-    const float a2 = tf * 0.7f;
-
-    const int x0 = (int)(cx + cosf(a0) * r0);
-    const int y0 = (int)(cy + sinf(a0) * r0);
 
-    const int x1 = (int)(cx + cosf(a1) * r1);
-    const int y1 = (int)(cy + sinf(a1) * r1);
+    /* угловые скорости 0.0012 / -0.00156 / 0.00084 rad/ms (fx_angle_at, Q16) */
+    const uint16_t a0 = fx_angle_at(t, 820278u);
+    const uint16_t a1 = (uint16_t)(0u - fx_angle_at(t, 1066362u));
+    const uint16_t a2 = fx_angle_at(t, 574195u);
 
-    const int x2 = (int)(cx + cosf(a2) * r2);
-    const int y2 = (int)(cy + sinf(a2) * r2);
+    int x0, y0, x1, y1, x2, y2;
+    orbit_point(a0, 4, &x0, &y0);
+    orbit_point(a1, 6, &x1, &y1);
+    orbit_point(a2, 8, &x2, &y2);
 
     fill_black();
 
-    if ((unsigned)x0 < MATRIX_W && (unsigned)y0 < MATRIX_H) matrix_ws2812_set_pixel_xy((uint16_t)x0, (uint16_t)y0, 255, 80, 40);
-    if ((unsigned)x1 < MATRIX_W && (unsigned)y1 < MATRIX_H) matrix_ws2812_set_pixel_xy((uint16_t)x1, (uint16_t)y1, 40, 255, 80);
-    if ((unsigned)x2 < MATRIX_W && (unsigned)y2 < MATRIX_H) matrix_ws2812_set_pixel_xy((uint16_t)x2, (uint16_t)y2, 80, 40, 255);
+    if ((unsigned)x0 < MATRIX_W && (unsigned)y0 < MATRIX_H) fx_canvas_set((uint16_t)x0, (uint16_t)y0, 255, 80, 40);
+    if ((unsigned)x1 < MATRIX_W && (unsigned)y1 < MATRIX_H) fx_canvas_set((uint16_t)x1, (uint16_t)y1, 40, 255, 80);
+    if ((unsigned)x2 < MATRIX_W && (unsigned)y2 < MATRIX_H) fx_canvas_set((uint16_t)x2, (uint16_t)y2, 80, 40, 255);
 
     // small trail
     for (int i = 0; i < 8; i++) {
-        const float aa = tf - (float)i * 0.25f;
-        const int xt = (int)(cx + cosf(aa) * r1);
-        const int yt = (int)(cy + sinf(aa) * r1);
+        /* 0.25 rad ~ 2608 ед. */
+        const uint16_t aa = (uint16_t)(a0 - (uint16_t)(i * 2608));
+        int xt, yt;
+        orbit_point(aa, 6, &xt, &yt);
         if ((unsigned)xt < MATRIX_W && (unsigned)yt < MATRIX_H) {
-            matrix_ws2812_set_pixel_xy((uint16_t)xt, (uint16_t)yt, 40, 40, 40);
+            fx_canvas_set((uint16_t)xt, (uint16_t)yt, 40, 40, 40);
         }
     }
 }
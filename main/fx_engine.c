@@ -2,16 +2,384 @@
 #include "fx_registry.h"
 
 #include "matrix_ws2812.h"
+#include "fx_canvas.h"
+#include "fx_post.h"
+#include "fx_transition.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 
 static const char *TAG = "FX_ENGINE";
 
-static fx_ctx_t s_ctx;
+/* ============================================================
+ * Cost tiers (level-of-detail)
+ *  - промах: render > FX_TIER_RENDER_BUDGET_PCT% бюджета кадра -> miss_score += 2,
+ *    иначе miss_score -= 1 (leaky bucket: ловит и "через кадр");
+ *  - miss_score >= FX_TIER_DOWN_SCORE -> tier-1;
+ *  - render < FX_TIER_UP_PCT% бюджета подряд up_hold кадров -> tier+1;
+ *  - повышение, за которым быстро последовало понижение, удваивает up_hold
+ *    (до FX_TIER_UP_HOLD_MAX): эффект не "дребезжит" между tier'ами.
+ * При смене эффекта — снова HIGH.
+ * ============================================================ */
+#ifndef FX_TIER_RENDER_BUDGET_PCT
+#define FX_TIER_RENDER_BUDGET_PCT  70u
+#endif
+#ifndef FX_TIER_UP_PCT
+#define FX_TIER_UP_PCT             40u
+#endif
+#define FX_TIER_DOWN_SCORE         6u
+#define FX_TIER_UP_HOLD_MIN        64u    // ~3 s при 22 FPS
+#define FX_TIER_UP_HOLD_MAX        512u
+
+/* ============================================================
+ * Fork/join worker (core 0)
+ *  matrix_anim закреплён за core 1; у core 0 (аудио/WakeNet) есть простои.
+ *  Одна задача за раз, строки раздаются кусками по FX_PAR_CHUNK_ROWS через атомарный
+ *  счётчик s_par_next: и вызывающий, и worker берут следующий кусок, пока строки не кончатся.
+ *  Вызывающий не ждёт, пока worker проснётся: если тот так и не стартовал, все строки
+ *  посчитает сам (как serial). После того как строки кончились, задача закрывается
+ *  (s_par_open = 0); ждать остаётся только кусок, который worker уже взял, — не дольше
+ *  FX_PAR_CHUNK_ROWS строк, а не половины кадра.
+ *  s_par_open/s_par_active — пара Dekker (seq_cst): worker, вошедший после закрытия, задачу
+ *  не трогает; закрытие не пропустит worker'а, уже вошедшего в задачу.
+ * ============================================================ */
+#ifndef FX_PARALLEL_ENABLE
+#define FX_PARALLEL_ENABLE         1
+#endif
+#define FX_PAR_TASK_CORE           0
+#define FX_PAR_TASK_PRIO           3      // ниже аудио/ASR: worker только добирает простои core 0
+#define FX_PAR_TASK_STACK          3072
+#define FX_PAR_JOIN_WAIT_MS        20
+#ifndef FX_PAR_CHUNK_ROWS
+#define FX_PAR_CHUNK_ROWS          4      // кусок строк: граница ожидания join
+#endif
+
+typedef struct {
+    fx_band_fn_t fn;
+    void        *arg;
+    int          rows;
+} fx_par_job_t;
+
+static TaskHandle_t      s_par_task = NULL;
+static SemaphoreHandle_t s_par_join = NULL;
+static fx_par_job_t      s_par_job;
+static int               s_par_next = 0;       // следующая свободная строка
+static uint32_t          s_par_open = 0;       // 1 — задача принимает worker'а
+static uint32_t          s_par_active = 0;     // worker внутри задачи
+static uint32_t          s_par_worker_rows = 0;
+static uint32_t          s_par_jobs = 0;
+static uint32_t          s_par_stolen = 0;
+
+/* Брать куски [y, y+CHUNK) до конца строк. Возврат — сколько строк посчитано. */
+static uint32_t fx_par_drain(const fx_par_job_t *job)
+{
+    uint32_t done = 0;
+    while (1) {
+        const int y0 = __atomic_fetch_add(&s_par_next, FX_PAR_CHUNK_ROWS, __ATOMIC_RELAXED);
+        if (y0 >= job->rows) break;
+        const int y1 = (y0 + FX_PAR_CHUNK_ROWS < job->rows) ? (y0 + FX_PAR_CHUNK_ROWS) : job->rows;
+        job->fn(job->arg, y0, y1);
+        done += (uint32_t)(y1 - y0);
+    }
+    return done;
+}
+
+static void fx_par_worker_task(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        __atomic_add_fetch(&s_par_active, 1u, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&s_par_open, __ATOMIC_SEQ_CST)) {
+            const uint32_t done = fx_par_drain(&s_par_job);
+            __atomic_add_fetch(&s_par_worker_rows, done, __ATOMIC_RELAXED);
+        }
+        // поздний notify (задача уже закрыта) — просто выходим
+        __atomic_sub_fetch(&s_par_active, 1u, __ATOMIC_RELEASE);
+        (void)xSemaphoreGive(s_par_join);
+    }
+}
+
+static void fx_par_init_once(void)
+{
+#if FX_PARALLEL_ENABLE
+    if (s_par_task) return;
+
+    s_par_join = xSemaphoreCreateBinary();
+    if (!s_par_join) {
+        ESP_LOGW(TAG, "parallel: join sem alloc failed, serial render");
+        return;
+    }
+
+    if (xTaskCreatePinnedToCore(fx_par_worker_task, "fx_par", FX_PAR_TASK_STACK, NULL,
+                                FX_PAR_TASK_PRIO, &s_par_task, FX_PAR_TASK_CORE) != pdPASS) {
+        ESP_LOGW(TAG, "parallel: worker create failed, serial render");
+        vSemaphoreDelete(s_par_join);
+        s_par_join = NULL;
+        s_par_task = NULL;
+    }
+#endif
+}
+
+void fx_engine_parallel_rows(int rows, fx_band_fn_t fn, void *arg)
+{
+    if (!fn || rows <= 0) return;
+
+    if (!s_par_task || rows <= FX_PAR_CHUNK_ROWS) {
+        fn(arg, 0, rows);
+        return;
+    }
+
+    s_par_job.fn   = fn;
+    s_par_job.arg  = arg;
+    s_par_job.rows = rows;
+    s_par_worker_rows = 0;
+    __atomic_store_n(&s_par_next, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_par_open, 1u, __ATOMIC_SEQ_CST);
+    (void)xTaskNotifyGive(s_par_task);
+    s_par_jobs++;
+
+    (void)fx_par_drain(&s_par_job);
+
+    // строк больше нет: закрыть задачу и дождаться куска, который worker уже взял
+    __atomic_store_n(&s_par_open, 0u, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&s_par_active, __ATOMIC_SEQ_CST) != 0u) {
+        (void)xSemaphoreTake(s_par_join, pdMS_TO_TICKS(FX_PAR_JOIN_WAIT_MS));
+    }
+
+    if (__atomic_load_n(&s_par_worker_rows, __ATOMIC_RELAXED) == 0u) s_par_stolen++;
+}
+
+void fx_engine_get_parallel_stats(uint32_t *jobs, uint32_t *stolen)
+{
+    if (jobs)   *jobs = s_par_jobs;
+    if (stolen) *stolen = s_par_stolen;
+}
+
+/* ============================================================
+ * Fixed timestep
+ * ============================================================ */
+
+void fx_fixed_step_init(fx_fixed_step_t *fs, uint32_t step_ms, uint8_t max_steps)
+{
+    if (!fs) return;
+    fs->step_ms    = step_ms ? step_ms : 1u;
+    fs->accum_ms   = 0;
+    fs->max_steps  = max_steps ? max_steps : 1u;
+    fs->dropped_ms = 0;
+}
+
+uint8_t fx_fixed_step_advance(fx_fixed_step_t *fs, uint32_t dt_ms)
+{
+    if (!fs || dt_ms == 0u) return 0;
+
+    fs->accum_ms += dt_ms;
+    uint32_t steps = fs->accum_ms / fs->step_ms;
+
+    if (steps > fs->max_steps) {
+        // догоняем не больше max_steps; остаток < step_ms сохраняется (alpha не прыгает)
+        const uint32_t drop = (steps - fs->max_steps) * fs->step_ms;
+        fs->accum_ms   -= drop;
+        fs->dropped_ms += drop;
+        steps = fs->max_steps;
+    }
+
+    fs->accum_ms -= steps * fs->step_ms;
+    return (uint8_t)steps;
+}
+
+uint8_t fx_fixed_step_alpha_q8(const fx_fixed_step_t *fs)
+{
+    if (!fs) return 255;
+    const uint32_t a = (fs->accum_ms * 256u) / fs->step_ms;
+    return (uint8_t)((a > 255u) ? 255u : a);
+}
+
+static fx_ctx_t s_ctx;   // effect_id в нём — эффект, который рисуется (снимок matrix_anim)
+
+// Запрошенный эффект: пишет ctrl_bus (своя задача), matrix_anim снимает его раз за кадр
+static volatile uint16_t s_req_effect = 0;
+
+static uint32_t        s_frame_budget_us = 45454u;
+static uint16_t        s_tier_fx = 0;          // для какого эффекта ведём статистику
+static uint32_t        s_tier_since_up = 0;    // кадров с последнего повышения
+static fx_tier_stats_t s_tier_st = {
+    .tier = FX_TIER_HIGH,
+    .up_hold = FX_TIER_UP_HOLD_MIN,
+};
+
+static void tier_reset(uint16_t effect_id)
+{
+    s_tier_fx = effect_id;
+    s_tier_st.tier = FX_TIER_HIGH;
+    s_tier_st.miss_score = 0;
+    s_tier_st.ok_streak = 0;
+    s_tier_st.up_hold = FX_TIER_UP_HOLD_MIN;
+    s_tier_since_up = UINT32_MAX;
+}
+
+static void tier_update(uint32_t render_us)
+{
+    const uint32_t budget = (s_frame_budget_us * FX_TIER_RENDER_BUDGET_PCT) / 100u;
+    const uint32_t up_thr = (s_frame_budget_us * FX_TIER_UP_PCT) / 100u;
+
+    s_tier_st.render_us = render_us;
+    s_tier_st.budget_us = budget;
+    if (s_tier_since_up != UINT32_MAX) s_tier_since_up++;
+
+    if (render_us > budget) {
+        if (s_tier_st.miss_score < 250u) s_tier_st.miss_score = (uint8_t)(s_tier_st.miss_score + 2u);
+        s_tier_st.ok_streak = 0;
+    } else {
+        if (s_tier_st.miss_score) s_tier_st.miss_score--;
+        if (render_us < up_thr) {
+            if (s_tier_st.ok_streak < UINT16_MAX) s_tier_st.ok_streak++;
+        } else {
+            s_tier_st.ok_streak = 0;
+        }
+    }
+
+    if (s_tier_st.miss_score >= FX_TIER_DOWN_SCORE && s_tier_st.tier > FX_TIER_LOW) {
+        // повышение не прижилось -> дольше ждать следующего
+        if (s_tier_since_up < s_tier_st.up_hold && s_tier_st.up_hold < FX_TIER_UP_HOLD_MAX) {
+            s_tier_st.up_hold = (uint16_t)(s_tier_st.up_hold * 2u);
+        }
+        s_tier_st.tier--;
+        s_tier_st.downgrades++;
+        s_tier_st.miss_score = 0;
+        s_tier_st.ok_streak = 0;
+        ESP_LOGI(TAG, "tier -> %u (render=%uus budget=%uus)",
+                 (unsigned)s_tier_st.tier, (unsigned)render_us, (unsigned)budget);
+    } else if (s_tier_st.ok_streak >= s_tier_st.up_hold && s_tier_st.tier < FX_TIER_HIGH) {
+        s_tier_st.tier++;
+        s_tier_st.upgrades++;
+        s_tier_st.ok_streak = 0;
+        s_tier_since_up = 0;
+        ESP_LOGI(TAG, "tier -> %u (render=%uus, hold=%u)",
+                 (unsigned)s_tier_st.tier, (unsigned)render_us, (unsigned)s_tier_st.up_hold);
+    }
+}
+
+/* ============================================================
+ * Переход между эффектами (fx_transition)
+ *  - смена effect_id видна в render (ctrl_bus меняет id из своей задачи, matrix_anim снимает его раз
+ *    за кадр и передаёт в render — anim-сброс, render и post видят один и тот же id);
+ *  - кадр begin() — прогрев: входящий рисуется (init/reset, таблицы), но на экран идёт снимок
+ *    уходящего без смешивания; эта стоимость не идёт ни в tier входящего, ни в бюджет уходящего;
+ *  - уходящий: свой банк canvas, своё anim-время (продолжается), свой tier;
+ *  - входящий: другой банк (стартует с копии картинки уходящего, как при жёсткой смене),
+ *    anim с нуля (matrix_anim), tier-контроллер видит только его стоимость;
+ *  - уходящий + входящий прошлого кадра > бюджета render -> tier уходящего -1 за кадр,
+ *    ниже LOW — заморозка (последний снимок, без render).
+ * ============================================================ */
+static uint16_t         s_rendered_fx = 0;   // эффект прошлого кадра (0 — кадров ещё не было)
+static const fx_desc_t *s_out_desc = NULL;   // NULL — уходящий заморожен
+static fx_ctx_t         s_out_ctx;
+static uint8_t          s_out_bank = 0;
+static uint32_t         s_out_us = 0;        // стоимость уходящего на прошлом кадре
+static uint32_t         s_in_us = 0;         // стоимость входящего на прошлом кадре
+
+// Полоса строк для row shader (ctx только читается)
+typedef struct {
+    const fx_desc_t *d;
+    const fx_ctx_t  *ctx;
+} fx_shade_job_t;
+
+static void shade_rows_band(void *arg, int y0, int y1)
+{
+    const fx_shade_job_t *job = (const fx_shade_job_t *)arg;
+    for (int y = y0; y < y1; y++) {
+        job->d->shade_row(job->ctx, (uint16_t)y, fx_canvas_row((uint16_t)y));
+    }
+}
+
+static void render_desc(const fx_desc_t *d, fx_ctx_t *ctx)
+{
+    if (d->shade_row) {
+        // shader: prep (однопоточно), строки прямо в canvas (батчами по ядрам), render — post-pass
+        if (d->shade_prep) d->shade_prep(ctx);
+        fx_shade_job_t job = { .d = d, .ctx = ctx };
+        fx_engine_parallel_rows(MATRIX_H, shade_rows_band, &job);
+        if (d->render) d->render(ctx);
+    } else {
+        d->render(ctx);
+    }
+}
+
+// Вызывается до tier_reset() входящего: s_tier_st ещё описывает уходящий. true — переход начат
+static bool transition_start(uint16_t out_id, uint32_t out_anim_ms)
+{
+    bool frozen = false;
+    if (!fx_transition_begin(&frozen)) return false;   // переходы выключены: жёсткая смена в том же банке
+
+    const fx_desc_t *od = fx_registry_get(out_id);
+    s_out_desc = (frozen || !od || (!od->render && !od->shade_row)) ? NULL : od;
+
+    s_out_ctx = s_ctx;
+    s_out_ctx.effect_id = out_id;
+    s_out_ctx.anim_ms = out_anim_ms;
+    s_out_ctx.tier = s_tier_st.tier;
+    s_out_us = 0;
+    s_in_us = 0;
+
+    // уходящий остаётся в своём банке, входящий — в соседнем
+    s_out_bank = fx_canvas_bank_current();
+    const uint8_t in_bank = (uint8_t)((s_out_bank + 1u) % FX_CANVAS_BANKS);
+    fx_canvas_bank_copy(in_bank, s_out_bank);
+    fx_canvas_bank_select(in_bank);
+    return true;
+}
+
+// Кадр уходящего -> снимок fx_transition. true — tier уходящего понижен на этом кадре.
+static bool transition_render_out(void)
+{
+    if (!s_out_desc) return false;
+
+    bool downgraded = false;
+    const uint32_t budget = (s_frame_budget_us * FX_TIER_RENDER_BUDGET_PCT) / 100u;
+    if (s_out_us + s_in_us > budget) {
+        if (s_out_ctx.tier > FX_TIER_LOW) {
+            s_out_ctx.tier--;
+            downgraded = true;
+        } else {
+            // дешевле некуда: остаётся снимок прошлого кадра
+            ESP_LOGI(TAG, "transition: outgoing frozen (out=%uus in=%uus budget=%uus)",
+                     (unsigned)s_out_us, (unsigned)s_in_us, (unsigned)budget);
+            s_out_desc = NULL;
+            s_out_us = 0;
+            return false;
+        }
+    }
+
+    s_out_ctx.brightness = s_ctx.brightness;
+    s_out_ctx.speed_pct  = s_ctx.speed_pct;
+    s_out_ctx.paused     = s_ctx.paused;
+    s_out_ctx.wall_ms    = s_ctx.wall_ms;
+    s_out_ctx.wall_dt_ms = s_ctx.wall_dt_ms;
+    s_out_ctx.anim_dt_ms = s_ctx.anim_dt_ms;
+    s_out_ctx.anim_ms   += s_ctx.anim_dt_ms;
+
+    const uint8_t in_bank = fx_canvas_bank_current();
+    fx_canvas_bank_select(s_out_bank);
+
+    const int64_t t0 = esp_timer_get_time();
+    render_desc(s_out_desc, &s_out_ctx);
+    fx_transition_capture_out(fx_post_run(s_out_desc->post, s_out_ctx.tier, NULL));
+    s_out_us = (uint32_t)(esp_timer_get_time() - t0);
+
+    fx_canvas_bank_select(in_bank);
+    return downgraded;
+}
 
 void fx_engine_init(void)
 {
     s_ctx.effect_id  = fx_registry_first_id();
+    s_req_effect     = s_ctx.effect_id;
     s_ctx.brightness = 102;
     s_ctx.speed_pct  = 100;
     s_ctx.paused     = false;
@@ -22,6 +390,11 @@ void fx_engine_init(void)
     s_ctx.anim_ms    = 0;
     s_ctx.anim_dt_ms = 0;
 
+    tier_reset(s_ctx.effect_id);
+    s_ctx.tier = s_tier_st.tier;
+
+    fx_par_init_once();
+
     matrix_ws2812_set_brightness(s_ctx.brightness);
 
     const fx_desc_t *d = fx_registry_get(s_ctx.effect_id);
@@ -35,18 +408,18 @@ void fx_engine_set_effect(uint16_t id)
     const fx_desc_t *d = fx_registry_get(id);
     if (!d) {
         ESP_LOGW(TAG, "effect=%u not found, fallback to first", (unsigned)id);
-        s_ctx.effect_id = fx_registry_first_id();
-        d = fx_registry_get(s_ctx.effect_id);
-    } else {
-        s_ctx.effect_id = id;
+        id = fx_registry_first_id();
+        d = fx_registry_get(id);
     }
+    s_req_effect = id;
 
     // ВАЖНО по NewTimeApproach:
     // anim_ms/anim_dt_ms обнуляются/пересчитываются в matrix_anim при смене эффекта.
     // fx_engine не управляет временем.
+    // Переход (fx_transition) стартует в render, когда смену увидит matrix_task.
 
     ESP_LOGI(TAG, "effect=%u (%s)",
-             (unsigned)s_ctx.effect_id,
+             (unsigned)id,
              d ? d->name : "?");
 }
 
@@ -70,34 +443,74 @@ void fx_engine_pause_set(bool paused)
     s_ctx.paused = paused;
 }
 
-uint16_t fx_engine_get_effect(void)     { return s_ctx.effect_id; }
+uint16_t fx_engine_get_effect(void)     { return s_req_effect; }
 uint8_t  fx_engine_get_brightness(void) { return s_ctx.brightness; }
 uint16_t fx_engine_get_speed_pct(void)  { return s_ctx.speed_pct; }
 bool     fx_engine_get_paused(void)     { return s_ctx.paused; }
 
-void fx_engine_render(uint32_t wall_ms,
+void fx_engine_set_frame_budget_us(uint32_t budget_us)
+{
+    if (budget_us) s_frame_budget_us = budget_us;
+}
+
+uint8_t fx_engine_get_tier(void) { return s_tier_st.tier; }
+
+void fx_engine_get_tier_stats(fx_tier_stats_t *out)
+{
+    if (out) *out = s_tier_st;
+}
+
+void fx_engine_render(uint16_t effect_id,
+                      uint32_t wall_ms,
                       uint32_t wall_dt_ms,
                       uint32_t anim_ms,
                       uint32_t anim_dt_ms)
 {
+    // anim-время эффекта прошлого кадра: при смене это время уходящего
+    const uint32_t prev_anim_ms = s_ctx.anim_ms;
+
     // fx_engine — чистый consumer времени: просто прокидываем в ctx
     s_ctx.wall_ms    = wall_ms;
     s_ctx.wall_dt_ms = wall_dt_ms;
     s_ctx.anim_ms    = anim_ms;
     s_ctx.anim_dt_ms = anim_dt_ms;
+    s_ctx.effect_id  = effect_id;
 
-    const fx_desc_t *d = fx_registry_get(s_ctx.effect_id);
-    if (!d || !d->render) {
+    const fx_desc_t *d = fx_registry_get(effect_id);
+    if (!d || (!d->render && !d->shade_row)) {
         // fallback: clear
-        for (uint16_t y = 0; y < MATRIX_H; y++) {
-            for (uint16_t x = 0; x < MATRIX_W; x++) {
-                matrix_ws2812_set_pixel_xy(x, y, 0, 0, 0);
-            }
-        }
+        fx_canvas_clear(0, 0, 0);
         return;
     }
 
+    // переход: прогресс идёт по wall-времени (в паузе тоже завершается), затем — смена эффекта
+    fx_transition_tick(wall_dt_ms);
+    bool warm = false;   // кадр прогрева входящего (begin)
+    if (d->id != s_rendered_fx) {
+        if (s_rendered_fx != 0) warm = transition_start(s_rendered_fx, prev_anim_ms);
+        s_rendered_fx = d->id;
+    }
+
+    // tier-статистика ведётся на эффект (ctrl_bus может сменить его между кадрами)
+    if (d->id != s_tier_fx) tier_reset(d->id);
+    s_ctx.tier = s_tier_st.tier;
+
+    const bool in_transition = fx_transition_active();
+    const bool out_downgraded = in_transition ? transition_render_out() : false;
+
     // pause реализуется тем, что anim_dt_ms==0 (anim time frozen),
     // но render + show продолжают выполняться всегда (show делает matrix_anim).
-    d->render(&s_ctx);
+    const int64_t t0 = esp_timer_get_time();
+    render_desc(d, &s_ctx);
+    const uint32_t in_us = (uint32_t)(esp_timer_get_time() - t0);
+
+    // tier входящего — только по его собственной стоимости (уходящий — временная нагрузка),
+    // разовый init на кадре прогрева — не его стоимость
+    if (!warm) tier_update(in_us);
+
+    if (in_transition) {
+        s_in_us = warm ? 0u : in_us;
+        fx_transition_note_cost(s_out_us, in_us,
+                                s_out_desc ? s_out_ctx.tier : FX_TRANS_OUT_FROZEN, out_downgraded);
+    }
 }
@@ -6,6 +6,14 @@
 extern "C" {
 #endif
 
+// Cost tier (level-of-detail): fx_engine понижает при повторных промахах бюджета
+// и повышает при устойчивом запасе. Эффекты с необязательными стадиями читают ctx->tier.
+typedef enum {
+    FX_TIER_LOW  = 0,   // минимум: только базовая картинка
+    FX_TIER_MID  = 1,
+    FX_TIER_HIGH = 2,   // всё включено (дефолт)
+} fx_tier_t;
+
 typedef struct fx_ctx_t {
     // Controls (single source of truth lives in ctrl_bus)
     uint16_t effect_id;
@@ -18,8 +26,23 @@ typedef struct fx_ctx_t {
     uint32_t wall_dt_ms;
     uint32_t anim_ms;
     uint32_t anim_dt_ms;
+
+    // Cost tier (fx_tier_t), выставляет fx_engine перед render
+    uint8_t  tier;
 } fx_ctx_t;
 
+// Телеметрия tier-контроллера (гистерезис виден снаружи)
+typedef struct {
+    uint8_t  tier;            // текущий fx_tier_t
+    uint8_t  miss_score;      // leaky bucket промахов (понижение при >= порога)
+    uint16_t ok_streak;       // кадры подряд с запасом (повышение при >= up_hold)
+    uint16_t up_hold;         // текущий порог повышения (растёт после "дребезга")
+    uint32_t render_us;       // последний render
+    uint32_t budget_us;       // бюджет render (доля бюджета кадра)
+    uint32_t downgrades;
+    uint32_t upgrades;
+} fx_tier_stats_t;
+
 
 void fx_engine_init(void);
 
@@ -33,10 +56,47 @@ uint8_t  fx_engine_get_brightness(void);
 uint16_t fx_engine_get_speed_pct(void);
 bool     fx_engine_get_paused(void);
 
+// Бюджет кадра (us) от matrix_anim (период frame clock), база для tier-контроллера.
+void     fx_engine_set_frame_budget_us(uint32_t budget_us);
+uint8_t  fx_engine_get_tier(void);
+void     fx_engine_get_tier_stats(fx_tier_stats_t *out);
+
+// Fork/join по строкам (dual-core): эффект отдаёт parallel-safe callback полосы [y0,y1).
+// Строки раздаются кусками: их берут и worker на core 0, и вызывающий (core 1); возврат — после
+// завершения ВСЕХ полос. Callback обязан писать только в свои строки и не звать
+// esp_random()/логи/API драйвера (результат должен совпадать с последовательным).
+// Если worker занят (core 0 под аудио), вызывающий считает все строки сам; ожидание join —
+// не дольше одного куска, который worker уже взял.
+typedef void (*fx_band_fn_t)(void *arg, int y0, int y1);
+void fx_engine_parallel_rows(int rows, fx_band_fn_t fn, void *arg);
+
+// Телеметрия fork/join: всего задач и в скольких worker не посчитал ни одной строки.
+void fx_engine_get_parallel_stats(uint32_t *jobs, uint32_t *stolen);
+
+// Fixed timestep: симуляция эффекта идёт шагами step_ms (anim-время) независимо от FPS,
+// render смешивает предыдущее и текущее состояние по alpha (доля до следующего шага).
+// max_steps — потолок догоняния за кадр: после лага лишнее время выбрасывается, а не
+// превращается в лавину шагов. Цена симуляции ~ 1000/step_ms шагов в секунду при любом FPS.
+typedef struct {
+    uint32_t step_ms;
+    uint32_t accum_ms;      // накоплено, < step_ms после advance()
+    uint8_t  max_steps;
+    uint32_t dropped_ms;    // выброшено потолком (телеметрия)
+} fx_fixed_step_t;
+
+void    fx_fixed_step_init(fx_fixed_step_t *fs, uint32_t step_ms, uint8_t max_steps);
+// Добавить anim_dt_ms, вернуть число шагов на этот кадр (0..max_steps). dt = 0 (pause) -> 0.
+uint8_t fx_fixed_step_advance(fx_fixed_step_t *fs, uint32_t dt_ms);
+// alpha Q8 (0..255): 0 = предыдущее состояние, 255 ~ текущее
+uint8_t fx_fixed_step_alpha_q8(const fx_fixed_step_t *fs);
+
 // Render одного кадра.
 // wall_*  — реальное время (не зависит от pause)
 // anim_*  — время анимации (масштабируется speed_pct, замораживается при pause, сбрасывается при смене эффекта)
+// effect_id — снимок fx_engine_get_effect() на этот кадр (matrix_anim берёт его один раз и им же
+//             сбрасывает anim-время и выбирает post): ctrl_bus может сменить эффект посреди кадра.
 void fx_engine_render(
+    uint16_t effect_id,
     uint32_t wall_ms,
     uint32_t wall_dt_ms,
     uint32_t anim_ms,
@@ -0,0 +1,126 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ * fx_math.h
+ *
+ * Зачем:
+ *   - Общая целочисленная математика для эффектов: без sinf/cosf/деления на кадр
+ *     (у нас CONFIG_COMPILER_OPTIMIZATION_DEBUG, вызовы libm там особенно дороги).
+ *
+ * Соглашения:
+ *   - Угол — "binary angle" uint16: 65536 = полный оборот (2π). Переполнение = wrap.
+ *     Перевод: 1 rad = 10430.4 ед.; вращение со скоростью ω rad/ms — fx_angle_at(t_ms, K),
+ *     K = round(ω * 10430.378 * 65536).
+ *   - Q15: 32767 ~ 1.0 (FX_Q15_ONE), знаковые значения в int16/int32.
+ *   - 8-битные примитивы (scale8/qadd8/...) — в стиле FastLED, для каналов цвета.
+ * ============================================================ */
+
+#define FX_Q15_ONE          32767
+#define FX_ANGLE_FULL       65536u
+#define FX_ANGLE_HALF       32768u
+#define FX_ANGLE_QUARTER    16384u
+
+/* sin на 256 отрезков периода + 1 (замыкание), Q15. Таблица — в fx_math.c (flash). */
+extern const int16_t fx_sin_lut_q15[257];
+
+/* sin/cos(angle) в Q15, линейная интерполяция по LUT: ошибка ~1.1e-4 от libm */
+static inline int16_t fx_sin_q15(uint16_t a)
+{
+    const uint8_t  i = (uint8_t)(a >> 8);
+    const int32_t  f = (int32_t)(a & 0xFFu);
+    const int32_t  s0 = fx_sin_lut_q15[i];
+    const int32_t  s1 = fx_sin_lut_q15[i + 1u];
+    return (int16_t)(s0 + (((s1 - s0) * f) >> 8));
+}
+
+static inline int16_t fx_cos_q15(uint16_t a)
+{
+    return fx_sin_q15((uint16_t)(a + FX_ANGLE_QUARTER));
+}
+
+/* Угол вращения к моменту t_ms: t_ms * K / 65536 (K — скорость в ед./ms, Q16).
+ * 64-бит произведение: ошибка скорости < 1/65536 ед./ms, фаза не уплывает от float-версии
+ * за время жизни эффекта (K/2^S с малым S даёт дрейф ~0.05%, градусы за минуты). */
+static inline uint16_t fx_angle_at(uint32_t t_ms, uint32_t k_q16)
+{
+    return (uint16_t)(((uint64_t)t_ms * k_q16) >> 16);
+}
+
+/* atan2(y, x) -> binary angle (0 = +x, 16384 = +y). |x|,|y| < 65536.
+ * Полином первого порядка по октанту: ошибка < 0.25° (~45 ед.). */
+uint16_t fx_atan2_u16(int32_t y, int32_t x);
+
+/* ---------------- Целочисленные утилиты ---------------- */
+
+static inline int32_t fx_clamp_i32(int32_t v, int32_t lo, int32_t hi)
+{
+    if (v < lo) return lo;
+    if (v > hi) return hi;
+    return v;
+}
+
+/* Q15 * Q15 -> Q15 */
+static inline int32_t fx_mul_q15(int32_t a, int32_t b)
+{
+    return (a * b) >> 15;
+}
+
+/* x/255 без деления, точно для x <= 65534 (8x8 бит произведение) */
+static inline uint32_t fx_div255(uint32_t x)
+{
+    return (x + 1u + (x >> 8)) >> 8;
+}
+
+/* Reciprocal-multiply: делитель, постоянный на кадр/эффект, превращается в умножение.
+ * r = fx_recip_q16(d) считается один раз; x / d ~ fx_mul_recip_q16(x, r) (для x < 65536,
+ * r округлён вверх: результат может быть больше точного на 1 — верхнюю границу клампить). */
+static inline uint32_t fx_recip_q16(uint32_t d)
+{
+    return (d == 0u) ? 0u : (65536u + d - 1u) / d;
+}
+
+static inline uint32_t fx_mul_recip_q16(uint32_t x, uint32_t r)
+{
+    return (x * r) >> 16;
+}
+
+/* ---------------- 8-битные примитивы цвета ---------------- */
+
+/* v * scale / 256, scale=255 -> почти без изменений */
+static inline uint8_t fx_scale8(uint8_t v, uint8_t scale)
+{
+    return (uint8_t)(((uint16_t)v * (uint16_t)(scale + 1u)) >> 8);
+}
+
+/* как scale8, но ненулевое v не гасится в 0 при ненулевом scale */
+static inline uint8_t fx_scale8_video(uint8_t v, uint8_t scale)
+{
+    return (uint8_t)((((uint16_t)v * (uint16_t)scale) >> 8) + ((v && scale) ? 1u : 0u));
+}
+
+static inline uint8_t fx_qadd8(uint8_t a, uint8_t b)
+{
+    const uint16_t s = (uint16_t)a + b;
+    return (uint8_t)(s > 255u ? 255u : s);
+}
+
+static inline uint8_t fx_qsub8(uint8_t a, uint8_t b)
+{
+    return (a > b) ? (uint8_t)(a - b) : (uint8_t)0;
+}
+
+/* a + (b - a) * t/256 */
+static inline uint8_t fx_lerp8(uint8_t a, uint8_t b, uint8_t t)
+{
+    return (uint8_t)((int32_t)a + ((((int32_t)b - (int32_t)a) * (int32_t)t) >> 8));
+}
+
+#ifdef __cplusplus
+}
+#endif
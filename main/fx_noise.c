@@ -0,0 +1,223 @@
+#include "fx_noise.h"
+
+#include <string.h>
+
+#include "fx_canvas.h"
+#include "fx_math.h"
+#include "fx_palette.h"
+
+/* ============================================================
+ * Value noise
+ * ============================================================ */
+
+static inline uint8_t lattice_hash(uint32_t x, uint32_t y, uint32_t z)
+{
+    uint32_t h = (x * 0x27D4EB2Du) ^ (y * 0x165667B1u) ^ (z * 0x9E3779B1u);
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return (uint8_t)(h >> 24);
+}
+
+/* smoothstep 3t^2 - 2t^3, t и результат в Q8 */
+static inline int32_t fade8(uint32_t t)
+{
+    return (int32_t)((t * t * (768u - 2u * t)) >> 16);
+}
+
+static inline int32_t lerp8(int32_t a, int32_t b, int32_t f)
+{
+    return a + (((b - a) * f) >> 8);
+}
+
+/* yz-интерполяция в столбце решётки ix (для строки с фиксированными y/z) */
+static inline int32_t column_yz(uint32_t ix, uint32_t iy, uint32_t iz, int32_t fy, int32_t fz)
+{
+    const int32_t a = lerp8(lattice_hash(ix, iy, iz),     lattice_hash(ix, iy + 1u, iz),     fy);
+    const int32_t b = lerp8(lattice_hash(ix, iy, iz + 1u), lattice_hash(ix, iy + 1u, iz + 1u), fy);
+    return lerp8(a, b, fz);
+}
+
+uint8_t fx_noise3(uint32_t x_q8, uint32_t y_q8, uint32_t z_q8)
+{
+    const uint32_t ix = x_q8 >> 8, iy = y_q8 >> 8, iz = z_q8 >> 8;
+    const int32_t  fy = fade8(y_q8 & 0xFFu);
+    const int32_t  fz = fade8(z_q8 & 0xFFu);
+
+    const int32_t c0 = column_yz(ix,      iy, iz, fy, fz);
+    const int32_t c1 = column_yz(ix + 1u, iy, iz, fy, fz);
+    return (uint8_t)lerp8(c0, c1, fade8(x_q8 & 0xFFu));
+}
+
+void fx_noise3_row(uint32_t x0_q8, uint32_t dx_q8, uint32_t y_q8, uint32_t z_q8,
+                   uint8_t *out, uint16_t n)
+{
+    const uint32_t iy = y_q8 >> 8, iz = z_q8 >> 8;
+    const int32_t  fy = fade8(y_q8 & 0xFFu);
+    const int32_t  fz = fade8(z_q8 & 0xFFu);
+
+    uint32_t x  = x0_q8;
+    uint32_t ix = x >> 8;
+    int32_t  c0 = column_yz(ix,      iy, iz, fy, fz);
+    int32_t  c1 = column_yz(ix + 1u, iy, iz, fy, fz);
+
+    for (uint16_t i = 0; i < n; i++, x += dx_q8) {
+        const uint32_t cx = x >> 8;
+        if (cx != ix) {
+            // следующая ячейка: правый столбец становится левым (шаг <= 1 ячейки — один пересчёт)
+            if (cx == ix + 1u) {
+                c0 = c1;
+            } else {
+                c0 = column_yz(cx, iy, iz, fy, fz);
+            }
+            ix = cx;
+            c1 = column_yz(ix + 1u, iy, iz, fy, fz);
+        }
+        out[i] = (uint8_t)lerp8(c0, c1, fade8(x & 0xFFu));
+    }
+}
+
+/* ============================================================
+ * fBm с кэшем нижних октав
+ * ============================================================ */
+
+/* Вес октавы i (Q8): 128, 64, 32, 16 */
+static inline uint32_t oct_weight(uint8_t i)
+{
+    return 128u >> i;
+}
+
+/* Сдвиг октав друг относительно друга, чтобы решётки не совпадали узлами */
+static inline uint32_t oct_offset_q8(uint8_t i)
+{
+    return (uint32_t)i * 0x3A7F1u;
+}
+
+/* Взвешенная сумма октав [o0, o1) строки y. Поле сдвинуто на y_ofs вверх (к большим y). */
+static void octaves_row_acc(const fx_fbm_t *f, uint8_t o0, uint8_t o1,
+                            uint16_t y, uint32_t y_ofs_q8, uint32_t z_q8, uint16_t *acc)
+{
+    uint8_t tmp[MATRIX_W];
+
+    for (uint8_t o = o0; o < o1; o++) {
+        const uint32_t step = (uint32_t)f->scale_q8 << o;
+        const uint32_t off  = oct_offset_q8(o);
+        const uint32_t w    = oct_weight(o);
+
+        fx_noise3_row(off, step, (uint32_t)y * step - (y_ofs_q8 << o) + off, z_q8 + off, tmp, MATRIX_W);
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            acc[x] = (uint16_t)(acc[x] + tmp[x] * w);
+        }
+    }
+}
+
+static inline uint32_t drift_of(const fx_fbm_t *f, uint32_t z_q8)
+{
+    return (uint32_t)(((uint64_t)z_q8 * f->drift_q8) >> 8);
+}
+
+static void key_build(fx_fbm_t *f, int k, uint32_t z_q8)
+{
+    const uint32_t y_ofs = drift_of(f, z_q8);
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        memset(f->key[k][y], 0, sizeof(f->key[k][y]));
+        octaves_row_acc(f, 0, f->cached, y, y_ofs, z_q8, f->key[k][y]);
+    }
+}
+
+void fx_fbm_init(fx_fbm_t *f, uint8_t octaves, uint8_t cached, uint16_t scale_q8,
+                 uint32_t key_dz_q8, uint16_t drift_q8)
+{
+    if (!f) return;
+    if (octaves < 1u) octaves = 1u;
+    if (octaves > FX_NOISE_OCT_MAX) octaves = FX_NOISE_OCT_MAX;
+    if (cached > octaves) cached = octaves;
+    if (key_dz_q8 == 0u) key_dz_q8 = 256u;
+
+    f->octaves   = octaves;
+    f->cached    = cached;
+    f->scale_q8  = scale_q8;
+    f->key_dz_q8 = key_dz_q8;
+    f->drift_q8  = drift_q8;
+    f->valid     = false;
+    f->key_t     = 0;
+
+    fx_fbm_set_octaves(f, octaves);
+}
+
+void fx_fbm_set_octaves(fx_fbm_t *f, uint8_t octaves)
+{
+    if (!f) return;
+    if (octaves < f->cached) octaves = f->cached;
+    if (octaves < 1u) octaves = 1u;
+    if (octaves > FX_NOISE_OCT_MAX) octaves = FX_NOISE_OCT_MAX;
+
+    f->octaves = octaves;
+
+    uint32_t wsum = 0;
+    for (uint8_t o = 0; o < octaves; o++) wsum += oct_weight(o);
+    f->recip_q16 = fx_recip_q16(wsum);
+}
+
+void fx_fbm_prep(fx_fbm_t *f, uint32_t z_q8)
+{
+    if (!f || f->cached == 0u) return;
+
+    const uint32_t kz = z_q8 - (z_q8 % f->key_dz_q8);
+
+    if (!f->valid || kz != f->key_z_q8) {
+        if (f->valid && kz == f->key_z_q8 + f->key_dz_q8) {
+            // время дошло до ключа 1: он становится ключом 0, считаем один новый
+            memcpy(f->key[0], f->key[1], sizeof(f->key[0]));
+        } else {
+            key_build(f, 0, kz);
+        }
+        key_build(f, 1, kz + f->key_dz_q8);
+        f->key_z_q8 = kz;
+        f->valid    = true;
+    }
+
+    f->key_t = (uint8_t)(((uint64_t)(z_q8 - kz) * 256u) / f->key_dz_q8);
+}
+
+void fx_fbm_row(const fx_fbm_t *f, uint16_t y, uint32_t z_q8, uint8_t *out)
+{
+    uint16_t acc[MATRIX_W];
+
+    if (f->cached && f->valid) {
+        const uint16_t *k0 = f->key[0][y];
+        const uint16_t *k1 = f->key[1][y];
+        const int32_t   t  = f->key_t;
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            acc[x] = (uint16_t)((int32_t)k0[x] + ((((int32_t)k1[x] - (int32_t)k0[x]) * t) >> 8));
+        }
+    } else {
+        memset(acc, 0, sizeof(acc));
+    }
+
+    const uint8_t live0 = (f->cached && f->valid) ? f->cached : 0u;
+    octaves_row_acc(f, live0, f->octaves, y, drift_of(f, z_q8), z_q8, acc);
+
+    for (uint16_t x = 0; x < MATRIX_W; x++) {
+        const uint32_t v = fx_mul_recip_q16(acc[x], f->recip_q16);
+        out[x] = (uint8_t)(v > 255u ? 255u : v);
+    }
+}
+
+void fx_noise_fill_band(const fx_fbm_t *f, uint32_t z_q8,
+                        const uint8_t *pal, uint8_t idx_ofs, int y0, int y1)
+{
+    uint8_t n[MATRIX_W];
+
+    for (int y = y0; y < y1; y++) {
+        uint8_t *row = fx_canvas_row((uint16_t)y);
+        if (!row) continue;
+
+        fx_fbm_row(f, (uint16_t)y, z_q8, n);
+        for (uint16_t x = 0; x < MATRIX_W; x++, row += 3) {
+            // fBm собран к середине (64..192): контраст x2 вокруг 128 с насыщением
+            const int32_t v = fx_clamp_i32(2 * (int32_t)n[x] - 128, 0, 255);
+            fx_pal_rgb(pal, (uint8_t)(v + idx_ofs), &row[0], &row[1], &row[2]);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "matrix_ws2812.h"   // MATRIX_W / MATRIX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ * fx_noise.h
+ *
+ * Зачем:
+ *   - Органические эффекты (плазма, лава, облака) на целочисленном 3D value noise:
+ *     без float и без полного пересчёта всех октав на каждый пиксель.
+ *
+ * Модель:
+ *   - Координаты в Q8 (решётка = 256 ед.), результат 0..255. Интерполяция — smoothstep.
+ *   - fx_noise3_row(): строка за раз. y/z строки постоянны, поэтому на каждую ячейку
+ *     решётки по x считается один столбец (4 хеша), на пиксель — один lerp.
+ *   - fx_fbm_t: fBm из нескольких октав. Нижние (крупные) `cached` октав считаются в два
+ *     ключевых кадра по оси z (шаг key_dz_q8) и интерполируются во времени: при скорости
+ *     dz на кадр один ключ пересчитывается раз в key_dz/dz кадров. Остальные октавы —
+ *     живые, per-row. Дрейф по y (drift_q8) ключи берут на своё z, живые октавы — на текущее.
+ *
+ * Потоки:
+ *   - fx_fbm_prep() меняет кэш — вызывать однопоточно (shade_prep / render);
+ *   - fx_fbm_row() / fx_noise_fill_band() только читают — можно из полос обоих ядер.
+ * ============================================================ */
+
+#define FX_NOISE_OCT_MAX    4
+
+/* Одна точка, 0..255 */
+uint8_t fx_noise3(uint32_t x_q8, uint32_t y_q8, uint32_t z_q8);
+
+/* n точек строки: x = x0 + i*dx (Q8), y/z фиксированы */
+void fx_noise3_row(uint32_t x0_q8, uint32_t dx_q8, uint32_t y_q8, uint32_t z_q8,
+                   uint8_t *out, uint16_t n);
+
+typedef struct {
+    /* параметры (задаются до fx_fbm_init) */
+    uint8_t  octaves;           // 1..FX_NOISE_OCT_MAX
+    uint8_t  cached;            // нижних октав из кэша, 0..octaves
+    uint16_t scale_q8;          // шаг первой октавы на пиксель (Q8), каждая следующая x2
+    uint32_t key_dz_q8;         // расстояние по z между ключами кэша
+    uint16_t drift_q8;          // дрейф поля вверх: px (Q8) на 256 ед. z (0 = без дрейфа)
+
+    /* состояние */
+    bool     valid;
+    uint32_t key_z_q8;          // z ключа 0 (ключ 1 = key_z + key_dz)
+    uint8_t  key_t;             // фаза между ключами 0..255 (из последнего prep)
+    uint32_t recip_q16;         // 65536 / сумма весов октав
+    uint16_t key[2][MATRIX_H][MATRIX_W];   // взвешенная сумма кэшируемых октав
+} fx_fbm_t;
+
+void fx_fbm_init(fx_fbm_t *f, uint8_t octaves, uint8_t cached, uint16_t scale_q8,
+                 uint32_t key_dz_q8, uint16_t drift_q8);
+
+/* Число октав на лету (cost tier): веса перенормируются, кэш не трогается (n >= cached) */
+void fx_fbm_set_octaves(fx_fbm_t *f, uint8_t octaves);
+
+/* Подготовка кадра для времени z: при выходе за пару ключей пересчитывает ключ(и). */
+void fx_fbm_prep(fx_fbm_t *f, uint32_t z_q8);
+
+/* Строка y (MATRIX_W значений 0..255) для времени z (z — тот же, что в последнем prep) */
+void fx_fbm_row(const fx_fbm_t *f, uint16_t y, uint32_t z_q8, uint8_t *out);
+
+/* Полоса canvas [y0, y1): fBm -> контраст x2 вокруг 128 -> палитра (LUT 256*3, fx_palette),
+ * индекс сдвигается на idx_ofs (с переполнением) */
+void fx_noise_fill_band(const fx_fbm_t *f, uint32_t z_q8,
+                        const uint8_t *pal, uint8_t idx_ofs, int y0, int y1);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,174 @@
+#include "fx_palette.h"
+
+#include <string.h>
+
+#include "fx_math.h"
+
+/* ============================================================
+ * Опорные точки встроенных палитр
+ * ============================================================ */
+
+static const fx_pal_stop_t k_heat[] = {
+    {   0,   0,   0,   0 },
+    {  85, 255,   0,   0 },
+    { 170, 255, 255,   0 },
+    { 255, 255, 255, 255 },
+};
+
+static const fx_pal_stop_t k_ocean[] = {
+    {   0,   0,   0,  40 },
+    {  96,   0,  40, 160 },
+    { 176,   0, 160, 200 },
+    { 255, 120, 255, 230 },
+};
+
+static const fx_pal_stop_t k_lava[] = {
+    {   0,   0,   0,   0 },
+    {  64, 120,   0,   0 },
+    { 144, 255,  60,   0 },
+    { 208, 255, 160,   0 },
+    { 255, 255, 230,  80 },
+};
+
+static fx_pal_stop_t s_custom[FX_PAL_STOPS_MAX] = {
+    {   0,   0,   0,   0 },
+    { 255, 255, 255, 255 },
+};
+static uint8_t s_custom_n = 2;
+
+/* ============================================================
+ * Кэш LUT: ключ (id, scale), вытеснение LRU
+ * ============================================================ */
+
+#ifndef FX_PAL_CACHE_SLOTS
+#define FX_PAL_CACHE_SLOTS  3
+#endif
+
+typedef struct {
+    bool     valid;
+    uint8_t  id;
+    uint8_t  scale;
+    uint32_t stamp;
+    uint8_t  lut[256 * 3];
+} pal_slot_t;
+
+static pal_slot_t s_slots[FX_PAL_CACHE_SLOTS];
+static uint32_t   s_stamp = 0;
+
+/* RAINBOW — не градиент, а формула прежнего hsv_to_rgb(h, 255, v) на каждый индекс: шесть
+ * секторов по 43 со своим округлением, линейные опорные точки расходились с ней до 4 LSB.
+ * v = scale: "value" эффекта, как раньше шло в hsv_to_rgb. */
+static void rainbow_build(uint8_t v, uint8_t *out)
+{
+    for (uint32_t h = 0; h < 256u; h++) {
+        const uint8_t region = (uint8_t)(h / 43u);
+        const uint8_t rem = (uint8_t)((h - region * 43u) * 6u);
+
+        const uint8_t q = (uint8_t)((v * (255u - ((255u * rem) >> 8))) >> 8);
+        const uint8_t t = (uint8_t)((v * (255u - ((255u * (255u - rem)) >> 8))) >> 8);
+
+        uint8_t *d = &out[h * 3u];
+        switch (region) {
+        default:
+        case 0: d[0] = v; d[1] = t; d[2] = 0; break;
+        case 1: d[0] = q; d[1] = v; d[2] = 0; break;
+        case 2: d[0] = 0; d[1] = v; d[2] = t; break;
+        case 3: d[0] = 0; d[1] = q; d[2] = v; break;
+        case 4: d[0] = t; d[1] = 0; d[2] = v; break;
+        case 5: d[0] = v; d[1] = 0; d[2] = q; break;
+        }
+    }
+}
+
+/* d * t / span с округлением к ближайшему и для убывающего канала (деление C усекает к нулю) */
+static inline int32_t lerp_round(int32_t d, int32_t t, int32_t span)
+{
+    const int32_t num = d * t;
+    return (num >= 0 ? num + span / 2 : num - span / 2) / span;
+}
+
+void fx_palette_build(const fx_pal_stop_t *stops, uint8_t n, uint8_t scale, uint8_t *out)
+{
+    if (!stops || n == 0 || !out) return;
+
+    uint8_t k = 0;
+    for (uint32_t i = 0; i < 256u; i++) {
+        while ((uint8_t)(k + 1u) < n && i > stops[k + 1].pos) k++;
+
+        const fx_pal_stop_t *a = &stops[k];
+        const fx_pal_stop_t *b = ((uint8_t)(k + 1u) < n) ? &stops[k + 1] : a;
+
+        int32_t c[3] = { a->r, a->g, a->b };
+        if (b != a && b->pos > a->pos && i > a->pos) {
+            const int32_t span = (int32_t)b->pos - (int32_t)a->pos;
+            const int32_t t    = (int32_t)i - (int32_t)a->pos;
+            c[0] += lerp_round((int32_t)b->r - a->r, t, span);
+            c[1] += lerp_round((int32_t)b->g - a->g, t, span);
+            c[2] += lerp_round((int32_t)b->b - a->b, t, span);
+        }
+
+        for (int j = 0; j < 3; j++) {
+            out[i * 3u + (uint32_t)j] = (uint8_t)fx_div255((uint32_t)fx_clamp_i32(c[j], 0, 255) * scale);
+        }
+    }
+}
+
+static void stops_of(fx_pal_id_t id, const fx_pal_stop_t **stops, uint8_t *n)
+{
+    switch (id) {
+    case FX_PAL_HEAT:   *stops = k_heat;   *n = (uint8_t)(sizeof(k_heat) / sizeof(k_heat[0]));     break;
+    case FX_PAL_OCEAN:  *stops = k_ocean;  *n = (uint8_t)(sizeof(k_ocean) / sizeof(k_ocean[0]));   break;
+    case FX_PAL_LAVA:   *stops = k_lava;   *n = (uint8_t)(sizeof(k_lava) / sizeof(k_lava[0]));     break;
+    case FX_PAL_CUSTOM:
+    default:            *stops = s_custom; *n = s_custom_n;                                        break;
+    }
+}
+
+const uint8_t *fx_palette_get(fx_pal_id_t id, uint8_t scale)
+{
+    if ((unsigned)id >= FX_PAL_COUNT) return NULL;
+
+    s_stamp++;
+
+    pal_slot_t *victim = &s_slots[0];
+    for (int i = 0; i < FX_PAL_CACHE_SLOTS; i++) {
+        pal_slot_t *sl = &s_slots[i];
+        if (sl->valid && sl->id == (uint8_t)id && sl->scale == scale) {
+            sl->stamp = s_stamp;
+            return sl->lut;
+        }
+        if (!sl->valid || (victim->valid && sl->stamp < victim->stamp)) victim = sl;
+    }
+
+    // промах: пересборка (256 * 3 байта, только при смене ключа)
+    if (id == FX_PAL_RAINBOW) {
+        rainbow_build(scale, victim->lut);
+    } else {
+        const fx_pal_stop_t *stops;
+        uint8_t n;
+        stops_of(id, &stops, &n);
+        fx_palette_build(stops, n, scale, victim->lut);
+    }
+
+    victim->valid = true;
+    victim->id    = (uint8_t)id;
+    victim->scale = scale;
+    victim->stamp = s_stamp;
+    return victim->lut;
+}
+
+bool fx_palette_set_custom(const fx_pal_stop_t *stops, uint8_t n)
+{
+    if (!stops || n < 2u || n > FX_PAL_STOPS_MAX) return false;
+    if (stops[0].pos != 0u || stops[n - 1u].pos != 255u) return false;
+    for (uint8_t i = 1; i < n; i++) {
+        if (stops[i].pos < stops[i - 1u].pos) return false;
+    }
+
+    memcpy(s_custom, stops, (size_t)n * sizeof(stops[0]));
+    s_custom_n = n;
+    for (int i = 0; i < FX_PAL_CACHE_SLOTS; i++) {
+        if (s_slots[i].id == (uint8_t)FX_PAL_CUSTOM) s_slots[i].valid = false;
+    }
+    return true;
+}
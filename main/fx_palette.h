@@ -0,0 +1,65 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ * fx_palette.h
+ *
+ * Зачем:
+ *   - Эффекты, у которых цвет зависит только от 8-битного индекса (hue/heat/...),
+ *     берут его из LUT на 256 RGB вместо hsv_to_rgb() на каждый пиксель.
+ *
+ * Модель:
+ *   - Палитра задаётся компактно: градиентные опорные точки {pos, r, g, b}
+ *     (pos 0..255, по возрастанию, первая 0, последняя 255). RAINBOW — формулой
+ *     hsv_to_rgb(i, 255, scale), байт в байт как прежний per-pixel hsv_to_rgb.
+ *   - fx_palette_get(id, scale) отдаёт LUT 256*3 (RGB), уже умноженный на scale
+ *     ("value" эффекта, 255 = без изменений). Варианты кэшируются (несколько слотов, LRU)
+ *     и пересобираются только при смене ключа (палитра, scale); set_custom сбрасывает custom-слоты.
+ *   - Глобальная яркость/гамма сюда НЕ входят: они в выходном каскаде matrix_ws2812.
+ *
+ * Потоки:
+ *   - get/set_custom — только из anim task (render, shade_prep). Row shader читает
+ *     полученный указатель; LUT не меняется до следующего get в этом же task.
+ * ============================================================ */
+
+typedef enum {
+    FX_PAL_RAINBOW = 0,   // = hsv_to_rgb(h, 255, scale), побайтно
+    FX_PAL_HEAT,          // black -> red -> yellow -> white
+    FX_PAL_OCEAN,         // deep blue -> cyan -> light aqua
+    FX_PAL_LAVA,          // black -> dark red -> orange -> yellow
+    FX_PAL_CUSTOM,        // fx_palette_set_custom()
+    FX_PAL_COUNT
+} fx_pal_id_t;
+
+typedef struct {
+    uint8_t pos;
+    uint8_t r, g, b;
+} fx_pal_stop_t;
+
+#define FX_PAL_STOPS_MAX    16
+
+/* LUT 256*3 (RGB), умноженный на scale. NULL только при неверном id. */
+const uint8_t *fx_palette_get(fx_pal_id_t id, uint8_t scale);
+
+/* Задать custom-палитру (копируется, до FX_PAL_STOPS_MAX точек). Кэш custom сбрасывается. */
+bool fx_palette_set_custom(const fx_pal_stop_t *stops, uint8_t n);
+
+/* Градиент из опорных точек в out[256*3] (без scale). Чистая функция. */
+void fx_palette_build(const fx_pal_stop_t *stops, uint8_t n, uint8_t scale, uint8_t *out);
+
+static inline void fx_pal_rgb(const uint8_t *lut, uint8_t i, uint8_t *r, uint8_t *g, uint8_t *b)
+{
+    const uint8_t *p = &lut[(uint32_t)i * 3u];
+    *r = p[0];
+    *g = p[1];
+    *b = p[2];
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,168 @@
+#include "fx_particles.h"
+
+#include "fx_canvas.h"
+#include "fx_math.h"
+#include "matrix_ws2812.h"
+
+void fx_psys_clear(fx_psys_t *ps)
+{
+    if (!ps) return;
+    ps->count = 0;
+    ps->nfree = ps->cap;
+    // стек свободных: сверху младшие индексы (заполнение идёт с начала массивов)
+    for (uint16_t i = 0; i < ps->cap; i++) {
+        ps->free[i] = (uint16_t)(ps->cap - 1u - i);
+    }
+}
+
+void fx_psys_init(fx_psys_t *ps, int16_t w, int16_t h, bool wrap_x, uint8_t life_max, uint8_t fade_min)
+{
+    if (!ps) return;
+    ps->w        = w;
+    ps->h        = h;
+    ps->wrap_x   = wrap_x;
+    ps->life_max = life_max ? life_max : 1u;
+    ps->fade_min = fade_min;
+    // life*span < 2^16 (оба <= 255): с округлением вверх сдвиг даёт ровно floor(life*span/life_max)
+    ps->fade_q16 = (((255u - fade_min) << 16) + ps->life_max - 1u) / ps->life_max;
+    fx_psys_clear(ps);
+}
+
+int fx_psys_spawn(fx_psys_t *ps)
+{
+    if (!ps || ps->nfree == 0) return -1;
+    const uint16_t i = ps->free[--ps->nfree];
+    ps->live[ps->count++] = i;
+    return (int)i;
+}
+
+/* kill по позиции в live: последний живой встаёт на его место */
+static inline void kill_at(fx_psys_t *ps, uint16_t pos)
+{
+    ps->free[ps->nfree++] = ps->live[pos];
+    ps->live[pos] = ps->live[--ps->count];
+}
+
+void fx_psys_integrate(fx_psys_t *ps, int16_t ax_q8, int16_t ay_q8, uint16_t dt_q8)
+{
+    if (!ps || dt_q8 == 0u) return;
+
+    const int32_t w_q8 = (int32_t)ps->w * 256;
+    const int32_t h_q8 = (int32_t)ps->h * 256;
+
+    // с конца: swap-remove не сдвигает ещё не пройденные элементы
+    for (int p = (int)ps->count - 1; p >= 0; p--) {
+        const uint16_t i = ps->live[p];
+
+        if (ps->life[i] == 0) { kill_at(ps, (uint16_t)p); continue; }
+        ps->life[i]--;
+
+        ps->vx_q8[i] = (int16_t)(ps->vx_q8[i] + ax_q8);
+        ps->vy_q8[i] = (int16_t)(ps->vy_q8[i] + ay_q8);
+
+        int32_t x = ps->x_q8[i] + (((int32_t)ps->vx_q8[i] * dt_q8) >> 8);
+        int32_t y = ps->y_q8[i] + (((int32_t)ps->vy_q8[i] * dt_q8) >> 8);
+
+        if (ps->wrap_x) {
+            // деление только при выходе за край (редко), а не на каждом тике
+            if (x < 0 || x >= w_q8) {
+                x %= w_q8;
+                if (x < 0) x += w_q8;
+            }
+        } else if (x < 0 || x >= w_q8) {
+            kill_at(ps, (uint16_t)p);
+            continue;
+        }
+
+        if (y < 0 || y >= h_q8) { kill_at(ps, (uint16_t)p); continue; }
+
+        ps->x_q8[i] = (int16_t)x;
+        ps->y_q8[i] = (int16_t)y;
+    }
+}
+
+/* (v*s)/255 с округлением */
+static inline uint8_t scale_rnd(uint8_t v, uint8_t s)
+{
+    return (uint8_t)fx_div255((uint32_t)v * s + 127u);
+}
+
+/* Два канала в полях по 16 бит (биты 0..7 и 16..23) за одно умножение:
+ * v*s + 127 <= 65152, div255 поканально — переносов между полями нет, результат == scale_rnd */
+static inline uint32_t scale_rnd2(uint32_t v2, uint8_t s)
+{
+    const uint32_t x = v2 * s + 0x007F007Fu;
+    return ((x + 0x00010001u + ((x >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+}
+
+/* scale_rnd(v, bri) таблицей: bri постоянен на кадр (обычно и дольше), таблица строится при смене */
+static uint8_t s_bri_lut[256];
+static int     s_bri_lut_for = -1;
+
+static void bri_lut_update(uint8_t bri)
+{
+    if (s_bri_lut_for == (int)bri) return;
+    for (uint32_t v = 0; v < 256u; v++) {
+        s_bri_lut[v] = scale_rnd((uint8_t)v, bri);
+    }
+    s_bri_lut_for = bri;
+}
+
+/* max по каналам прямо в базу canvas */
+static inline void splat_max_px(uint16_t cx, uint16_t cy, uint8_t r, uint8_t g, uint8_t b)
+{
+    uint8_t *row = fx_canvas_row(cy);
+    if (!row || cx >= MATRIX_W) return;
+    uint8_t *p = &row[(uint32_t)cx * 3u];
+    if (r > p[0]) p[0] = r;
+    if (g > p[1]) p[1] = g;
+    if (b > p[2]) p[2] = b;
+}
+
+void fx_psys_splat(const fx_psys_t *ps, fx_psys_map_fn_t map, uint8_t bri, fx_psys_splat_t mode)
+{
+    if (!ps || ps->count == 0) return;
+
+    static const uint8_t k_tail[3] = { 255, 140, 90 };
+    const bool hdr = (mode == FX_PSYS_SPLAT_HDR_ADD);
+
+    const int h = ps->h;
+    bri_lut_update(bri);
+
+    for (uint16_t p = 0; p < ps->count; p++) {
+        const uint16_t i = ps->live[p];
+
+        const int x = (int)(ps->x_q8[i] >> 8);
+        const int y = (int)(ps->y_q8[i] >> 8);
+        const uint32_t rb = (uint32_t)ps->r[i] | ((uint32_t)ps->b[i] << 16);
+        const uint8_t  cg = ps->g[i];
+        const int n = (ps->tail[i] < 3u) ? (int)ps->tail[i] + 1 : 3;
+
+        // хвост тянется против движения по y
+        const int tdy = (ps->vy_q8[i] >= 0) ? -1 : 1;
+
+        // затухание по жизни: fade_min..255 (не гаснет полностью в полёте)
+        const uint8_t life_k = (uint8_t)(ps->fade_min + (((uint32_t)ps->life[i] * ps->fade_q16) >> 16));
+
+        for (int t = 0, yy = y; t < n; t++, yy += tdy) {
+            if (yy < 0 || yy >= h) break;
+
+            uint16_t cx, cy;
+            if (map) {
+                map(x, yy, &cx, &cy);
+            } else {
+                cx = (uint16_t)x;
+                cy = (uint16_t)yy;
+            }
+
+            // голова: scale_rnd(life_k, 255) == life_k
+            const uint8_t k = t ? scale_rnd(life_k, k_tail[t]) : life_k;
+            const uint32_t rb_k = scale_rnd2(rb, k);
+            const uint8_t r = s_bri_lut[rb_k & 0xFFu];
+            const uint8_t g = s_bri_lut[scale_rnd(cg, k)];
+            const uint8_t b = s_bri_lut[rb_k >> 16];
+            if (hdr) fx_canvas_hdr_add(cx, cy, r, g, b);
+            else     splat_max_px(cx, cy, r, g, b);
+        }
+    }
+}
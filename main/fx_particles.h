@@ -0,0 +1,90 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ * fx_particles.h
+ *
+ * Зачем:
+ *   - Общая система частиц для эффектов (искры, снег, ...): одна реализация
+ *     пула, движения и отрисовки вместо массивов struct с флагом alive в каждом эффекте.
+ *
+ * Модель:
+ *   - SoA: каждое поле — отдельный массив ёмкости cap (проходы по полю идут подряд).
+ *   - Пул фиксированной ёмкости: живые индексы лежат плотно в live[0..count),
+ *     свободные — стеком free[]. spawn/kill — O(1) (kill = swap-remove из live),
+ *     проходы идут только по живым, поэтому цена ∝ count, а не cap.
+ *   - Координаты/скорости — Q8 пикселей в логической системе эффекта;
+ *     wrap_x = цилиндр по x (ширина w), выход за [0, h) по y убивает частицу.
+ *   - Отрисовка: голова + хвост (0..2 px против направления движения по y),
+ *     затухание по остатку жизни, в HDR-накопитель (ADD) или в базу canvas (MAX).
+ *
+ * Хранилище — статическое, объявляется FX_PSYS_DEFINE() в файле эффекта.
+ * Вызовы — только из anim task (render эффекта).
+ * ============================================================ */
+
+typedef struct {
+    /* геометрия и правила */
+    uint16_t cap;
+    int16_t  w, h;            // логический размер поля, px
+    bool     wrap_x;          // цилиндр по x
+    uint8_t  life_max;        // шкала затухания: k = fade_min + life*(255-fade_min)/life_max
+    uint8_t  fade_min;
+    uint32_t fade_q16;        // ceil((255-fade_min)*2^16/life_max): деление на life_max умножением
+
+    /* SoA */
+    int16_t  *x_q8, *y_q8, *vx_q8, *vy_q8;
+    uint8_t  *r, *g, *b;
+    uint8_t  *life;           // осталось тиков
+    uint8_t  *tail;           // 0 = точка, 1..2 = хвост
+
+    /* пул */
+    uint16_t *live;           // плотный список живых индексов
+    uint16_t *free;           // стек свободных индексов
+    uint16_t  count;
+    uint16_t  nfree;
+} fx_psys_t;
+
+#define FX_PSYS_DEFINE(_name, _cap)                                                     \
+    static int16_t  _name##_x[_cap], _name##_y[_cap], _name##_vx[_cap], _name##_vy[_cap]; \
+    static uint8_t  _name##_r[_cap], _name##_g[_cap], _name##_b[_cap];                    \
+    static uint8_t  _name##_life[_cap], _name##_tail[_cap];                               \
+    static uint16_t _name##_live[_cap], _name##_free[_cap];                               \
+    static fx_psys_t _name = {                                                          \
+        .cap = (_cap),                                                                  \
+        .x_q8 = _name##_x, .y_q8 = _name##_y, .vx_q8 = _name##_vx, .vy_q8 = _name##_vy, \
+        .r = _name##_r, .g = _name##_g, .b = _name##_b,                                 \
+        .life = _name##_life, .tail = _name##_tail,                                     \
+        .live = _name##_live, .free = _name##_free,                                     \
+    }
+
+typedef enum {
+    FX_PSYS_SPLAT_HDR_ADD = 0,   // fx_canvas_hdr_add (аддитивно, без clamp)
+    FX_PSYS_SPLAT_BASE_MAX,      // max по каналам прямо в базу canvas (для следов через dim)
+} fx_psys_splat_t;
+
+/* логические (lx, ly) -> координаты canvas; NULL = тождественно */
+typedef void (*fx_psys_map_fn_t)(int lx, int ly, uint16_t *cx, uint16_t *cy);
+
+/* Геометрия + пустой пул */
+void fx_psys_init(fx_psys_t *ps, int16_t w, int16_t h, bool wrap_x, uint8_t life_max, uint8_t fade_min);
+void fx_psys_clear(fx_psys_t *ps);
+
+/* Новая частица: индекс в SoA (поля заполняет вызывающий) или -1, если пул полон */
+int  fx_psys_spawn(fx_psys_t *ps);
+
+/* Тик: life==0 -> kill; life--; v += a; p += v*dt; wrap/kill по границам.
+ * dt_q8 = 256 — один тик; 0 — ничего не делать (pause). */
+void fx_psys_integrate(fx_psys_t *ps, int16_t ax_q8, int16_t ay_q8, uint16_t dt_q8);
+
+/* Отрисовка всех живых: цвет * затухание по жизни * хвост * bri */
+void fx_psys_splat(const fx_psys_t *ps, fx_psys_map_fn_t map, uint8_t bri, fx_psys_splat_t mode);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,287 @@
+#include "fx_post.h"
+
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "fx_canvas.h"
+#include "fx_engine.h"     // fx_tier_t
+#include "fx_math.h"
+#include "matrix_ws2812.h"
+
+static const char *TAG = "FX_POST";
+
+/* ============================================================
+ * Буферы
+ *
+ * По 2304 B из кучи при первом кадре прохода, которому они нужны: пока post у эффектов
+ * выключен, модуль не занимает ни байта. GRADE — s_out, BLUR — + s_tmp, BLOOM — + s_glow.
+ * Не освобождаются (эффект с post может вернуться в любой момент, куча не дробится).
+ * ============================================================ */
+
+#define POST_ROW_BYTES      ((uint32_t)MATRIX_W * 3u)
+#define POST_BYTES          (POST_ROW_BYTES * (uint32_t)MATRIX_H)
+
+/* heap_caps_malloc выравнивает на 4 и больше: вертикальное ядро работает словами */
+static uint8_t *s_out  = NULL;   // результат -> present
+static uint8_t *s_tmp  = NULL;   // после прохода по x
+static uint8_t *s_glow = NULL;   // маска bloom
+static bool     s_no_mem = false;
+
+/* Кадр как массив строк: база canvas (кольцо, строки не смежны) или свои буферы */
+static const uint8_t *s_base_rows[MATRIX_H];
+static const uint8_t *s_out_rows[MATRIX_H];
+static const uint8_t *s_glow_rows[MATRIX_H];
+
+/* LUT температуры: пересчёт только при смене grade_temp */
+static bool   s_lut_valid = false;
+static int8_t s_lut_temp = 0;
+static uint8_t s_lut_r[256], s_lut_g[256], s_lut_b[256];
+
+static bool buf_alloc(uint8_t **buf, const uint8_t **rows)
+{
+    if (*buf) return true;
+
+    *buf = (uint8_t *)heap_caps_malloc(POST_BYTES, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!*buf) return false;
+    if (rows) {
+        for (uint32_t y = 0; y < MATRIX_H; y++) {
+            rows[y] = &(*buf)[y * POST_ROW_BYTES];
+        }
+    }
+    return true;
+}
+
+/* Буферы под проходы run; нет памяти — post выключается до перезагрузки (кадр идёт без post) */
+static bool bufs_ready(uint8_t run)
+{
+    if (s_no_mem) return false;
+
+    bool ok = buf_alloc(&s_out, s_out_rows);
+    if (ok && (run & (FX_POST_BLUR | FX_POST_BLOOM))) ok = buf_alloc(&s_tmp, NULL);
+    if (ok && (run & FX_POST_BLOOM))                  ok = buf_alloc(&s_glow, s_glow_rows);
+
+    if (!ok) {
+        ESP_LOGE(TAG, "no mem for post buffers (%u B each), post disabled", (unsigned)POST_BYTES);
+        s_no_mem = true;
+    }
+    return ok;
+}
+
+/* ============================================================
+ * Строковые ядра
+ *
+ * Непрерывные байты строки, без ветвлений внутри цикла: соседи по x — из строки с
+ * padding'ом, а не через проверку краёв; каналы RGB не различаются (кроме grade).
+ * ============================================================ */
+
+/* Проход по x, 3 tap, кольцо цилиндра: pad = [последний px | строка | первый px] */
+static void hblur_row(const uint8_t *src, uint8_t *dst, uint8_t kernel)
+{
+    uint8_t pad[POST_ROW_BYTES + 6u];
+    memcpy(pad, &src[POST_ROW_BYTES - 3u], 3);
+    memcpy(&pad[3], src, POST_ROW_BYTES);
+    memcpy(&pad[POST_ROW_BYTES + 3u], src, 3);
+
+    if (kernel == FX_POST_KERNEL_BOX) {
+        for (uint32_t i = 0; i < POST_ROW_BYTES; i++) {
+            const uint32_t s = (uint32_t)pad[i] + pad[i + 3u] + pad[i + 6u];
+            dst[i] = (uint8_t)((s * 171u) >> 9);   // /3 без деления (765 -> 255)
+        }
+    } else {
+        for (uint32_t i = 0; i < POST_ROW_BYTES; i++) {
+            dst[i] = (uint8_t)(((uint32_t)pad[i] + 2u * pad[i + 3u] + pad[i + 6u] + 2u) >> 2);
+        }
+    }
+}
+
+/* Проход по y: dst = k(a, b, c) поканально. Gaussian — SWAR: слово = 4 канала,
+ * чётные/нечётные байты в 16-бит полях (255 + 2*255 + 255 + 2 < 2^10, переносов нет). */
+#define SWAR_LO     0x00FF00FFu
+#define SWAR_RND    0x00020002u
+
+static void vblur_row(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *dst, uint8_t kernel)
+{
+    uint32_t i = 0;
+
+    if (kernel == FX_POST_KERNEL_BOX) {
+        for (; i < POST_ROW_BYTES; i++) {
+            const uint32_t s = (uint32_t)a[i] + b[i] + c[i];
+            dst[i] = (uint8_t)((s * 171u) >> 9);
+        }
+        return;
+    }
+
+    if (((((uintptr_t)a) | ((uintptr_t)b) | ((uintptr_t)c) | ((uintptr_t)dst)) & 3u) == 0) {
+        const uint32_t *wa = (const uint32_t *)a;
+        const uint32_t *wb = (const uint32_t *)b;
+        const uint32_t *wc = (const uint32_t *)c;
+        uint32_t *wd = (uint32_t *)dst;
+        for (; i + 4u <= POST_ROW_BYTES; i += 4u) {
+            const uint32_t va = *wa++, vb = *wb++, vc = *wc++;
+            const uint32_t lo = (((va & SWAR_LO) + ((vb & SWAR_LO) << 1) + (vc & SWAR_LO) + SWAR_RND) >> 2) & SWAR_LO;
+            const uint32_t hi = ((((va >> 8) & SWAR_LO) + (((vb >> 8) & SWAR_LO) << 1) + ((vc >> 8) & SWAR_LO) + SWAR_RND) >> 2) & SWAR_LO;
+            *wd++ = lo | (hi << 8);
+        }
+    }
+    for (; i < POST_ROW_BYTES; i++) {
+        dst[i] = (uint8_t)(((uint32_t)a[i] + 2u * b[i] + c[i] + 2u) >> 2);
+    }
+}
+
+/* Яркая часть: то, что выше порога */
+static void threshold_row(const uint8_t *src, uint8_t *dst, uint8_t thr)
+{
+    for (uint32_t i = 0; i < POST_ROW_BYTES; i++) {
+        dst[i] = fx_qsub8(src[i], thr);
+    }
+}
+
+/* dst = sat(src + glow * gain / 64) */
+static void add_row(const uint8_t *src, const uint8_t *glow, uint8_t *dst, uint8_t gain)
+{
+    for (uint32_t i = 0; i < POST_ROW_BYTES; i++) {
+        const uint32_t s = (uint32_t)src[i] + (((uint32_t)glow[i] * gain) >> 6);
+        dst[i] = (uint8_t)(s > 255u ? 255u : s);
+    }
+}
+
+/* Температура (LUT по каналу) + насыщенность вокруг luma (Q7). Можно in-place. */
+static void grade_row(const uint8_t *src, uint8_t *dst, uint8_t sat)
+{
+    for (uint32_t x = 0; x < MATRIX_W; x++) {
+        const uint8_t *s = &src[x * 3u];
+        uint8_t *d = &dst[x * 3u];
+
+        int32_t r = s_lut_r[s[0]];
+        int32_t g = s_lut_g[s[1]];
+        int32_t b = s_lut_b[s[2]];
+
+        if (sat != 128u) {
+            const int32_t l = (77 * r + 150 * g + 29 * b) >> 8;
+            r = fx_clamp_i32(l + (((r - l) * (int32_t)sat) >> 7), 0, 255);
+            g = fx_clamp_i32(l + (((g - l) * (int32_t)sat) >> 7), 0, 255);
+            b = fx_clamp_i32(l + (((b - l) * (int32_t)sat) >> 7), 0, 255);
+        }
+
+        d[0] = (uint8_t)r;
+        d[1] = (uint8_t)g;
+        d[2] = (uint8_t)b;
+    }
+}
+
+static void grade_prepare(int8_t temp)
+{
+    if (s_lut_valid && temp == s_lut_temp) return;
+
+    /* тёплый: B гаснет на temp/256, G — на четверть от этого; холодный — то же для R */
+    const int32_t t = temp;
+    const uint32_t kr = (uint32_t)(256 + (t < 0 ? t : 0));
+    const uint32_t kg = (uint32_t)(256 - (t < 0 ? -t : t) / 4);
+    const uint32_t kb = (uint32_t)(256 - (t > 0 ? t : 0));
+
+    for (uint32_t v = 0; v < 256u; v++) {
+        s_lut_r[v] = (uint8_t)((v * kr) >> 8);
+        s_lut_g[v] = (uint8_t)((v * kg) >> 8);
+        s_lut_b[v] = (uint8_t)((v * kb) >> 8);
+    }
+
+    s_lut_temp = temp;
+    s_lut_valid = true;
+}
+
+/* ============================================================
+ * Проходы по кадру
+ * ============================================================ */
+
+/* Сепарабельный 3x3: src (строки) -> s_tmp (по x) -> dst (по y, края clamp).
+ * dst может быть тем же кадром, что и src: src целиком прочитан до записи. */
+static void blur_frame(const uint8_t *const *src, uint8_t *dst, uint8_t kernel)
+{
+    for (uint32_t y = 0; y < MATRIX_H; y++) {
+        hblur_row(src[y], &s_tmp[y * POST_ROW_BYTES], kernel);
+    }
+    for (uint32_t y = 0; y < MATRIX_H; y++) {
+        const uint32_t ya = (y > 0) ? y - 1u : y;
+        const uint32_t yc = (y + 1u < MATRIX_H) ? y + 1u : y;
+        vblur_row(&s_tmp[ya * POST_ROW_BYTES], &s_tmp[y * POST_ROW_BYTES], &s_tmp[yc * POST_ROW_BYTES],
+                  &dst[y * POST_ROW_BYTES], kernel);
+    }
+}
+
+static inline void pass_done(fx_post_timing_t *t, fx_post_pass_t pass, int64_t *t0)
+{
+    const int64_t now = esp_timer_get_time();
+    if (t) {
+        t->us[pass] = (uint32_t)(now - *t0);
+        t->ran |= (uint8_t)(1u << pass);
+    }
+    *t0 = now;
+}
+
+const uint8_t *fx_post_run(const fx_post_cfg_t *cfg, uint8_t tier, fx_post_timing_t *t)
+{
+    if (t) memset(t, 0, sizeof(*t));
+    if (!cfg) return NULL;
+
+    // проходы этого кадра: bloom на LOW и с нулевым gain не идёт (и буфер под него не нужен)
+    uint8_t run = cfg->passes;
+    if (tier == FX_TIER_LOW || cfg->bloom_gain == 0) run &= (uint8_t)~FX_POST_BLOOM;
+    if (run == 0 || !bufs_ready(run)) return NULL;
+
+    for (uint32_t y = 0; y < MATRIX_H; y++) {
+        s_base_rows[y] = fx_canvas_row((uint16_t)y);
+    }
+
+    const uint8_t *const *cur = s_base_rows;
+    int64_t t0 = esp_timer_get_time();
+
+    if (run & FX_POST_BLUR) {
+        blur_frame(cur, s_out, cfg->blur_kernel);
+        cur = s_out_rows;
+        pass_done(t, FX_POST_PASS_BLUR, &t0);
+    }
+
+    if (run & FX_POST_BLOOM) {
+        uint8_t radius = cfg->bloom_radius;
+        if (radius < 1) radius = 1;
+        if (radius > FX_POST_BLOOM_RADIUS_MAX) radius = FX_POST_BLOOM_RADIUS_MAX;
+        if (tier == FX_TIER_MID) radius = 1;
+
+        for (uint32_t y = 0; y < MATRIX_H; y++) {
+            threshold_row(cur[y], &s_glow[y * POST_ROW_BYTES], cfg->bloom_thr);
+        }
+        for (uint8_t i = 0; i < radius; i++) {
+            blur_frame(s_glow_rows, s_glow, FX_POST_KERNEL_GAUSS);
+        }
+        for (uint32_t y = 0; y < MATRIX_H; y++) {
+            add_row(cur[y], &s_glow[y * POST_ROW_BYTES], &s_out[y * POST_ROW_BYTES], cfg->bloom_gain);
+        }
+        cur = s_out_rows;
+        pass_done(t, FX_POST_PASS_BLOOM, &t0);
+    }
+
+    if (run & FX_POST_GRADE) {
+        grade_prepare(cfg->grade_temp);
+        for (uint32_t y = 0; y < MATRIX_H; y++) {
+            grade_row(cur[y], &s_out[y * POST_ROW_BYTES], cfg->grade_sat);
+        }
+        cur = s_out_rows;
+        pass_done(t, FX_POST_PASS_GRADE, &t0);
+    }
+
+    // хоть один проход был — дальше идёт кадр post вместо базы
+    return (cur == s_out_rows) ? s_out : NULL;
+}
+
+uint32_t fx_post_budget_us(fx_post_pass_t pass)
+{
+    switch (pass) {
+    case FX_POST_PASS_BLUR:  return FX_POST_BLUR_BUDGET_US;
+    case FX_POST_PASS_BLOOM: return FX_POST_BLOOM_BUDGET_US;
+    case FX_POST_PASS_GRADE: return FX_POST_GRADE_BUDGET_US;
+    default:                 return 0;
+    }
+}
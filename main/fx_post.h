@@ -0,0 +1,98 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ * fx_post.h
+ *
+ * Зачем:
+ *   - Post-processing кадра: blur, bloom (свечение ярких точек) и цветокоррекция
+ *     (температура/насыщенность) одним общим этапом, а не внутри per-pixel циклов эффектов.
+ *
+ * Где:
+ *   - matrix_anim: fx_engine_render() -> fx_post_run() -> fx_transition_compose() ->
+ *     genie_overlay_render() -> present. Оверлеи и слои post не проходят.
+ *     Во время перехода fx_engine прогоняет post и для уходящего эффекта (со своим tier).
+ *   - Вход — база canvas (fx_canvas_row), выход — свой буфер, который present берёт вместо
+ *     базы (fx_canvas_present_source). База не меняется: персистентные эффекты (SNOW, CONFETTI)
+ *     не получают blur/bloom обратно в следующий кадр.
+ *
+ * Проходы (порядок фиксирован, каждый включается флагом в fx_desc_t.post):
+ *   - BLUR:  сепарабельный 3x3 (box или gaussian [1 2 1]): строка по x (кольцо цилиндра),
+ *            затем по y (края — clamp).
+ *   - BLOOM: порог по каналам -> gaussian blur radius раз -> насыщающее сложение с gain.
+ *            На FX_TIER_LOW пропускается, на FX_TIER_MID — радиус 1.
+ *   - GRADE: температура (тёплый гасит B, холодный — R) + насыщенность вокруг luma.
+ *
+ * Ядра:
+ *   - Все проходы — строковые ядра по непрерывным байтам без ветвлений внутри строки
+ *     (соседи по x берутся из строки с padding'ом, вертикальный gaussian — SWAR, 4 канала
+ *     в слове). Ложатся на 128-бит SIMD (PIE ESP32-S3) без смены формы данных.
+ *
+ * Бюджет:
+ *   - Время каждого прохода (us) возвращается в fx_post_timing_t и идёт в frame stats
+ *     matrix_anim (гистограмма на проход + счётчик превышений FX_POST_*_BUDGET_US).
+ * ============================================================ */
+
+typedef enum {
+    FX_POST_PASS_BLUR = 0,
+    FX_POST_PASS_BLOOM,
+    FX_POST_PASS_GRADE,
+    FX_POST_PASS_COUNT
+} fx_post_pass_t;
+
+#define FX_POST_BLUR    (1u << FX_POST_PASS_BLUR)
+#define FX_POST_BLOOM   (1u << FX_POST_PASS_BLOOM)
+#define FX_POST_GRADE   (1u << FX_POST_PASS_GRADE)
+
+typedef enum {
+    FX_POST_KERNEL_GAUSS = 0,   // [1 2 1] / 4
+    FX_POST_KERNEL_BOX,         // [1 1 1] / 3
+} fx_post_kernel_t;
+
+/* Бюджет прохода (us) для телеметрии: превышение считается, проход не прерывается */
+#ifndef FX_POST_BLUR_BUDGET_US
+#define FX_POST_BLUR_BUDGET_US      150
+#endif
+#ifndef FX_POST_BLOOM_BUDGET_US
+#define FX_POST_BLOOM_BUDGET_US     300
+#endif
+#ifndef FX_POST_GRADE_BUDGET_US
+#define FX_POST_GRADE_BUDGET_US     150
+#endif
+
+#define FX_POST_BLOOM_RADIUS_MAX    3
+
+/* Настройки post эффекта (static const в fx_registry.c). Поля выключенных проходов не читаются. */
+typedef struct {
+    uint8_t passes;         // FX_POST_* (битовая маска)
+
+    uint8_t blur_kernel;    // fx_post_kernel_t
+
+    uint8_t bloom_thr;      // порог по каналу: светится только то, что выше
+    uint8_t bloom_gain;     // сила свечения, Q6: 64 = 1.0 (blur размазывает маску, нужно > 1)
+    uint8_t bloom_radius;   // проходов gaussian по маске, 1..FX_POST_BLOOM_RADIUS_MAX
+
+    int8_t  grade_temp;     // -128..127: > 0 теплее (меньше B), < 0 холоднее (меньше R)
+    uint8_t grade_sat;      // Q7: 128 = как есть, 0 = ч/б, 255 ~ x2
+} fx_post_cfg_t;
+
+typedef struct {
+    uint32_t us[FX_POST_PASS_COUNT];   // 0 — проход не выполнялся
+    uint8_t  ran;                      // FX_POST_* реально выполненных проходов
+} fx_post_timing_t;
+
+/* Прогнать проходы cfg над базой canvas. Возврат — готовый кадр (row-major RGB, логические строки,
+ * валиден до следующего вызова) или NULL, если проходов не было (cfg == NULL / passes == 0 / bloom
+ * пропущен по tier): тогда кадр — база как есть. tier — fx_tier_t. t (опционально) — время по проходам. */
+const uint8_t *fx_post_run(const fx_post_cfg_t *cfg, uint8_t tier, fx_post_timing_t *t);
+
+uint32_t fx_post_budget_us(fx_post_pass_t pass);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,6 @@
 #include "fx_registry.h"
 #include "fx_engine.h"
+#include "fx_clip.h"
 
 #include <stdbool.h>
 #include <stddef.h> // NULL
@@ -16,6 +17,13 @@
  * - Видимость определяется функцией j_doa_debug_ui_enabled(), которая живёт в fx_effects_doa_debug.c
  *   и должна управляться одним define в этом файле (single source of truth).
  *
+ * CLIP:
+ * - Скрыт, пока в разделе "anim" нет пакета клипов (fx_clip_count() == 0).
+ *
+ * POST:
+ * - Настройки post-processing (fx_post_cfg_t) — static const рядом с таблицей, эффект ссылается
+ *   на них полем .post. Эффект их не видит: blur/bloom/grade делает fx_post после render.
+ *
  * Важно:
  * - Legacy API fx_registry_set_debug_visible() сохранён как NOP для совместимости.
  */
@@ -26,14 +34,22 @@
 // Simple FX
 void fx_snow_fall_render(fx_ctx_t *ctx);
 void fx_confetti_render(fx_ctx_t *ctx);
-void fx_diag_rainbow_render(fx_ctx_t *ctx);
-void fx_glitter_rainbow_render(fx_ctx_t *ctx);
-void fx_radial_ripple_render(fx_ctx_t *ctx);
+void fx_diag_rainbow_prep(fx_ctx_t *ctx);
+void fx_diag_rainbow_shade_row(const fx_ctx_t *ctx, uint16_t y, uint8_t *out_rgb);
+void fx_glitter_rainbow_prep(fx_ctx_t *ctx);
+void fx_glitter_rainbow_shade_row(const fx_ctx_t *ctx, uint16_t y, uint8_t *out_rgb);
+void fx_glitter_rainbow_post(fx_ctx_t *ctx);
+void fx_radial_ripple_prep(fx_ctx_t *ctx);
+void fx_radial_ripple_shade_row(const fx_ctx_t *ctx, uint16_t y, uint8_t *out_rgb);
 void fx_cubes_render(fx_ctx_t *ctx);
 void fx_orbit_dots_render(fx_ctx_t *ctx);
 
 // Complex FX
 void fx_fire_render(fx_ctx_t *ctx);
+void fx_plasma_prep(fx_ctx_t *ctx);
+void fx_plasma_shade_row(const fx_ctx_t *ctx, uint16_t y, uint8_t *out_rgb);
+void fx_lava_render(fx_ctx_t *ctx);
+void fx_clip_render(fx_ctx_t *ctx);
 
 // Debug / Service FX
 void fx_doa_debug_render(fx_ctx_t *ctx);
@@ -44,25 +60,51 @@ bool j_doa_debug_ui_enabled(void);
 
 
 
+/* ------------------------------ Post-processing ------------------------------ */
+
+// Проходы меняют картинку эффекта, поэтому по умолчанию выключены: включать сознательно, по одному
+// эффекту, после проверки на матрице. 1 = ORBIT DOTS со свечением вокруг точек.
+#ifndef FX_POST_ORBIT_BLOOM
+#define FX_POST_ORBIT_BLOOM 0
+#endif
+
+// ORBIT DOTS: одиночные точки на чёрном — мягкое свечение вокруг, хвост (40,40,40) ниже порога
+static const fx_post_cfg_t s_post_orbit = {
+    .passes       = FX_POST_ORBIT_BLOOM ? FX_POST_BLOOM : 0,
+    .bloom_thr    = 64,
+    .bloom_gain   = 160,
+    .bloom_radius = 2,
+};
+
+
 /* ------------------------------ Registry table ------------------------------ */
 
 static const fx_desc_t s_fx[] = {
     /* Simple */
-    { .id = 0xEA01, .name = "SNOW FALL",        .render = fx_snow_fall_render },
-    { .id = 0xEA02, .name = "CONFETTI",         .render = fx_confetti_render },
-    { .id = 0xEA03, .name = "DIAG RAINBOW",     .render = fx_diag_rainbow_render },
-    { .id = 0xEA04, .name = "GLITTER RAINBOW",  .render = fx_glitter_rainbow_render },
-    { .id = 0xEA05, .name = "RADIAL RIPPLE",    .render = fx_radial_ripple_render },
-    { .id = 0xEA06, .name = "CUBES",            .render = fx_cubes_render },
-    { .id = 0xEA07, .name = "ORBIT DOTS",       .render = fx_orbit_dots_render },
+    { .id = 0xEA01, .name = "SNOW FALL",        .render = fx_snow_fall_render,        .fps_pref = 22, .fps_min = 12 },
+    { .id = 0xEA02, .name = "CONFETTI",         .render = fx_confetti_render,         .fps_pref = 22, .fps_min = 12 },
+    { .id = 0xEA03, .name = "DIAG RAINBOW",     .shade_row = fx_diag_rainbow_shade_row,
+                                                .shade_prep = fx_diag_rainbow_prep,        .fps_pref = 18, .fps_min = 10 },
+    { .id = 0xEA04, .name = "GLITTER RAINBOW",  .shade_row = fx_glitter_rainbow_shade_row,
+                                                .shade_prep = fx_glitter_rainbow_prep,
+                                                .render = fx_glitter_rainbow_post,         .fps_pref = 22, .fps_min = 12 },
+    { .id = 0xEA05, .name = "RADIAL RIPPLE",    .shade_row = fx_radial_ripple_shade_row,
+                                                .shade_prep = fx_radial_ripple_prep,       .fps_pref = 22, .fps_min = 12 },
+    { .id = 0xEA06, .name = "CUBES",            .render = fx_cubes_render,            .fps_pref = 22, .fps_min = 12 },
+    { .id = 0xEA07, .name = "ORBIT DOTS",       .render = fx_orbit_dots_render,       .fps_pref = 30, .fps_min = 15,
+                                                .post = &s_post_orbit },
 
     /* Service / Debug (hidden unless enabled) */
-    { .id = 0xED01, .name = "DOA DEBUG",        .render = fx_doa_debug_render },
+    { .id = 0xED01, .name = "DOA DEBUG",        .render = fx_doa_debug_render,        .fps_pref = 15, .fps_min = 10 },
     
 
 
     /* Complex */
-    { .id = 0xCA01, .name = "FIRE",             .render = fx_fire_render },
+    { .id = 0xCA01, .name = "FIRE",             .render = fx_fire_render,             .fps_pref = 40, .fps_min = 18 },
+    { .id = 0xCA02, .name = "PLASMA",           .shade_row = fx_plasma_shade_row,
+                                                .shade_prep = fx_plasma_prep,              .fps_pref = 22, .fps_min = 12 },
+    { .id = 0xCA03, .name = "LAVA",             .render = fx_lava_render,             .fps_pref = 22, .fps_min = 12 },
+    { .id = 0xCA04, .name = "CLIP",             .render = fx_clip_render,             .fps_pref = 30, .fps_min = 10 },
 };
 
 
@@ -75,6 +117,8 @@ static bool is_hidden(const fx_desc_t *d)
     if (d->id == 0xED01u) {
         if (!j_doa_debug_ui_enabled()) return true;
     }
+    // CLIP: только если в разделе anim есть клипы
+    if (d->id == 0xCA04u && fx_clip_count() == 0) return true;
     return false;
 }
 
@@ -7,14 +7,33 @@ extern "C" {
 #endif
 
 #include "fx_engine.h"  // fx_ctx_t
+#include "fx_post.h"    // fx_post_cfg_t
 
 typedef void (*fx_render_fn_t)(fx_ctx_t *ctx);
 
+// Row shader: чистая функция (x, y, t) -> одна строка RGB (row-major, MATRIX_W*3 байт).
+// Движок зовёт её для каждой строки прямо в canvas (строки делятся между ядрами,
+// см. fx_engine_parallel_rows), поэтому shader обязан быть parallel-safe:
+// без записи статического состояния, esp_random(), логов и API драйвера.
+// Всё покадровое (LUT палитры и т.п.) готовит shade_prep — он зовётся однопоточно до строк.
+typedef void (*fx_shade_row_fn_t)(const fx_ctx_t *ctx, uint16_t y, uint8_t *out_rgb);
+
 
 typedef struct fx_desc_t {
     uint16_t      id;
     const char   *name;
-    fx_render_fn_t render;
+    fx_render_fn_t render;        // shader-эффект: опциональный post-pass поверх canvas (без present)
+    fx_shade_row_fn_t shade_row;  // NULL = классический render
+    fx_render_fn_t shade_prep;    // shader-эффект: однопоточный pre-pass кадра (палитры, константы)
+
+    // Frame-rate governor (matrix_anim): 0 = MATRIX_ANIM_FPS.
+    // fps_pref — желаемый FPS, если CPU-бюджет позволяет;
+    // fps_min  — ниже не опускаемся при перегрузке (дальше — пропуск дедлайнов).
+    uint8_t       fps_pref;
+    uint8_t       fps_min;
+
+    // Post-processing (fx_post, matrix_anim после render): NULL = кадр идёт как есть.
+    const fx_post_cfg_t *post;
 } fx_desc_t;
 
 
@@ -0,0 +1,280 @@
+#include "fx_sprite.h"
+
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_partition.h"
+
+#include "fx_math.h"
+#include "matrix_ws2812.h"
+
+static const char *TAG = "FX_SPRITE";
+
+/* ============================================================
+ * Формат пакета (см. fx_sprite.h)
+ * ============================================================ */
+
+#define SPK_MAGIC           0x4B50534Au   // "JSPK"
+#define SPK_VERSION         1u
+#define SPK_HDR_BYTES       12u
+#define SPK_ENTRY_BYTES     (FX_SPRITE_NAME_LEN + 4u)
+#define SPR_HDR_BYTES       4u
+
+struct fx_sprite_s {
+    uint8_t w, h, pal_n, flags;
+    uint8_t body[];           // palette, row offsets, RLE
+};
+
+/* Пакет: указатель в mmap (или в память вызывающего) */
+static const uint8_t *s_pack = NULL;
+static uint32_t       s_pack_size = 0;
+static uint16_t       s_count = 0;
+
+static esp_partition_mmap_handle_t s_mmap_handle;
+static bool                        s_mmapped = false;
+
+/* Палитра, уже умноженная на bri: пересчёт только при смене спрайта/яркости */
+static const fx_sprite_t *s_pal_spr = NULL;
+static uint8_t s_pal_bri = 0;
+static uint8_t s_pr[256], s_pg[256], s_pb[256], s_pa[256];
+
+static inline uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | ((uint16_t)p[1] << 8)); }
+static inline uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint16_t spr_pal_n(const fx_sprite_t *s) { return s->pal_n ? s->pal_n : 256u; }
+static inline const uint8_t *spr_rowofs(const fx_sprite_t *s) { return s->body + (uint32_t)spr_pal_n(s) * 4u; }
+static inline const uint8_t *spr_rle(const fx_sprite_t *s) { return spr_rowofs(s) + (uint32_t)s->h * 2u; }
+
+/* ============================================================
+ * Подключение пакета
+ * ============================================================ */
+
+esp_err_t fx_sprite_attach(const void *pack, size_t size)
+{
+    s_pack = NULL;
+    s_pack_size = 0;
+    s_count = 0;
+    s_pal_spr = NULL;
+
+    if (!pack || size < SPK_HDR_BYTES) return ESP_ERR_INVALID_ARG;
+
+    const uint8_t *p = (const uint8_t *)pack;
+    if (rd32(p) != SPK_MAGIC || rd16(p + 4) != SPK_VERSION) return ESP_ERR_INVALID_VERSION;
+
+    const uint16_t count = rd16(p + 6);
+    const uint32_t total = rd32(p + 8);
+    if (total > size || SPK_HDR_BYTES + (uint32_t)count * SPK_ENTRY_BYTES > total) return ESP_ERR_INVALID_SIZE;
+
+    /* Проверяем заголовки один раз: дальше blit доверяет w/h/палитре/таблице строк */
+    for (uint16_t i = 0; i < count; i++) {
+        const uint32_t ofs = rd32(p + SPK_HDR_BYTES + (uint32_t)i * SPK_ENTRY_BYTES + FX_SPRITE_NAME_LEN);
+        if (ofs + SPR_HDR_BYTES > total) return ESP_ERR_INVALID_SIZE;
+
+        const fx_sprite_t *s = (const fx_sprite_t *)(p + ofs);
+        const uint32_t rle_ofs = ofs + SPR_HDR_BYTES + (uint32_t)spr_pal_n(s) * 4u + (uint32_t)s->h * 2u;
+        if (s->w == 0 || s->h == 0 || rle_ofs > total) return ESP_ERR_INVALID_SIZE;
+
+        for (uint8_t y = 0; y < s->h; y++) {
+            if (rle_ofs + rd16(spr_rowofs(s) + (uint32_t)y * 2u) >= total) return ESP_ERR_INVALID_SIZE;
+        }
+    }
+
+    s_pack = p;
+    s_pack_size = total;
+    s_count = count;
+    return ESP_OK;
+}
+
+esp_err_t fx_sprite_init(void)
+{
+    if (s_mmapped) {
+        esp_partition_munmap(s_mmap_handle);
+        s_mmapped = false;
+    }
+    (void)fx_sprite_attach(NULL, 0);
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ESP_PARTITION_SUBTYPE_ANY,
+                                                           FX_SPRITE_PART_LABEL);
+    if (!part) {
+        ESP_LOGW(TAG, "partition '%s' not found", FX_SPRITE_PART_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void *ptr = NULL;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &s_mmap_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "mmap '%s' failed: %s", FX_SPRITE_PART_LABEL, esp_err_to_name(err));
+        return err;
+    }
+    s_mmapped = true;
+
+    err = fx_sprite_attach(ptr, part->size);
+    if (err != ESP_OK) {
+        // пустой/чужой раздел — не ошибка прошивки: спрайтов просто нет
+        ESP_LOGW(TAG, "no sprite pack in '%s': %s", FX_SPRITE_PART_LABEL, esp_err_to_name(err));
+        esp_partition_munmap(s_mmap_handle);
+        s_mmapped = false;
+        return err;
+    }
+
+    ESP_LOGI(TAG, "sprite pack: %u sprites, %u bytes", (unsigned)s_count, (unsigned)s_pack_size);
+    return ESP_OK;
+}
+
+uint16_t fx_sprite_count(void)
+{
+    return s_count;
+}
+
+const fx_sprite_t *fx_sprite_at(uint16_t idx)
+{
+    if (!s_pack || idx >= s_count) return NULL;
+    const uint32_t ofs = rd32(s_pack + SPK_HDR_BYTES + (uint32_t)idx * SPK_ENTRY_BYTES + FX_SPRITE_NAME_LEN);
+    return (const fx_sprite_t *)(s_pack + ofs);
+}
+
+const fx_sprite_t *fx_sprite_find(const char *name)
+{
+    if (!s_pack || !name) return NULL;
+    for (uint16_t i = 0; i < s_count; i++) {
+        const char *n = (const char *)(s_pack + SPK_HDR_BYTES + (uint32_t)i * SPK_ENTRY_BYTES);
+        if (strncmp(n, name, FX_SPRITE_NAME_LEN) == 0) return fx_sprite_at(i);
+    }
+    return NULL;
+}
+
+uint8_t fx_sprite_w(const fx_sprite_t *s) { return s ? s->w : 0; }
+uint8_t fx_sprite_h(const fx_sprite_t *s) { return s ? s->h : 0; }
+
+/* ============================================================
+ * Blit
+ * ============================================================ */
+
+static void pal_prepare(const fx_sprite_t *s, uint8_t bri)
+{
+    if (s == s_pal_spr && bri == s_pal_bri) return;
+
+    const uint16_t n = spr_pal_n(s);
+    for (uint16_t i = 0; i < n; i++) {
+        const uint8_t *c = &s->body[(uint32_t)i * 4u];
+        s_pr[i] = fx_scale8_video(c[0], bri);
+        s_pg[i] = fx_scale8_video(c[1], bri);
+        s_pb[i] = fx_scale8_video(c[2], bri);
+        s_pa[i] = c[3];
+    }
+    // индексы за палитрой (битый пакет) — прозрачные
+    for (uint16_t i = n; i < 256u; i++) s_pa[i] = 0;
+
+    s_pal_spr = s;
+    s_pal_bri = bri;
+}
+
+/* layer < 0 — база canvas */
+static inline void put_px(int layer, uint8_t *row, int cx, uint16_t cy, uint8_t idx)
+{
+    const uint8_t a = s_pa[idx];
+    if (a == 0) return;
+
+    if (layer >= 0) {
+        fx_layer_set((fx_layer_t)layer, (uint16_t)cx, cy, s_pr[idx], s_pg[idx], s_pb[idx], a);
+        return;
+    }
+
+    uint8_t *d = &row[(uint32_t)cx * 3u];
+    if (a == 255) {
+        d[0] = s_pr[idx];
+        d[1] = s_pg[idx];
+        d[2] = s_pb[idx];
+    } else {
+        d[0] = fx_lerp8(d[0], s_pr[idx], a);
+        d[1] = fx_lerp8(d[1], s_pg[idx], a);
+        d[2] = fx_lerp8(d[2], s_pb[idx], a);
+    }
+}
+
+static void blit_impl(int layer, const fx_sprite_t *s, int x, int y, uint8_t bri, uint32_t flags)
+{
+    if (!s || !s_pack) return;
+
+    const int W = MATRIX_W;
+    const int H = MATRIX_H;
+    const bool wrap = (flags & FX_SPR_WRAP_X) != 0;
+
+    // целиком вне экрана — без декодирования
+    if (y >= H || y + (int)s->h <= 0) return;
+    if (!wrap && (x >= W || x + (int)s->w <= 0)) return;
+
+    pal_prepare(s, bri);
+
+    // x0 — позиция колонки 0 уже внутри [0, W) для wrap
+    int x0 = x;
+    if (wrap) {
+        x0 %= W;
+        if (x0 < 0) x0 += W;
+    }
+
+    const uint8_t *rowofs = spr_rowofs(s);
+    const uint8_t *rle    = spr_rle(s);
+    const uint8_t *end    = s_pack + s_pack_size;
+
+    for (int sy = 0; sy < (int)s->h; sy++) {
+        const int cy = y + (int)s->h - 1 - sy;   // верхняя строка картинки — сверху на лампе
+        if (cy < 0 || cy >= H) continue;         // вертикальный клип: строка пропускается по таблице
+
+        uint8_t *row = NULL;
+        if (layer < 0) {
+            row = fx_canvas_row((uint16_t)cy);
+            if (!row) continue;
+        }
+
+        const uint8_t *p = rle + rd16(rowofs + (uint32_t)sy * 2u);
+        int col = 0;
+
+        while (col < (int)s->w && p < end) {
+            const uint8_t c = *p++;
+            const bool run = (c & 0x80u) != 0;
+            int n = (int)(c & 0x7Fu) + 1;
+            if (n > (int)s->w - col) n = (int)s->w - col;
+
+            if (run) {
+                if (p >= end) break;
+                const uint8_t idx = *p++;
+                if (s_pa[idx] == 0) { col += n; continue; }   // прозрачный отрезок — одним шагом
+
+                for (int k = 0; k < n; k++) {
+                    int cx = x0 + col + k;
+                    if (wrap) { if (cx >= W) cx %= W; }
+                    else if (cx < 0 || cx >= W) continue;
+                    put_px(layer, row, cx, (uint16_t)cy, idx);
+                }
+            } else {
+                int lit = (int)(c & 0x7Fu) + 1;
+                if (lit > (int)(end - p)) lit = (int)(end - p);
+                if (n > lit) n = lit;
+                for (int k = 0; k < n; k++) {
+                    int cx = x0 + col + k;
+                    if (wrap) { if (cx >= W) cx %= W; }
+                    else if (cx < 0 || cx >= W) continue;
+                    put_px(layer, row, cx, (uint16_t)cy, p[k]);
+                }
+                p += lit;
+            }
+            col += n;
+        }
+    }
+}
+
+void fx_sprite_blit(const fx_sprite_t *s, int x, int y, uint8_t bri, uint32_t flags)
+{
+    blit_impl(-1, s, x, y, bri, flags);
+}
+
+void fx_sprite_blit_layer(fx_layer_t layer, const fx_sprite_t *s, int x, int y, uint8_t bri, uint32_t flags)
+{
+    if ((int)layer < 0 || layer >= FX_LAYER_COUNT) return;
+    blit_impl((int)layer, s, x, y, bri, flags);
+}
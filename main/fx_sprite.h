@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "fx_canvas.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ * fx_sprite.h
+ *
+ * Зачем:
+ *   - Готовые картинки (лицо джинна, иконки, глифы громкости/яркости) вместо
+ *     попиксельного fx_canvas_set() в коде эффекта.
+ *
+ * Хранение:
+ *   - Пакет спрайтов лежит в data-разделе "gfx" (partitions_voice.csv), собирается
+ *     tools/fx_sprite_pack.py и шьётся отдельно от прошивки.
+ *   - fx_sprite_init() делает esp_partition_mmap() один раз: спрайты читаются прямо из
+ *     flash через кэш, без копии в RAM. Дескриптор fx_sprite_t — указатель внутрь mmap.
+ *
+ * Формат (little-endian):
+ *   pack:   "JSPK" u32 magic, u16 version, u16 count, u32 total_size,
+ *           count * { char name[12], u32 offset }          // offset от начала пакета
+ *   sprite: u8 w, u8 h, u8 pal_n (0 = 256), u8 flags,
+ *           pal_n * { r, g, b, a },                        // a=0 — прозрачный (color key)
+ *           h * u16 row_ofs,                               // от начала RLE-данных, верхняя строка первой
+ *           RLE: токен c; c & 0x80 -> повтор (c & 0x7F) + 1 раз следующего индекса,
+ *                иначе (c + 1) литеральных индексов.
+ *
+ * Отрисовка:
+ *   - (x, y) — левый нижний угол спрайта в координатах canvas (y=0 — низ лампы),
+ *     верхняя строка картинки попадает в y + h - 1.
+ *   - Клиппинг по обеим осям; FX_SPR_WRAP_X — по кругу цилиндра (x mod MATRIX_W).
+ *   - Пиксель: a=0 пропускается, a=255 заменяет, иначе lerp с фоном. bri масштабирует RGB.
+ *   - Вызовы — из anim task (эффект/оверлей), как и весь fx_canvas.
+ * ============================================================ */
+
+#ifndef FX_SPRITE_PART_LABEL
+#define FX_SPRITE_PART_LABEL    "gfx"
+#endif
+
+#define FX_SPRITE_NAME_LEN      12
+
+typedef struct fx_sprite_s fx_sprite_t;   // непрозрачный: данные в flash (mmap)
+
+typedef enum {
+    FX_SPR_NONE   = 0,
+    FX_SPR_WRAP_X = 1u << 0,   // x по кругу (цилиндр 16 px), иначе обрезка
+} fx_spr_flags_t;
+
+/* mmap раздела FX_SPRITE_PART_LABEL + проверка пакета.
+ * ESP_ERR_NOT_FOUND — раздела нет; ESP_ERR_INVALID_VERSION/SIZE — пакет битый/не залит.
+ * Без пакета fx_sprite_find() просто возвращает NULL. */
+esp_err_t fx_sprite_init(void);
+
+/* Подключить пакет из памяти (rodata/тест на хосте). Блоб должен жить, пока используется. */
+esp_err_t fx_sprite_attach(const void *pack, size_t size);
+
+uint16_t           fx_sprite_count(void);
+const fx_sprite_t *fx_sprite_at(uint16_t idx);
+const fx_sprite_t *fx_sprite_find(const char *name);
+
+uint8_t fx_sprite_w(const fx_sprite_t *s);
+uint8_t fx_sprite_h(const fx_sprite_t *s);
+
+/* В базу canvas */
+void fx_sprite_blit(const fx_sprite_t *s, int x, int y, uint8_t bri, uint32_t flags);
+
+/* В слой (оверлеи): альфа пикселя уходит в fx_layer_set(), смешивание — режимом слоя */
+void fx_sprite_blit_layer(fx_layer_t layer, const fx_sprite_t *s, int x, int y, uint8_t bri, uint32_t flags);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,248 @@
+#include "fx_transition.h"
+
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "fx_canvas.h"
+#include "fx_math.h"
+#include "matrix_ws2812.h"
+
+static const char *TAG = "FX_TRANS";
+
+_Static_assert((unsigned)FX_TRANS_MODE < FX_TRANS_MODE_COUNT, "FX_TRANS_MODE: fx_trans_mode_t");
+_Static_assert(FX_TRANS_MS >= 0 && FX_TRANS_MS <= 5000, "FX_TRANS_MS: 0..5000");
+
+#define TR_ENABLED          (FX_TRANS_MODE != FX_TRANS_CUT && FX_TRANS_MS != 0)
+
+/* ============================================================
+ * Буферы и состояние
+ *
+ * Кадры перехода (3 x 2304 B одним блоком, + 768 B порогов DISSOLVE) — из кучи при первой
+ * смене эффекта: с CUT модуль не занимает ни байта. Не освобождаются.
+ * ============================================================ */
+
+#define TR_ROW_BYTES        ((uint32_t)MATRIX_W * 3u)
+#define TR_BYTES            (TR_ROW_BYTES * (uint32_t)MATRIX_H)
+#define TR_DISSOLVE_BYTES   ((uint32_t)MATRIX_W * (uint32_t)MATRIX_H)
+
+/* Внутри блока выровнены на 4 (TR_BYTES кратен 4): mix_row идёт подряд по байтам */
+static uint8_t *s_out_frame = NULL;   // снимок уходящего
+static uint8_t *s_in_frame  = NULL;   // входящий, сведённый
+static uint8_t *s_mix       = NULL;   // результат -> present
+
+/* Порог DISSOLVE на пиксель: фиксированный хэш (не esp_random — одинаково от перехода к переходу) */
+static uint8_t *s_dissolve  = NULL;
+static bool     s_no_mem    = false;
+
+static bool     s_active = false;
+static uint32_t s_elapsed_ms = 0;
+static bool     s_mix_valid = false;   // s_mix — кадр, который сейчас на экране
+static bool     s_warm = false;        // кадр begin(): входящий прогревается, на экране — уходящий
+
+static fx_transition_stats_t s_st;
+
+static void dissolve_fill(void)
+{
+    for (uint32_t i = 0; i < TR_DISSOLVE_BYTES; i++) {
+        uint32_t h = i * 0x9E3779B1u;
+        h ^= h >> 15;
+        h *= 0x85EBCA77u;
+        h ^= h >> 13;
+        s_dissolve[i] = (uint8_t)(h >> 24);
+    }
+}
+
+/* Нет памяти — переходы выключаются до перезагрузки (смена эффекта жёсткая) */
+static bool bufs_ready(void)
+{
+    if (s_mix) return true;
+    if (s_no_mem) return false;
+
+    const uint32_t extra = (FX_TRANS_MODE == FX_TRANS_DISSOLVE) ? TR_DISSOLVE_BYTES : 0u;
+    uint8_t *p = (uint8_t *)heap_caps_malloc(3u * TR_BYTES + extra, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!p) {
+        ESP_LOGE(TAG, "no mem for transition frames (%u B), hard cuts", (unsigned)(3u * TR_BYTES + extra));
+        s_no_mem = true;
+        return false;
+    }
+
+    s_out_frame = p;
+    s_in_frame  = p + TR_BYTES;
+    s_mix       = p + 2u * TR_BYTES;
+    if (extra) {
+        s_dissolve = p + 3u * TR_BYTES;
+        dissolve_fill();
+    }
+    return true;
+}
+
+/* Прогресс 0..255 со smoothstep: мягкий старт и финиш */
+static uint8_t progress_q8(void)
+{
+    if (FX_TRANS_MS == 0) return 255;
+    uint32_t p = (s_elapsed_ms * 255u) / (uint32_t)FX_TRANS_MS;
+    if (p > 255u) p = 255u;
+    return (uint8_t)((p * p * (765u - 2u * p)) / 65025u);
+}
+
+/* ============================================================
+ * fx_engine
+ * ============================================================ */
+
+bool fx_transition_begin(bool *out_frozen)
+{
+    if (out_frozen) *out_frozen = false;
+
+    if (!TR_ENABLED || !bufs_ready()) {
+        s_active = false;
+        s_st.active = false;
+        return false;
+    }
+
+    // смена поверх незавершённого перехода: уходит то, что сейчас на экране
+    const bool restack = s_active && s_mix_valid;
+    if (restack) {
+        memcpy(s_out_frame, s_mix, TR_BYTES);
+        if (out_frozen) *out_frozen = true;
+    }
+
+    s_active = true;
+    s_elapsed_ms = 0;
+    s_mix_valid = false;
+    s_warm = true;
+
+    s_st.active = true;
+    s_st.mode = FX_TRANS_MODE;
+    s_st.progress = 0;
+    s_st.started++;
+
+    ESP_LOGI(TAG, "start mode=%u ms=%u%s", (unsigned)FX_TRANS_MODE, (unsigned)FX_TRANS_MS,
+             restack ? " (over previous)" : "");
+    return true;
+}
+
+bool fx_transition_active(void)
+{
+    return s_active;
+}
+
+void fx_transition_tick(uint32_t wall_dt_ms)
+{
+    if (!s_active) return;
+
+    if (wall_dt_ms > FX_TRANS_MAX_DT_MS) wall_dt_ms = FX_TRANS_MAX_DT_MS;
+    s_elapsed_ms += wall_dt_ms;
+
+    if (s_elapsed_ms >= (uint32_t)FX_TRANS_MS) {
+        s_active = false;
+        s_mix_valid = false;
+        s_warm = false;
+        s_st.active = false;
+        s_st.progress = 255;
+    }
+}
+
+void fx_transition_capture_out(const uint8_t *frame)
+{
+    fx_canvas_flatten(frame, s_out_frame);
+}
+
+void fx_transition_note_cost(uint32_t out_us, uint32_t in_us, uint8_t out_tier, bool downgraded)
+{
+    s_st.out_us = out_us;
+    s_st.in_us = in_us;
+    s_st.out_tier = out_tier;
+    s_st.frames++;
+    if (out_tier == FX_TRANS_OUT_FROZEN) s_st.frozen_frames++;
+    if (downgraded) s_st.out_downgrades++;
+}
+
+/* ============================================================
+ * Маски
+ * ============================================================ */
+
+/* d = lerp(a, b, t) по байтам строки */
+static void mix_row(const uint8_t *a, const uint8_t *b, uint8_t *d, uint8_t t)
+{
+    for (uint32_t i = 0; i < TR_ROW_BYTES; i++) {
+        d[i] = fx_lerp8(a[i], b[i], t);
+    }
+}
+
+static void mix_alpha(uint8_t p)
+{
+    for (uint32_t y = 0; y < MATRIX_H; y++) {
+        const uint32_t o = y * TR_ROW_BYTES;
+        mix_row(&s_out_frame[o], &s_in_frame[o], &s_mix[o], p);
+    }
+}
+
+/* Край идёт снизу вверх: строка y полностью новая, когда край выше неё на SOFT строк */
+static void mix_wipe(uint8_t p)
+{
+    const int32_t edge_q8 = (int32_t)p * (int32_t)(MATRIX_H + FX_TRANS_WIPE_SOFT);
+    for (uint32_t y = 0; y < MATRIX_H; y++) {
+        const int32_t a = fx_clamp_i32((edge_q8 - (int32_t)y * 256) / FX_TRANS_WIPE_SOFT, 0, 255);
+        const uint32_t o = y * TR_ROW_BYTES;
+        mix_row(&s_out_frame[o], &s_in_frame[o], &s_mix[o], (uint8_t)a);
+    }
+}
+
+/* Пиксель переключается, когда прогресс проходит его порог; SOFT — ширина рампы */
+static void mix_dissolve(uint8_t p)
+{
+    const int32_t e = ((int32_t)p * (256 + FX_TRANS_DISSOLVE_SOFT)) >> 8;
+    for (uint32_t i = 0; i < (uint32_t)MATRIX_W * MATRIX_H; i++) {
+        const int32_t a = fx_clamp_i32((e - (int32_t)s_dissolve[i]) * (256 / FX_TRANS_DISSOLVE_SOFT), 0, 255);
+        const uint32_t o = i * 3u;
+        s_mix[o + 0] = fx_lerp8(s_out_frame[o + 0], s_in_frame[o + 0], (uint8_t)a);
+        s_mix[o + 1] = fx_lerp8(s_out_frame[o + 1], s_in_frame[o + 1], (uint8_t)a);
+        s_mix[o + 2] = fx_lerp8(s_out_frame[o + 2], s_in_frame[o + 2], (uint8_t)a);
+    }
+}
+
+/* ============================================================
+ * matrix_anim
+ * ============================================================ */
+
+const uint8_t *fx_transition_compose(const uint8_t *frame)
+{
+    if (!s_active) return frame;
+
+    const int64_t t0 = esp_timer_get_time();
+
+    // слои входящего (HDR/частицы) потребляются в любом случае: в present их быть не должно
+    fx_canvas_flatten(frame, s_in_frame);
+
+    if (s_warm) {
+        // прогрев: первый (дорогой) кадр входящего не показывается и не смешивается
+        s_warm = false;
+        memcpy(s_mix, s_out_frame, TR_BYTES);
+        s_mix_valid = true;
+        s_st.progress = 0;
+        s_st.blend_us = (uint32_t)(esp_timer_get_time() - t0);
+        return s_mix;
+    }
+
+    const uint8_t p = progress_q8();
+    switch (FX_TRANS_MODE) {
+    case FX_TRANS_WIPE:     mix_wipe(p);     break;
+    case FX_TRANS_DISSOLVE: mix_dissolve(p); break;
+    case FX_TRANS_ALPHA:
+    default:                mix_alpha(p);    break;
+    }
+    s_mix_valid = true;
+
+    s_st.progress = p;
+    s_st.blend_us = (uint32_t)(esp_timer_get_time() - t0);
+    return s_mix;
+}
+
+void fx_transition_get_stats(fx_transition_stats_t *out)
+{
+    if (!out) return;
+    *out = s_st;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ * fx_transition.h
+ *
+ * Зачем:
+ *   - Смена эффекта (пульт, голос, ESPNOW) без "щелчка": в окне перехода рисуются оба
+ *     эффекта, кадр — смесь по маске. Дорогой первый кадр входящего (таблицы/reset FIRE)
+ *     рисуется на кадре begin() и не показывается: на экране снимок уходящего, без смешивания.
+ *
+ * Кто что делает:
+ *   - fx_engine: видит смену effect_id в render, зовёт fx_transition_begin(), дальше каждый кадр
+ *     рисует уходящий (свой банк canvas, своё anim-время, свой tier) -> fx_transition_capture_out(),
+ *     затем входящий (другой банк, anim с нуля — как и при жёсткой смене). На кадре begin()
+ *     входящий только прогревается: его стоимость не идёт в tier и в бюджет уходящего.
+ *   - matrix_anim: после fx_post_run() входящего — fx_transition_compose(): свести входящий
+ *     (база/post + HDR + частицы), смешать с кадром уходящего, результат — в present.
+ *   - Бюджет: если уходящий + входящий не влезают в бюджет render, fx_engine понижает tier
+ *     уходящего (по ступени за кадр), ниже FX_TIER_LOW — уходящий замораживается
+ *     (последний снимок, без render). Входящий всегда идёт своим tier.
+ *   - Повторная смена во время перехода: уходящим становится последний смешанный кадр
+ *     (заморожен), входящий — новый эффект. Без скачка картинки.
+ *
+ * Режим и длительность — compile-time (FX_TRANS_MODE, FX_TRANS_MS): пульт/голос/ESPNOW
+ * их не меняют, рантайм-настройки нет.
+ *
+ * Маски (прогресс с easing smoothstep, время — wall: в паузе переход тоже завершается):
+ *   - ALPHA:    равномерный cross-fade.
+ *   - WIPE:     новый эффект "поднимается" снизу вверх, мягкий край FX_TRANS_WIPE_SOFT строк.
+ *   - DISSOLVE: попиксельный порог из фиксированного хэша, мягкость FX_TRANS_DISSOLVE_SOFT.
+ *   - CUT:      переходов нет (жёсткая смена как раньше).
+ * ============================================================ */
+
+typedef enum {
+    FX_TRANS_CUT = 0,
+    FX_TRANS_ALPHA,
+    FX_TRANS_WIPE,
+    FX_TRANS_DISSOLVE,
+    FX_TRANS_MODE_COUNT
+} fx_trans_mode_t;
+
+/* Маска и окно перехода. FX_TRANS_CUT или 0 ms — жёсткая смена, буферы перехода не заводятся */
+#ifndef FX_TRANS_MODE
+#define FX_TRANS_MODE               FX_TRANS_ALPHA
+#endif
+#ifndef FX_TRANS_MS
+#define FX_TRANS_MS                 600     // 0..5000
+#endif
+
+/* Потолок wall_dt на кадр: после долгого кадра (SOFT OFF, лаг) переход не проскакивает целиком */
+#ifndef FX_TRANS_MAX_DT_MS
+#define FX_TRANS_MAX_DT_MS          100
+#endif
+
+#ifndef FX_TRANS_WIPE_SOFT
+#define FX_TRANS_WIPE_SOFT          4       // строк, степень двойки
+#endif
+#ifndef FX_TRANS_DISSOLVE_SOFT
+#define FX_TRANS_DISSOLVE_SOFT      32      // ед. порога 0..255, степень двойки
+#endif
+
+/* fx_transition_stats_t.out_tier: уходящий заморожен */
+#define FX_TRANS_OUT_FROZEN         0xFFu
+
+/* Телеметрия (writer — matrix_task; читать можно из любой задачи, как fx_tier_stats_t) */
+typedef struct {
+    bool     active;
+    uint8_t  mode;            // fx_trans_mode_t текущего/последнего перехода
+    uint8_t  progress;        // 0..255 (после easing)
+    uint8_t  out_tier;        // fx_tier_t уходящего или FX_TRANS_OUT_FROZEN
+    uint32_t out_us;          // последний кадр: уходящий (render + post + снимок), 0 — заморожен
+    uint32_t in_us;           // последний кадр: входящий (render)
+    uint32_t blend_us;        // последний кадр: сведение входящего + маска
+    uint32_t started;         // переходов всего
+    uint32_t frames;          // кадров в переходах всего
+    uint32_t out_downgrades;  // понижений tier уходящего
+    uint32_t frozen_frames;   // кадров с замороженным уходящим
+} fx_transition_stats_t;
+
+/* ---- fx_engine (matrix_task) ---- */
+
+/* Старт перехода. false — переходы выключены или нет памяти под кадры (жёсткая смена).
+ * *out_frozen = true — переход начат поверх незавершённого: уходящий — последний смешанный кадр,
+ * рисовать его не нужно. */
+bool fx_transition_begin(bool *out_frozen);
+bool fx_transition_active(void);
+/* Продвинуть прогресс на wall_dt_ms. Конец окна -> переход выключается (кадр — только входящий). */
+void fx_transition_tick(uint32_t wall_dt_ms);
+/* Снимок уходящего: frame — выход fx_post_run (NULL — база текущего банка) + HDR + частицы */
+void fx_transition_capture_out(const uint8_t *frame);
+/* Стоимость кадра перехода (для телеметрии), out_tier — FX_TRANS_OUT_FROZEN, если заморожен */
+void fx_transition_note_cost(uint32_t out_us, uint32_t in_us, uint8_t out_tier, bool downgraded);
+
+/* ---- matrix_anim ---- */
+
+/* Кадр для present: вне перехода — frame как есть (NULL — база), в переходе — смесь
+ * уходящего с входящим (frame/база + HDR + частицы) по маске; на кадре begin() — снимок уходящего. */
+const uint8_t *fx_transition_compose(const uint8_t *frame);
+
+void fx_transition_get_stats(fx_transition_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
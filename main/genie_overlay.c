@@ -3,14 +3,10 @@
 #include "esp_log.h"
 
 #include "doa_probe.h"
+#include "fx_canvas.h"
 #include "matrix_ws2812.h"
 
 
-/* NOTE: функция реализована в matrix_ws2812.c, но не объявлена в matrix_ws2812.h.
- * Минимально-инвазивно объявляем здесь. */
-extern void matrix_ws2812_set_pixel_xy(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b);
-
-
 static const char *TAG = "GENIE_OVR";
 
 static bool s_enabled = true;
@@ -74,7 +70,7 @@ void genie_overlay_render(uint32_t now_ms)
     uint8_t g = 60;
     uint8_t b = 120;
 
-    /* Рисуем поверх текущего кадра в canvas */
-    matrix_ws2812_set_pixel_xy((uint16_t)x, (uint16_t)y, r, g, b);
+    /* Рисуем в слой оверлея (REPLACE поверх эффекта), сводит fx_canvas_present() */
+    fx_layer_set(FX_LAYER_OVERLAY, (uint16_t)x, (uint16_t)y, r, g, b, 255);
 
 }
@@ -11,7 +11,7 @@ void genie_overlay_init(void);
 void genie_overlay_set_enabled(bool en);
 bool genie_overlay_is_enabled(void);
 
-/* Дорисовать оверлей в текущий canvas/буфер. Вызывать из anim task. */
+/* Дорисовать оверлей в слой FX_LAYER_OVERLAY (сводится в fx_canvas_present()). Вызывать из anim task. */
 void genie_overlay_render(uint32_t now_ms);
 
 #ifdef __cplusplus
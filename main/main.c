@@ -46,6 +46,8 @@
 #include "voice_fsm.h"
 #include "wake_wakenet.h"
 #include "genie_overlay.h"
+#include "fx_sprite.h"
+#include "fx_clip.h"
 
 
 
@@ -421,6 +423,10 @@ void app_main(void)
         ESP_LOGI(TAG, "Starting matrix WS2812 on GPIO=%d", MATRIX_DATA_GPIO);
         ESP_ERROR_CHECK(matrix_ws2812_init(MATRIX_DATA_GPIO));
 
+        /* Спрайты (gfx) и клипы (anim) — mmap. Нет пакета — эффекты/оверлеи работают без них. */
+        (void)fx_sprite_init();
+        (void)fx_clip_init();
+
         ESP_LOGI(TAG, "Starting matrix ANIM");
         matrix_anim_start();
     }
@@ -1,7 +1,12 @@
 #include "matrix_anim.h"
+#include "matrix_anim_stats.h"
 
 #include "matrix_ws2812.h"
 #include "fx_engine.h"
+#include "fx_registry.h"
+#include "fx_canvas.h"
+#include "fx_post.h"
+#include "fx_transition.h"
 #include "genie_overlay.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -16,12 +21,55 @@
  * Configuration
  * ============================================================ */
 
+/*
+ * Production default = 22 FPS (см. docs/architecture.md, FPS policy).
+ * С конвейером render/show (double buffer в matrix_ws2812) нижний предел кадра —
+ * время передачи (~22.5 ms на 768 LED), а не render+show, т.е. потолок ~40 FPS.
+ */
+#ifndef MATRIX_ANIM_FPS
 #define MATRIX_ANIM_FPS            22
-#define MATRIX_ANIM_FRAME_MS       (1000 / MATRIX_ANIM_FPS)
+#endif
+#define MATRIX_ANIM_FRAME_US       (1000000 / MATRIX_ANIM_FPS)
+
+/*
+ * Frame clock: esp_timer one-shot с абсолютными дедлайнами (us) + task notify.
+ * vTaskDelayUntil при CONFIG_FREERTOS_HZ=100 квантовал период до 10 ms
+ * (pdMS_TO_TICKS(45) = 4 тика = 40 ms, т.е. ~25 FPS вместо 22).
+ * Дедлайн N+1 = дедлайн N + период (ошибка пробуждения не накапливается);
+ * если дедлайн уже прошёл — слот пропускается (drop), сетка дедлайнов не сдвигается.
+ */
+
+/*
+ * Frame-rate governor: период кадра выбирается на лету под текущий эффект.
+ *   - fx_desc_t.fps_pref/fps_min (0 = MATRIX_ANIM_FPS);
+ *   - EWMA стоимости кадра -> FPS, при котором core 1 загружен
+ *     не больше MATRIX_ANIM_CPU_LOAD_PCT; результат зажат в [fps_min, fps_pref];
+ *   - вниз — сразу, вверх — по +1 FPS раз в MATRIX_ANIM_GOV_UP_FRAMES кадров (гистерезис);
+ *   - стоимость = render + post + переход + overlay + выходной каскад submit; ожидание fence
+ *     (линия ещё передаёт кадр N) — не CPU и в стоимость не входит, иначе тяжёлый эффект
+ *     на пределе линии (~23 ms) выглядел бы дороже и governor срезал бы FPS ниже 40;
+ *   - pause: fps_min (кадр статичный, драйвер всё равно пропускает одинаковые кадры);
+ *   - потолок MATRIX_ANIM_FPS_MAX: передача 768 LED ~23 ms.
+ */
+#ifndef MATRIX_ANIM_FPS_MAX
+#define MATRIX_ANIM_FPS_MAX        40
+#endif
+#ifndef MATRIX_ANIM_CPU_LOAD_PCT
+#define MATRIX_ANIM_CPU_LOAD_PCT   60
+#endif
+#define MATRIX_ANIM_GOV_UP_FRAMES  16u
+#define MATRIX_ANIM_GOV_EWMA_SHIFT 3     // alpha = 1/8
+
+/* Safety: если тик таймера потерялся, кадр всё равно будет (self-heal) */
+#define MATRIX_ANIM_TICK_TIMEOUT_MS 200u
+
+/* Сколько ждём окончания последней передачи при остановке таска */
+#define MATRIX_ANIM_STOP_FENCE_MS  100u
 
 /* Task notify bits */
 #define ANIM_NOTIFY_STOP_REQUEST   (1u << 0)
 #define ANIM_NOTIFY_STOPPED_ACK    (1u << 1)
+#define ANIM_NOTIFY_FRAME_TICK     (1u << 2)
 
 /*
  * Enable performance logs (ANIM_PERF + ANIM_SYS).
@@ -31,6 +79,9 @@
 #define J_MATRIX_ANIM_PERF_DEBUG   0
 #endif
 
+/* PERF: сколько интервалов кадра храним за окно для p50/p99 */
+#define MATRIX_ANIM_PERF_IV_MAX    128
+
 /* ============================================================
  * Internal state
  * ============================================================ */
@@ -46,6 +97,130 @@ static uint32_t s_anim_ms = 0;
 static uint16_t s_last_effect_id = 0;
 static bool s_paused = false; // legacy mirror (not a source of truth)
 
+static esp_timer_handle_t s_frame_timer = NULL;
+static int64_t s_next_deadline_us = 0;
+
+// governor
+static int32_t  s_period_us   = MATRIX_ANIM_FRAME_US;
+static uint8_t  s_fps_cur     = MATRIX_ANIM_FPS;
+static int32_t  s_cost_ewma_us = 0;
+static uint32_t s_gov_up_cnt  = 0;
+static uint32_t s_drop_cnt    = 0;   // пропущенные дедлайны (монотонный)
+
+/* ============================================================
+ * Frame clock
+ * ============================================================ */
+
+static void frame_timer_cb(void *arg)
+{
+    (void)arg;
+    TaskHandle_t t = s_task;
+    if (t) {
+        xTaskNotify(t, ANIM_NOTIFY_FRAME_TICK, eSetBits);
+    }
+}
+
+// Следующий абсолютный дедлайн + взвод one-shot. Возвращает дедлайн.
+static int64_t frame_clock_arm_next(int64_t now_us)
+{
+    s_next_deadline_us += s_period_us;
+
+    // перегрузка: прошедшие дедлайны пропускаем (drop), а не сдвигаем расписание
+    if (s_next_deadline_us <= now_us) {
+        const int64_t late = now_us - s_next_deadline_us;
+        const int64_t n = late / s_period_us + 1;
+        s_next_deadline_us += n * s_period_us;
+        s_drop_cnt += (uint32_t)n;
+    }
+
+    const int64_t delay_us = s_next_deadline_us - now_us;
+
+    (void)esp_timer_stop(s_frame_timer);
+    (void)esp_timer_start_once(s_frame_timer, (uint64_t)delay_us);
+    return s_next_deadline_us;
+}
+
+static void frame_clock_delete(void)
+{
+    if (s_frame_timer) {
+        (void)esp_timer_stop(s_frame_timer);
+        (void)esp_timer_delete(s_frame_timer);
+        s_frame_timer = NULL;
+    }
+}
+
+// fps_pref эффекта (0 = MATRIX_ANIM_FPS), зажатый в MATRIX_ANIM_FPS_MAX
+static int32_t fps_pref_of(const fx_desc_t *d)
+{
+    int32_t pref = (d && d->fps_pref) ? d->fps_pref : MATRIX_ANIM_FPS;
+    if (pref > MATRIX_ANIM_FPS_MAX) pref = MATRIX_ANIM_FPS_MAX;
+    return pref;
+}
+
+// Новый эффект: стартуем с его fps_pref (get_fps() сразу отдаёт реальное значение, не 0)
+static void fps_governor_reset(uint16_t effect_id)
+{
+    s_cost_ewma_us = 0;
+    s_gov_up_cnt = 0;
+    s_fps_cur = (uint8_t)fps_pref_of(fx_registry_get(effect_id));
+}
+
+// Выбрать FPS кадра N+1 по стоимости кадра N
+static void fps_governor_update(uint16_t effect_id, bool paused, int32_t cost_us)
+{
+    const fx_desc_t *d = fx_registry_get(effect_id);
+
+    const int32_t pref = fps_pref_of(d);
+    int32_t fmin = (d && d->fps_min) ? d->fps_min : pref;
+    if (fmin > pref) fmin = pref;
+    if (fmin < 1) fmin = 1;
+
+    if (s_cost_ewma_us == 0) {
+        s_cost_ewma_us = cost_us;
+    } else {
+        s_cost_ewma_us += (cost_us - s_cost_ewma_us) >> MATRIX_ANIM_GOV_EWMA_SHIFT;
+    }
+
+    int32_t target = pref;
+    if (paused) {
+        target = fmin;
+    } else if (s_cost_ewma_us > 0) {
+        const int32_t fps_load = (MATRIX_ANIM_CPU_LOAD_PCT * 10000) / s_cost_ewma_us;
+        if (fps_load < target) target = fps_load;
+        if (target < fmin) target = fmin;
+    }
+
+    if (target < s_fps_cur) {
+        s_fps_cur = (uint8_t)target;
+        s_gov_up_cnt = 0;
+    } else if (target > s_fps_cur) {
+        if (++s_gov_up_cnt >= MATRIX_ANIM_GOV_UP_FRAMES) {
+            s_fps_cur++;
+            s_gov_up_cnt = 0;
+        }
+    } else {
+        s_gov_up_cnt = 0;
+    }
+
+    s_period_us = 1000000 / (int32_t)s_fps_cur;
+}
+
+#if J_MATRIX_ANIM_PERF_DEBUG
+static void perf_sort_i32(int32_t *a, uint32_t n)
+{
+    // insertion sort: n <= MATRIX_ANIM_PERF_IV_MAX, раз в секунду
+    for (uint32_t i = 1; i < n; i++) {
+        const int32_t v = a[i];
+        uint32_t j = i;
+        while (j > 0 && a[j - 1u] > v) {
+            a[j] = a[j - 1u];
+            j--;
+        }
+        a[j] = v;
+    }
+}
+#endif
+
 /* ============================================================
  * Animation task
  * ============================================================ */
@@ -69,7 +244,25 @@ static void matrix_task(void *arg)
     s_anim_ms = 0;
     s_last_effect_id = fx_engine_get_effect();
 
-    TickType_t last_wake = xTaskGetTickCount();
+    // frame clock: первый кадр сразу, дальше по абсолютным дедлайнам
+    const esp_timer_create_args_t targs = {
+        .callback = frame_timer_cb,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "anim_frame",
+        .skip_unhandled_events = true,
+    };
+    if (esp_timer_create(&targs, &s_frame_timer) != ESP_OK) {
+        ESP_LOGE(TAG, "frame timer create failed");
+        s_frame_timer = NULL;
+        s_task = NULL;
+        vTaskDelete(NULL);
+        return;
+    }
+    s_next_deadline_us = esp_timer_get_time();
+    s_period_us = MATRIX_ANIM_FRAME_US;
+    fps_governor_reset(fx_engine_get_effect());
+    (void)xTaskNotify(xTaskGetCurrentTaskHandle(), ANIM_NOTIFY_FRAME_TICK, eSetBits);
 
 #if J_MATRIX_ANIM_PERF_DEBUG
     // PERF window accumulators (1-second window)
@@ -81,15 +274,47 @@ static void matrix_task(void *arg)
     int32_t s_s_min =  1000000000, s_s_max = 0, s_s_sum = 0;
     int32_t s_t_min =  1000000000, s_t_max = 0, s_t_sum = 0;
 
+    // pipeline: время передачи кадра (RMT) и сколько из него спрятано за render
+    int32_t s_tx_sum = 0;
+    int32_t s_ovl_sum = 0;
+    int32_t s_saved_sum = 0;  // время линии, сэкономленное truncated refresh/elision
+
+    // post-processing: сумма/число кадров/превышения бюджета по проходам
+    int32_t  s_post_sum[FX_POST_PASS_COUNT] = { 0 };
+    uint32_t s_post_n[FX_POST_PASS_COUNT] = { 0 };
+    uint32_t s_post_over[FX_POST_PASS_COUNT] = { 0 };
+
+    // переходы: кадры окна, где рисовались оба эффекта (render обоих + post + сведение)
+    uint32_t s_tr_frames = 0, s_tr_miss = 0;
+    int32_t  s_tr_sum = 0, s_tr_max = 0;
+
+    // static-frame elision: счётчики драйвера на начало окна
+    uint32_t s_sent0 = 0, s_skip0 = 0;
+    matrix_ws2812_get_frame_counters(&s_sent0, &s_skip0);
+    uint32_t s_skip_last = s_skip0;
+
+    uint32_t s_drop0 = s_drop_cnt;  // governor: пропущенные дедлайны на начало окна
+
     int64_t s_sys_last_us = 0;
+
+    // frame clock: интервалы между стартами кадров (jitter)
+    int32_t  s_iv[MATRIX_ANIM_PERF_IV_MAX];
+    uint32_t s_iv_n = 0;
+    int64_t  s_last_tick_us = 0;
 #endif
 
     while (1) {
-        // stop request (non-blocking poll)
+        // ждём тик frame clock или stop (оба — биты task notify)
         uint32_t notif = 0;
-        (void)xTaskNotifyWait(0, UINT32_MAX, &notif, 0);
+        (void)xTaskNotifyWait(0, UINT32_MAX, &notif, pdMS_TO_TICKS(MATRIX_ANIM_TICK_TIMEOUT_MS));
 
         if (notif & ANIM_NOTIFY_STOP_REQUEST) {
+            frame_clock_delete();
+
+            // Последний submit() мог ещё идти в линию: ждём fence до ACK,
+            // чтобы вызывающий гасил DATA/MOSFET уже после передачи.
+            (void)matrix_ws2812_wait_done(MATRIX_ANIM_STOP_FENCE_MS);
+
             if (s_waiter_task) {
                 xTaskNotify(s_waiter_task, ANIM_NOTIFY_STOPPED_ACK, eSetBits);
             }
@@ -107,10 +332,12 @@ static void matrix_task(void *arg)
         s_paused = paused; // keep mirror for legacy/debug
 
         // If effect changed -> reset anim time per spec
+        // id снимается один раз за кадр: anim-сброс, render и post — для одного и того же эффекта
         const uint16_t cur_fx = fx_engine_get_effect();
         if (cur_fx != s_last_effect_id) {
             s_last_effect_id = cur_fx;
             s_anim_ms = 0;
+            fps_governor_reset(cur_fx);
         }
 
         // speed_pct scales anim-time (master clock)
@@ -125,33 +352,92 @@ static void matrix_task(void *arg)
             s_anim_ms += anim_dt_ms;
         }
 
+        // следующий тик взводим до render: таймер идёт параллельно с кадром
+        const int64_t t_tick_us = esp_timer_get_time();
+        (void)frame_clock_arm_next(t_tick_us);
+
 #if J_MATRIX_ANIM_PERF_DEBUG
-        const int64_t t_frame_start_us = esp_timer_get_time();
+        const int64_t t_frame_start_us = t_tick_us;
+
+        if (s_last_tick_us != 0 && s_iv_n < MATRIX_ANIM_PERF_IV_MAX) {
+            s_iv[s_iv_n++] = (int32_t)(t_tick_us - s_last_tick_us);
+        }
+        s_last_tick_us = t_tick_us;
 #endif
 
-// render + show (single path per frame)
-fx_engine_render(s_wall_ms, wall_dt_ms, s_anim_ms, anim_dt_ms);
+        // render кадра N+1 идёт, пока кадр N ещё уходит в линию (RMT/DMA)
+        fx_engine_set_frame_budget_us((uint32_t)s_period_us);
+        fx_engine_render(cur_fx, s_wall_ms, wall_dt_ms, s_anim_ms, anim_dt_ms);
 
-genie_overlay_render(s_wall_ms);
+        const int64_t t_after_fx_us = esp_timer_get_time();
 
+        // post-processing эффекта (blur/bloom/grade): над базой, до оверлеев
+        const fx_desc_t *fxd = fx_registry_get(cur_fx);
+        fx_post_timing_t post_t;
+        const uint8_t *frame = fx_post_run(fxd ? fxd->post : NULL, fx_engine_get_tier(), &post_t);
+
+        // переход между эффектами: смесь с кадром уходящего (вне перехода — кадр post как есть)
+        const bool in_trans = fx_transition_active();
+        fx_canvas_present_source(fx_transition_compose(frame));
+
+        const int64_t t_after_post_us = esp_timer_get_time();
+
+        genie_overlay_render(s_wall_ms);
+
+        // композитинг: база canvas + слои (частицы, оверлеи) -> back-буфер WS2812, один проход
+        fx_canvas_present();
 
-#if J_MATRIX_ANIM_PERF_DEBUG
         const int64_t t_after_render_us = esp_timer_get_time();
-#endif
 
-        const esp_err_t err = matrix_ws2812_show();
+        // submit: ждёт fence кадра N, отправляет N+1 и сразу возвращается
+        const esp_err_t err = matrix_ws2812_submit();
         if (err != ESP_OK) {
-            ESP_LOGW(TAG, "matrix show failed: %s", esp_err_to_name(err));
+            ESP_LOGW(TAG, "matrix submit failed: %s", esp_err_to_name(err));
         }
 
+        // governor: стоимость кадра без ожидания fence (render+post+переход+overlay+выходной каскад)
+        const int64_t t_frame_done_us = esp_timer_get_time();
+        const int64_t fence_us = (int64_t)matrix_ws2812_get_last_fence_us();
+        const int64_t cost_us = (t_frame_done_us - t_tick_us) - fence_us;
+        fps_governor_update(cur_fx, paused, (int32_t)cost_us);
+
+        // always-on stats (дёшево: несколько инкрементов; читатели — через seqlock matrix_anim_stats)
+        matrix_anim_stats_record(cur_fx, cost_us > (int64_t)s_period_us, s_drop_cnt, t_tick_us,
+                                 t_after_fx_us - t_tick_us,
+                                 &post_t,
+                                 in_trans ? (t_after_post_us - t_tick_us) : -1,
+                                 t_after_render_us - t_after_post_us,
+                                 (t_frame_done_us - t_after_render_us) - fence_us,
+                                 fence_us);
+
 #if J_MATRIX_ANIM_PERF_DEBUG
-        const int64_t t_after_show_us = esp_timer_get_time();
+        const int64_t t_after_show_us = t_frame_done_us;
 
         // ---- PERF stats (1 second window) ----
         const int32_t render_us = (int32_t)(t_after_render_us - t_frame_start_us);
-        const int32_t show_us   = (int32_t)(t_after_show_us - t_after_render_us);
+        const int32_t show_us   = (int32_t)(t_after_show_us - t_after_render_us); // fence wait + swap
         const int32_t total_us  = render_us + show_us;
-        const int32_t budget_us = (int32_t)MATRIX_ANIM_FRAME_MS * 1000;
+        // промах бюджета — по работе кадра: ожидание fence (передача прошлого кадра) не наша стоимость,
+        // как и в cost_us для governor/stats
+        const int32_t work_us   = total_us - (int32_t)fence_us;
+        const int32_t budget_us = s_period_us;
+
+        // tx предыдущего кадра шёл параллельно с render: спрятанная часть = tx - ожидание fence
+        // (avg считаем по отправленным кадрам: при elision линия молчит)
+        const int32_t tx_us  = (int32_t)matrix_ws2812_get_last_tx_us();
+        int32_t ovl_us = tx_us - (int32_t)fence_us;
+        if (ovl_us < 0) ovl_us = 0;
+
+        uint32_t sent_cnt = 0, skip_cnt = 0;
+        matrix_ws2812_get_frame_counters(&sent_cnt, &skip_cnt);
+        const uint32_t w_sent = sent_cnt - s_sent0;
+        const uint32_t w_skip = skip_cnt - s_skip0;
+        if (skip_cnt == s_skip_last) {
+            s_tx_sum  += tx_us;
+            s_ovl_sum += ovl_us;
+        }
+        s_skip_last = skip_cnt;
+        s_saved_sum += (int32_t)matrix_ws2812_get_last_saved_us();
 
         s_frames++;
 
@@ -167,7 +453,22 @@ genie_overlay_render(s_wall_ms);
         if (total_us > s_t_max) s_t_max = total_us;
         s_t_sum += total_us;
 
-        if (total_us > budget_us) s_miss++;
+        if (work_us > budget_us) s_miss++;
+
+        for (uint32_t i = 0; i < FX_POST_PASS_COUNT; i++) {
+            if (!(post_t.ran & (1u << i))) continue;
+            s_post_sum[i] += (int32_t)post_t.us[i];
+            s_post_n[i]++;
+            if (post_t.us[i] > fx_post_budget_us((fx_post_pass_t)i)) s_post_over[i]++;
+        }
+
+        if (in_trans) {
+            const int32_t tr_us = (int32_t)(t_after_post_us - t_frame_start_us);
+            s_tr_frames++;
+            s_tr_sum += tr_us;
+            if (tr_us > s_tr_max) s_tr_max = tr_us;
+            if (work_us > budget_us) s_tr_miss++;
+        }
 
         if (t_after_show_us - s_prof_last_us >= 1000000) {
             s_prof_last_us = t_after_show_us;
@@ -175,14 +476,53 @@ genie_overlay_render(s_wall_ms);
             const int32_t r_avg = (s_frames ? (s_r_sum / (int32_t)s_frames) : 0);
             const int32_t s_avg = (s_frames ? (s_s_sum / (int32_t)s_frames) : 0);
             const int32_t t_avg = (s_frames ? (s_t_sum / (int32_t)s_frames) : 0);
+            const int32_t tx_avg  = (w_sent ? (s_tx_sum / (int32_t)w_sent) : 0);
+            const int32_t ovl_avg = (w_sent ? (s_ovl_sum / (int32_t)w_sent) : 0);
+            const int32_t saved_avg = (s_frames ? (s_saved_sum / (int32_t)s_frames) : 0);
+
+            int32_t post_avg[FX_POST_PASS_COUNT];
+            uint32_t post_over = 0;
+            for (uint32_t i = 0; i < FX_POST_PASS_COUNT; i++) {
+                post_avg[i] = s_post_n[i] ? (s_post_sum[i] / (int32_t)s_post_n[i]) : 0;
+                post_over += s_post_over[i];
+            }
+
+            // переход: последний кадр по частям (out/in/blend) и tier уходящего
+            fx_transition_stats_t trs;
+            fx_transition_get_stats(&trs);
+            const int32_t tr_avg = (s_tr_frames ? (s_tr_sum / (int32_t)s_tr_frames) : 0);
+
+            // cost tier (fx_engine): текущий уровень и гистерезис
+            fx_tier_stats_t ts;
+            fx_engine_get_tier_stats(&ts);
+
+            // jitter интервала кадра: p50/p99 по окну
+            int32_t iv_p50 = 0, iv_p99 = 0;
+            if (s_iv_n > 0) {
+                perf_sort_i32(s_iv, s_iv_n);
+                iv_p50 = s_iv[(s_iv_n - 1u) / 2u];
+                iv_p99 = s_iv[((s_iv_n - 1u) * 99u) / 100u];
+            }
 
             ESP_LOGI("ANIM_PERF",
-                     "fps=%u budget=%dus frames=%u miss=%u | render us min/avg/max=%d/%d/%d | show us min/avg/max=%d/%d/%d | total us min/avg/max=%d/%d/%d",
-                     (unsigned)MATRIX_ANIM_FPS,
+                     "fps=%u budget=%dus frames=%u miss=%u drop=%u cost ewma us=%d | render us min/avg/max=%d/%d/%d | show us min/avg/max=%d/%d/%d | total us min/avg/max=%d/%d/%d | tx us avg=%d overlap us avg=%d | sent=%u skipped=%u wire saved us avg=%d | interval us p50/p99=%d/%d | post us avg blur/bloom/grade=%d/%d/%d over=%u | trans frames=%u miss=%u us avg/max=%d/%d last out/in/blend us=%u/%u/%u out_tier=%u | tier=%u score=%u ok=%u/%u down/up=%u/%u",
+                     (unsigned)s_fps_cur,
                      (int)budget_us, (unsigned)s_frames, (unsigned)s_miss,
+                     (unsigned)(s_drop_cnt - s_drop0), (int)s_cost_ewma_us,
                      (int)s_r_min, (int)r_avg, (int)s_r_max,
                      (int)s_s_min, (int)s_avg, (int)s_s_max,
-                     (int)s_t_min, (int)t_avg, (int)s_t_max);
+                     (int)s_t_min, (int)t_avg, (int)s_t_max,
+                     (int)tx_avg, (int)ovl_avg,
+                     (unsigned)w_sent, (unsigned)w_skip, (int)saved_avg,
+                     (int)iv_p50, (int)iv_p99,
+                     (int)post_avg[FX_POST_PASS_BLUR], (int)post_avg[FX_POST_PASS_BLOOM],
+                     (int)post_avg[FX_POST_PASS_GRADE], (unsigned)post_over,
+                     (unsigned)s_tr_frames, (unsigned)s_tr_miss, (int)tr_avg, (int)s_tr_max,
+                     (unsigned)trs.out_us, (unsigned)trs.in_us, (unsigned)trs.blend_us,
+                     (unsigned)trs.out_tier,
+                     (unsigned)ts.tier, (unsigned)ts.miss_score,
+                     (unsigned)ts.ok_streak, (unsigned)ts.up_hold,
+                     (unsigned)ts.downgrades, (unsigned)ts.upgrades);
 
             // reset window
             s_frames = 0;
@@ -190,6 +530,18 @@ genie_overlay_render(s_wall_ms);
             s_r_min = s_s_min = s_t_min = 1000000000;
             s_r_max = s_s_max = s_t_max = 0;
             s_r_sum = s_s_sum = s_t_sum = 0;
+            s_tx_sum = s_ovl_sum = s_saved_sum = 0;
+            s_iv_n = 0;
+            s_tr_frames = s_tr_miss = 0;
+            s_tr_sum = s_tr_max = 0;
+            for (uint32_t i = 0; i < FX_POST_PASS_COUNT; i++) {
+                s_post_sum[i] = 0;
+                s_post_n[i] = 0;
+                s_post_over[i] = 0;
+            }
+            s_drop0 = s_drop_cnt;
+            s_sent0 = sent_cnt;
+            s_skip0 = skip_cnt;
         }
 
         // ---- SYS stats (5 seconds) ----
@@ -205,8 +557,6 @@ genie_overlay_render(s_wall_ms);
                      (unsigned)heap_free, (unsigned)heap_min, (unsigned)hwm_words);
         }
 #endif
-
-        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(MATRIX_ANIM_FRAME_MS));
     }
 
     // task is exiting
@@ -277,8 +627,12 @@ void matrix_anim_stop_and_wait(void)
     }
 
     ESP_LOGW(TAG, "stop_and_wait timeout -> force delete");
-    vTaskDelete(t);
+    // Порядок важен: сначала обнулить handle (frame_timer_cb больше не будит таск), затем удалить
+    // таск — он мог быть внутри frame_clock_arm_next() и перевзвести таймер; таймер удаляем последним,
+    // когда его уже никто не трогает.
     s_task = NULL;
+    vTaskDelete(t);
+    frame_clock_delete();
 }
 
 void matrix_anim_pause_toggle(void)
@@ -292,3 +646,13 @@ bool matrix_anim_is_paused(void)
 {
     return fx_engine_get_paused();
 }
+
+uint8_t matrix_anim_get_fps(void)
+{
+    return s_fps_cur;
+}
+
+bool matrix_anim_get_stats(matrix_anim_stats_t *out)
+{
+    return matrix_anim_stats_read(out);
+}
@@ -3,10 +3,54 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "fx_post.h"   // FX_POST_PASS_COUNT
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* ============================================================
+ * Always-on frame timing stats (production, без PERF-сборки)
+ * ============================================================ */
+
+/* log2-гистограмма в us: bucket 0 = [0..1], bucket k = [2^k .. 2^(k+1)-1],
+ * последний bucket — всё, что >= 2^(N-1) us (~131 ms). */
+#define MATRIX_ANIM_HIST_BUCKETS   18
+
+/* Сколько разных effect_id помним для счётчиков промахов */
+#define MATRIX_ANIM_STATS_FX_MAX   16
+
+typedef struct {
+    uint32_t b[MATRIX_ANIM_HIST_BUCKETS];
+} matrix_anim_hist_t;
+
+typedef struct {
+    uint16_t effect_id;   // 0 = свободный слот
+    uint32_t frames;
+    uint32_t misses;      // стоимость кадра (без ожидания fence) не уложилась в период
+} matrix_anim_fx_stats_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t misses;
+    uint32_t drops;       // пропущенные дедлайны frame clock
+
+    matrix_anim_hist_t render;    // fx_engine_render
+    matrix_anim_hist_t post[FX_POST_PASS_COUNT];  // fx_post по проходам (только кадры, где проход был)
+    uint32_t           post_over[FX_POST_PASS_COUNT]; // проход дольше fx_post_budget_us()
+    matrix_anim_hist_t overlay;   // genie_overlay_render + fx_canvas_present (композитинг слоёв)
+    matrix_anim_hist_t show;      // matrix_ws2812_submit без ожидания fence (output stage + запуск RMT)
+    matrix_anim_hist_t fence;     // ожидание fence кадра N в submit (время линии, не CPU)
+    matrix_anim_hist_t interval;  // между стартами кадров
+
+    // переходы между эффектами (fx_transition): кадры, где рисовались оба эффекта
+    matrix_anim_hist_t transition;  // render обоих + post + сведение (до overlay)
+    uint32_t           trans_frames;
+    uint32_t           trans_misses;
+
+    matrix_anim_fx_stats_t fx[MATRIX_ANIM_STATS_FX_MAX];
+} matrix_anim_stats_t;
+
 /**
  * @brief Start matrix animation task.
  *
@@ -47,6 +91,24 @@ void matrix_anim_pause_toggle(void);
  */
 bool matrix_anim_is_paused(void);
 
+/**
+ * @brief Current frame rate chosen by the frame-rate governor.
+ *
+ * Depends on the active effect (fx_desc_t.fps_pref/fps_min), pause state
+ * and measured frame cost (render..output stage, fence wait excluded).
+ * 0 until the first frame is rendered.
+ */
+uint8_t matrix_anim_get_fps(void);
+
+/**
+ * @brief Snapshot of always-on frame timing stats (since boot).
+ *
+ * Lock-free: the animation task is the only writer (seqlock), any task may read.
+ * Returns false if a consistent snapshot could not be taken (writer kept
+ * updating during every retry) — caller may simply try again later.
+ */
+bool matrix_anim_get_stats(matrix_anim_stats_t *out);
+
 #ifdef __cplusplus
 }
 #endif
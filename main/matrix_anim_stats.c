@@ -0,0 +1,94 @@
+#include "matrix_anim_stats.h"
+
+/*
+ * matrix_anim_stats.c
+ *
+ * Seqlock:
+ *   - writer: seq++ (нечётный) -> release fence -> обновление полей -> release fence -> seq++ (чётный);
+ *   - reader: seq0 (acquire, нечётный -> повтор) -> копия -> acquire fence -> seq == seq0 ? ок : повтор.
+ * Writer один (matrix_task), поэтому seq++ без RMW-атомика.
+ */
+
+#include <stddef.h>   // NULL
+
+#include "fx_post.h"
+
+#define MATRIX_ANIM_STATS_READ_RETRIES  8
+
+static matrix_anim_stats_t s_stats;
+static volatile uint32_t   s_stats_seq = 0;   // нечётный = writer внутри обновления
+static int64_t             s_stats_last_tick_us = 0;
+
+static inline void hist_add(matrix_anim_hist_t *h, int64_t us)
+{
+    h->b[matrix_anim_hist_bucket(us > 0 ? (uint32_t)us : 0u)]++;
+}
+
+static matrix_anim_fx_stats_t *stats_fx_slot(uint16_t effect_id)
+{
+    for (uint32_t i = 0; i < MATRIX_ANIM_STATS_FX_MAX; i++) {
+        matrix_anim_fx_stats_t *e = &s_stats.fx[i];
+        if (e->effect_id == effect_id) return e;
+        if (e->effect_id == 0) {
+            e->effect_id = effect_id;
+            return e;
+        }
+    }
+    return NULL;  // таблица полна: общие счётчики всё равно идут
+}
+
+void matrix_anim_stats_record(uint16_t effect_id, bool miss, uint32_t drops, int64_t t_tick_us,
+                              int64_t render_us, const fx_post_timing_t *post,
+                              int64_t trans_us, int64_t overlay_us, int64_t show_us, int64_t fence_us)
+{
+    __atomic_store_n(&s_stats_seq, s_stats_seq + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    s_stats.frames++;
+    if (miss) s_stats.misses++;
+    s_stats.drops = drops;
+
+    hist_add(&s_stats.render, render_us);
+    for (uint32_t i = 0; post && i < FX_POST_PASS_COUNT; i++) {
+        if (!(post->ran & (1u << i))) continue;
+        hist_add(&s_stats.post[i], post->us[i]);
+        if (post->us[i] > fx_post_budget_us((fx_post_pass_t)i)) s_stats.post_over[i]++;
+    }
+    if (trans_us >= 0) {
+        hist_add(&s_stats.transition, trans_us);
+        s_stats.trans_frames++;
+        if (miss) s_stats.trans_misses++;
+    }
+    hist_add(&s_stats.overlay, overlay_us);
+    hist_add(&s_stats.show, show_us);
+    hist_add(&s_stats.fence, fence_us);
+    if (s_stats_last_tick_us != 0) {
+        hist_add(&s_stats.interval, t_tick_us - s_stats_last_tick_us);
+    }
+    s_stats_last_tick_us = t_tick_us;
+
+    matrix_anim_fx_stats_t *e = stats_fx_slot(effect_id);
+    if (e) {
+        e->frames++;
+        if (miss) e->misses++;
+    }
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&s_stats_seq, s_stats_seq + 1u, __ATOMIC_RELAXED);
+}
+
+bool matrix_anim_stats_read(matrix_anim_stats_t *out)
+{
+    if (!out) return false;
+
+    for (int i = 0; i < MATRIX_ANIM_STATS_READ_RETRIES; i++) {
+        const uint32_t seq0 = __atomic_load_n(&s_stats_seq, __ATOMIC_ACQUIRE);
+        if (seq0 & 1u) continue;   // writer внутри обновления
+
+        *out = s_stats;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&s_stats_seq, __ATOMIC_RELAXED) == seq0) return true;
+    }
+    return false;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+/*
+ * matrix_anim_stats.h
+ *
+ * Always-on статистика кадров matrix_anim (matrix_anim_stats_t, см. matrix_anim.h):
+ *   - единственный writer — matrix_task (matrix_anim_stats_record раз за кадр);
+ *   - читатели из любых задач — matrix_anim_stats_read(): seqlock, без мьютекса у writer'а
+ *     (writer не ждёт никогда, читатель повторяет копию, если попал на обновление).
+ * Отдельный модуль без FreeRTOS/таймеров: собирается и проверяется на хосте.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "matrix_anim.h"   // matrix_anim_stats_t, MATRIX_ANIM_HIST_BUCKETS
+#include "fx_post.h"       // fx_post_timing_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bucket log2-гистограммы: 0..1 -> 0, [2^k .. 2^(k+1)-1] -> k, всё >= 2^(N-1) -> N-1 */
+static inline uint32_t matrix_anim_hist_bucket(uint32_t us)
+{
+    if (us <= 1u) return 0;
+    const uint32_t k = 31u - (uint32_t)__builtin_clz(us);
+    return (k < MATRIX_ANIM_HIST_BUCKETS) ? k : (MATRIX_ANIM_HIST_BUCKETS - 1u);
+}
+
+/* Кадр в статистику. miss — стоимость кадра (без ожидания fence) не уложилась в период;
+ * drops — монотонный счётчик пропущенных дедлайнов frame clock; trans_us < 0 — кадр без перехода.
+ * Отрицательные длительности идут в bucket 0. */
+void matrix_anim_stats_record(uint16_t effect_id, bool miss, uint32_t drops, int64_t t_tick_us,
+                              int64_t render_us, const fx_post_timing_t *post,
+                              int64_t trans_us, int64_t overlay_us, int64_t show_us, int64_t fence_us);
+
+/* Согласованный снимок (все поля — с одного и того же кадра). false — writer мешал все попытки. */
+bool matrix_anim_stats_read(matrix_anim_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
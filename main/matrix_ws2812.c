@@ -3,35 +3,257 @@
 /*
  * matrix_ws2812.c
  *
- * Реализация драйвера матрицы WS2812 через ESP-IDF led_strip (RMT, DMA на ESP32-S3).
+ * Реализация драйвера матрицы WS2812 напрямую на RMT TX (DMA на ESP32-S3)
+ * с собственным энкодером (matrix_ws2812_enc.*).
  *
  * Важные инварианты:
- *   - Яркость масштабируется софтверно (scale_bri), чтобы избежать внезапных токов на старте.
- *   - set_pixel_xy() пишет в буфер драйвера, show() отправляет буфер в линию WS2812.
+ *   - Яркость масштабируется софтверно, чтобы избежать внезапных токов на старте.
+ *   - set_pixel_xy()/blit() пишут в back-буфер (наш, GRB, значения ДО яркости/гаммы),
+ *     show()/submit() прогоняют его через выходной каскад и отправляют в линию WS2812.
+ *   - XY->индекс в цепочке считается один раз (s_xy_ofs, строится в init из MATRIX_*),
+ *     горячие пути (blit/set_pixel) маппинг "змейки"/панелей не пересчитывают.
  *   - static_one_pixel_test() предназначен для диагностики (один refresh и стоп).
  *
+ * Выходной каскад (gamma + яркость + temporal dithering):
+ *   - s_g12[v] = gamma(v) * bri в 12-битной шкале (x16 к 8-битному выходу), пересборка только
+ *     при смене яркости (set_brightness), powf — только там;
+ *   - на каждом submit() для каждого байта: acc = s_g12[src] + err; out = acc>>4; err = acc&15.
+ *     Остаток переносится в следующий кадр (error diffusion во времени), поэтому среднее по
+ *     кадрам совпадает с 12-битной целью, и на низкой яркости градиент не схлопывается в 2–3 ступени;
+ *   - остаток — 4 бита на байт, s_err — uint32 на слово кадра в "SWAR-раскладке" (см. output_stage),
+ *     2304 B на 768 LED: упаковка в uint16 экономила 1152 B, но распаковка/упаковка на каждое слово
+ *     съедала весь выигрыш у scale_bri();
+ *   - статичный кадр (blit/set_pixel записали то же самое, яркость та же):
+ *       * яркость >= MATRIX_WS2812_STATIC_DITHER_BRI: один раз выводится простым округлением до
+ *         ближайшего 8-битного уровня, s_err замораживается, дальше wire-буфер не пересчитывается:
+ *         одинаковые кадры дают одинаковые байты, elision и keep-alive видят статичную картинку.
+ *         Здесь 8-битных ступеней достаточно, 12-битная точность на паузе не нужна;
+ *       * ниже порога (ночь) dithering продолжается и на статичном кадре, иначе ночной градиент на
+ *         паузе снова схлопывается в ступени. Цена — elision там теряется: младший бит "дышит",
+ *         цепочка уходит (префиксом до старшего "дышащего" LED) каждый кадр. Молчат только LED,
+ *         у которых цель кратна 16 (в т.ч. яркость 0 — пауза с погашенной матрицей по-прежнему тихая);
+ *   - цена: 4 LUT + ~12 ALU на слово из 4 байт (add/shift/and на две 16-битные полосы сразу).
+ *     Бюджет — не дороже прежнего scale_bri() (деление на байт, три на пиксель) на тот же кадр:
+ *     сам каскад на хосте ~10% дешевле, submit() целиком (fence + каскад + запуск RMT) — на уровне
+ *     scale_bri() в пределах шума (бенчмарк в test_ws2812_output).
+ *
+ * Буферы / pipeline (RAM: back 2304 + wire 2304 + err 2304 = 6912 B на 768 LED):
+ *   - back-буфер s_back (исходные значения эффектов) персистентен между кадрами;
+ *   - один wire-буфер s_wire (GRB после выходного каскада): энкодер читает его напрямую из ISR RMT
+ *     и кодирует байты в символы на лету, отдельного pixel-буфера драйвера и копии кадра нет;
+ *   - submit(): fence прошлой передачи (rmt_tx_wait_all_done) -> выходной каскад back -> s_wire ->
+ *     rmt_transmit -> return. Render кадра N+1 идёт параллельно с передачей кадра N (~22.5 ms на 768 LED);
+ *     последовательно с передачей остаётся только выходной каскад (один проход по 2304 байтам).
+ *     Второй wire-буфер (каскад параллельно с передачей) стоил 2304 B DRAM ради этих десятков us.
+ *
+ * Static-frame elision + truncated-chain refresh:
+ *   - s_wire между передачами — точная копия того, что защёлкнуто в цепочке. Выходной каскад пишет
+ *     поверх и попутно запоминает старший изменившийся байт = старший "грязный" LED;
+ *   - отличий нет -> refresh пропускается (линия молчит, WS2812 держат последний кадр сами),
+ *     кроме keep-alive раз в MATRIX_WS2812_KEEPALIVE_MS (keep-alive шлёт цепочку целиком);
+ *   - иначе отправляется только префикс 0..hi: LED за ним защёлкнули то же самое ранее.
+ *     Хвост буфера не менялся, поэтому буфер остаётся точной копией состояния цепочки
+ *     и для следующего сравнения;
+ *   - сравнивается именно выход: пауза/яркость 0 пропускаются; пока кадр меняется, смена только
+ *     младшего бита dithering честно отправляется (это и есть его содержимое);
+ *   - show() всегда отправляет всю цепочку (явный refresh, static test).
+ *
  * Риски / заметки:
  *   - Любой вызов show() инициирует передачу по RMT и потенциально создаёт нагрузку по питанию.
  *   - Если при static_one_pixel_test картинка "дрожит" без последующих refresh, ищем аппаратное:
  *     питание 5 V, GND, MOSFET low-side, level-shifter, помехи, длину data-линии, конденсаторы.
+ *   - Перед отключением питания матриц вызывающий обязан дождаться fence (wait_done/deinit).
  */
 
 #include <stdbool.h>      // bool
+#include <string.h>       // memset
+#include <math.h>         // powf (только пересборка LUT)
+#include "esp_attr.h"
 #include "esp_log.h"
-#include "led_strip.h"
+#include "esp_timer.h"
+#include "driver/rmt_tx.h"
+#include "matrix_ws2812_enc.h"
 
 static const char *TAG = "MATRIX_WS2812";
 
-// Handle на led_strip (ESP-IDF managed component espressif/led_strip)
-static led_strip_handle_t s_strip = NULL;
+// Байт на кадр (GRB)
+#define MATRIX_FRAME_BYTES          (MATRIX_LEDS_TOTAL * 3u)
+
+// Сколько максимум ждём fence в submit()/show(). Передача 768 LED ~23 ms.
+#ifndef MATRIX_WS2812_TX_TIMEOUT_MS
+#define MATRIX_WS2812_TX_TIMEOUT_MS 100u
+#endif
+
+// Гамма выходного каскада x10 (22 = 2.2, 10 = линейно)
+#ifndef MATRIX_WS2812_GAMMA_X10
+#define MATRIX_WS2812_GAMMA_X10     22u
+#endif
+
+// Temporal dithering остатка 12->8 бит (0 = просто округление)
+#ifndef MATRIX_WS2812_DITHER
+#define MATRIX_WS2812_DITHER        1
+#endif
+
+// Ниже этой яркости dithering идёт и на статичном кадре (elision на нём теряется),
+// от неё и выше статичный кадр округляется один раз и линия молчит. 0 = всегда замораживать.
+#ifndef MATRIX_WS2812_STATIC_DITHER_BRI
+#define MATRIX_WS2812_STATIC_DITHER_BRI 64u
+#endif
+
+// Keep-alive для static-frame elision: одинаковый кадр всё равно переотправляется раз в N ms
+// (0 = elision выключен, отправляем каждый кадр)
+#ifndef MATRIX_WS2812_KEEPALIVE_MS
+#define MATRIX_WS2812_KEEPALIVE_MS  1000u
+#endif
+
+// RMT: 10 MHz (0.1 us тик), память канала в символах (с DMA — размер DMA-буфера)
+#define MATRIX_WS2812_RMT_RES_HZ    (10u * 1000u * 1000u)
+#define MATRIX_WS2812_RMT_MEM_SYMS  256u
+
+// RMT TX канал + наш энкодер
+static rmt_channel_handle_t s_chan = NULL;
+static rmt_encoder_handle_t s_enc  = NULL;
+
+// Back-буфер (GRB, индекс = индекс в цепочке, значения до яркости/гаммы)
+static uint8_t s_back[MATRIX_FRAME_BYTES];
+
+// Back-буфер (или LUT яркости) изменился с прошлого выходного каскада. false -> кадр статичный.
+static bool s_back_dirty = true;
+static bool s_wire_settled = false;   // s_wire = округлённый (без dithering) выход статичного кадра
+
+// Wire-буфер после выходного каскада. Внутренняя RAM: читается из ISR RMT.
+// Между передачами — копия того, что защёлкнуто в цепочке (база для elision).
+static DRAM_ATTR uint8_t s_wire[MATRIX_FRAME_BYTES] __attribute__((aligned(4)));
+
+// Остаток dithering (0..15) на каждый байт цепочки, по 4 на слово s_err[i/4]:
+// байты 0,2 слова -> биты 0..3, 16..19; байты 1,3 -> биты 4..7, 20..23 (раскладка полос output_stage)
+static uint32_t s_err[MATRIX_FRAME_BYTES / 4u];
+
+// Статистика передачи (on_trans_done пишет из ISR)
+static volatile int64_t  s_tx_start_us = 0;
+static volatile uint32_t s_tx_last_us  = 0;
+static bool              s_tx_pending  = false;  // был submit() без подтверждённого fence
+
+// Время линии на один LED: 24 бита * 1.25 us
+#define MATRIX_WS2812_LED_WIRE_US   30u
+
+// Static-frame elision / truncated refresh: состояние последнего отправленного кадра + счётчики
+static bool     s_sent_valid  = false;  // false -> следующий кадр уходит целиком и безусловно
+static int64_t  s_sent_us     = 0;
+static uint32_t s_cnt_sent    = 0;
+static uint32_t s_cnt_skipped = 0;
+static uint32_t s_saved_us    = 0;      // сэкономленное время линии последним submit()
+static uint32_t s_fence_us    = 0;      // ожидание fence последним submit()
 
 // Глобальная яркость 0..255. По умолчанию низкая (безопасный старт).
 static uint8_t s_bri = 32u;
 
-static inline uint8_t scale_bri(uint8_t v)
+// LUT выходного каскада: s_g12[v] = round((v/255)^gamma * s_bri * 16), 0..4080
+static uint16_t s_g12[256];
+static bool     s_bri_lut_ready = false;
+
+// XY (row-major, y*MATRIX_W+x) -> байтовое смещение пикселя в s_back (индекс_цепочки*3)
+static uint16_t s_xy_ofs[MATRIX_W * MATRIX_H];
+static bool     s_xy_ready = false;
+
+static void bri_lut_rebuild(void)
 {
-    // Масштабирование 0..255 с защитой от переполнения.
-    return (uint8_t)(((uint16_t)v * (uint16_t)s_bri) / 255u);
+    const float gamma = (float)MATRIX_WS2812_GAMMA_X10 / 10.0f;
+    const float scale = (float)s_bri * 16.0f;
+
+    for (uint16_t v = 0; v < 256u; v++) {
+        const float lin = powf((float)v / 255.0f, gamma);
+        // max = 255*16 = 4080: acc + остаток (<16) помещается в 12 бит, out = acc>>4 <= 255
+        s_g12[v] = (uint16_t)(lin * scale + 0.5f);
+    }
+    s_bri_lut_ready = true;
+    s_back_dirty = true;
+}
+
+// back (до яркости) -> s_wire: gamma + яркость (LUT) + temporal dithering (dither = false — округление,
+// s_err не трогаем). Возврат — сколько LED с начала цепочки изменилось относительно прежнего s_wire.
+// Идём словами по 4 байта (little-endian — порядок памяти и на ESP32-S3, и на хосте), SWAR:
+// байты 0,2 и 1,3 — две пары 12-битных acc в 16-битных полосах uint32, add/shift/and сразу на пару.
+static uint32_t output_stage(bool dither)
+{
+    _Static_assert((MATRIX_FRAME_BYTES % 4u) == 0u, "frame must be word-sized");
+
+    const uint16_t *lut = s_g12;
+    const uint8_t  *src = s_back;
+    uint32_t *dst = (uint32_t *)(void *)s_wire;
+    uint32_t hi = 0;   // слово за старшим изменившимся
+    uint32_t hi_x = 0; // XOR старого и нового в этом слове
+
+    for (uint32_t w = 0; w < MATRIX_FRAME_BYTES / 4u; w++, src += 4) {
+        // acc <= 4080 + 15 < 4096: полосы не переполняются
+        uint32_t pa = lut[src[0]] | ((uint32_t)lut[src[2]] << 16);
+        uint32_t pb = lut[src[1]] | ((uint32_t)lut[src[3]] << 16);
+        if (MATRIX_WS2812_DITHER && dither) {
+            const uint32_t e = s_err[w];
+            pa += e & 0x000F000Fu;
+            pb += (e >> 4) & 0x000F000Fu;
+            s_err[w] = (pa & 0x000F000Fu) | ((pb & 0x000F000Fu) << 4);
+        } else {
+            pa += 0x00080008u;
+            pb += 0x00080008u;
+        }
+        // acc>>4 пары a -> байты 0,2; пары b -> байты 1,3
+        const uint32_t o = ((pa >> 4) & 0x00FF00FFu) | ((pb << 4) & 0xFF00FF00u);
+        const uint32_t x = o ^ dst[w];
+        if (x) {
+            hi = w + 1u;
+            hi_x = x;
+        }
+        dst[w] = o;
+    }
+
+    if (hi == 0) return 0;
+
+    // старший изменившийся байт: слово hi-1, байт — по старшему ненулевому биту XOR
+    const uint32_t b = (hi - 1u) * 4u + (31u - (uint32_t)__builtin_clz(hi_x)) / 8u;
+    return b / 3u + 1u;
+}
+
+static void xy_lut_build_once(void)
+{
+    if (s_xy_ready) return;
+
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            s_xy_ofs[y * MATRIX_W + x] = (uint16_t)(matrix_ws2812_xy_to_index(x, y) * 3u);
+        }
+    }
+    s_xy_ready = true;
+}
+
+static inline void back_put(uint16_t idx, uint8_t r, uint8_t g, uint8_t b)
+{
+    uint8_t *p = &s_back[(uint32_t)idx * 3u];
+    s_back_dirty = true;
+    p[0] = g;
+    p[1] = r;
+    p[2] = b;
+}
+
+static IRAM_ATTR bool ws2812_on_tx_done(rmt_channel_handle_t chan,
+                                        const rmt_tx_done_event_data_t *edata, void *ctx)
+{
+    (void)chan; (void)edata; (void)ctx;
+    s_tx_last_us = (uint32_t)(esp_timer_get_time() - s_tx_start_us);
+    return false; // никого не будили
+}
+
+static void ws2812_release(void)
+{
+    if (s_chan) {
+        (void)rmt_disable(s_chan);
+        (void)rmt_del_channel(s_chan);
+        s_chan = NULL;
+    }
+    if (s_enc) {
+        (void)rmt_del_encoder(s_enc);
+        s_enc = NULL;
+    }
 }
 
 uint16_t matrix_ws2812_xy_to_index(uint16_t x, uint16_t y)
@@ -73,35 +295,55 @@ uint16_t matrix_ws2812_xy_to_index(uint16_t x, uint16_t y)
 
 esp_err_t matrix_ws2812_init(gpio_num_t data_gpio)
 {
-    if (s_strip) {
+    if (s_chan) {
         // Уже инициализировано
         return ESP_OK;
     }
 
-    // Конфиг led_strip (RMT)
-    const led_strip_config_t strip_config = {
-        .strip_gpio_num = (int)data_gpio,
-        .max_leds = MATRIX_LEDS_TOTAL,
-        .led_pixel_format = LED_PIXEL_FORMAT_GRB,
-        .led_model = LED_MODEL_WS2812,
-        .flags.invert_out = false,
-    };
+    // Таблицы горячего пути: маппинг XY и LUT яркости
+    xy_lut_build_once();
+    if (!s_bri_lut_ready) bri_lut_rebuild();
 
-    // RMT config: 10 MHz resolution, DMA включаем для ESP32-S3
-    const led_strip_rmt_config_t rmt_config = {
+    // RMT TX: DMA включаем для ESP32-S3, idle/EOT уровень линии = LOW
+    const rmt_tx_channel_config_t chan_config = {
+        .gpio_num = (int)data_gpio,
         .clk_src = RMT_CLK_SRC_DEFAULT,
-        .resolution_hz = 10u * 1000u * 1000u, // 10 MHz
-        .mem_block_symbols = 0,               // дефолт
+        .resolution_hz = MATRIX_WS2812_RMT_RES_HZ,
+        .mem_block_symbols = MATRIX_WS2812_RMT_MEM_SYMS,
+        .trans_queue_depth = 2,
+        .flags.invert_out = false,
         .flags.with_dma = true,
     };
 
-    const esp_err_t err = led_strip_new_rmt_device(&strip_config, &rmt_config, &s_strip);
+    esp_err_t err = rmt_new_tx_channel(&chan_config, &s_chan);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "rmt_new_tx_channel failed: %s", esp_err_to_name(err));
+        s_chan = NULL;
+        return err;
+    }
+
+    err = matrix_ws2812_enc_new(MATRIX_WS2812_RMT_RES_HZ, &s_enc);
+    if (err == ESP_OK) {
+        const rmt_tx_event_callbacks_t cbs = {
+            .on_trans_done = ws2812_on_tx_done,
+        };
+        err = rmt_tx_register_event_callbacks(s_chan, &cbs, NULL);
+    }
+    if (err == ESP_OK) {
+        err = rmt_enable(s_chan);
+    }
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "led_strip_new_rmt_device failed: %s", esp_err_to_name(err));
-        s_strip = NULL;
+        ESP_LOGE(TAG, "ws2812 rmt setup failed: %s", esp_err_to_name(err));
+        ws2812_release();
         return err;
     }
 
+    memset(s_err, 0, sizeof(s_err));
+    s_back_dirty = true;
+    s_sent_valid = false;
+    s_tx_last_us = 0;
+    s_tx_pending = false;
+
     // Стартуем в "известном" состоянии: буфер очищен + один refresh.
     matrix_ws2812_clear();
     const esp_err_t err2 = matrix_ws2812_show();
@@ -114,42 +356,182 @@ esp_err_t matrix_ws2812_init(gpio_num_t data_gpio)
 
 void matrix_ws2812_deinit(void)
 {
-    if (!s_strip) return;
-    led_strip_del(s_strip);
-    s_strip = NULL;
+    if (!s_chan) return;
+
+    // Дождаться конца текущей передачи: после deinit вызывающий гасит DATA/MOSFET.
+    if (rmt_tx_wait_all_done(s_chan, (int)MATRIX_WS2812_TX_TIMEOUT_MS) != ESP_OK) {
+        ESP_LOGW(TAG, "deinit: tx fence timeout");
+    }
+    s_tx_pending = false;
+
+    ws2812_release();
 }
 
 void matrix_ws2812_set_brightness(uint8_t bri_0_255)
 {
-    // Прямое присваивание: 0..255
+    // 0..255; LUT пересобираем только при реальной смене уровня
+    if (bri_0_255 == s_bri && s_bri_lut_ready) return;
     s_bri = bri_0_255;
+    bri_lut_rebuild();
 }
 
 void matrix_ws2812_clear(void)
 {
-    if (!s_strip) return;
-    (void)led_strip_clear(s_strip);
+    if (!s_chan) return;
+    memset(s_back, 0, MATRIX_FRAME_BYTES);
+    s_back_dirty = true;
+}
+
+static esp_err_t ws2812_submit(bool force)
+{
+    if (!s_chan) return ESP_ERR_INVALID_STATE;
+
+    // 1) fence предыдущего кадра: энкодер мог ещё читать s_wire
+    esp_err_t err = ESP_OK;
+    s_fence_us = 0;
+    if (s_tx_pending) {
+        const int64_t t0 = esp_timer_get_time();
+        err = rmt_tx_wait_all_done(s_chan, (int)MATRIX_WS2812_TX_TIMEOUT_MS);
+        s_fence_us = (uint32_t)(esp_timer_get_time() - t0);
+        if (err != ESP_OK) return err;
+        s_tx_pending = false;
+    }
+
+    // 2) выходной каскад в s_wire + сравнение с кадром в цепочке (прежнее содержимое s_wire).
+    //    Статичный кадр: один раз округлённый выход, дальше s_wire не трогаем (dithering заморожен);
+    //    на ночной яркости dithering идёт и по статичному кадру.
+    uint32_t dirty = 0;
+    if (s_back_dirty || s_bri < MATRIX_WS2812_STATIC_DITHER_BRI) {
+        dirty = output_stage(true);
+        s_back_dirty = false;
+        s_wire_settled = false;
+    } else if (!s_wire_settled) {
+        dirty = output_stage(false);
+        s_wire_settled = true;
+    }
+
+    const int64_t now_us = esp_timer_get_time();
+    const bool keepalive = (MATRIX_WS2812_KEEPALIVE_MS == 0u) ||
+                           ((now_us - s_sent_us) >= (int64_t)MATRIX_WS2812_KEEPALIVE_MS * 1000);
+
+    uint32_t leds = MATRIX_LEDS_TOTAL;
+    if (!force && !keepalive && s_sent_valid) {
+        leds = dirty;
+    }
+
+    // 2a) static-frame elision: тот же выход, что уже в линии -> не трогаем RMT
+    if (leds == 0) {
+        s_cnt_skipped++;
+        s_saved_us = MATRIX_LEDS_TOTAL * MATRIX_WS2812_LED_WIRE_US;
+        return ESP_OK;
+    }
+
+    // 3) запуск передачи (асинхронно, энкодер читает s_wire из ISR)
+    const rmt_transmit_config_t tx_cfg = {
+        .loop_count = 0,
+        .flags.eot_level = 0,
+    };
+    s_tx_start_us = esp_timer_get_time();
+    // 3a) truncated refresh: только префикс до старшего изменившегося LED
+    err = rmt_transmit(s_chan, s_enc, s_wire, leds * 3u, &tx_cfg);
+    if (err != ESP_OK) {
+        s_sent_valid = false;
+        return err;
+    }
+    s_tx_pending = true;
+
+    s_sent_valid = true;
+    if (leds == MATRIX_LEDS_TOTAL) s_sent_us = now_us;  // keep-alive отсчитываем от полного кадра
+    s_saved_us = (MATRIX_LEDS_TOTAL - leds) * MATRIX_WS2812_LED_WIRE_US;
+    s_cnt_sent++;
+
+    return ESP_OK;
+}
+
+esp_err_t matrix_ws2812_submit(void)
+{
+    return ws2812_submit(false);
+}
+
+void matrix_ws2812_get_frame_counters(uint32_t *sent, uint32_t *skipped)
+{
+    if (sent)    *sent = s_cnt_sent;
+    if (skipped) *skipped = s_cnt_skipped;
+}
+
+uint32_t matrix_ws2812_get_last_saved_us(void)
+{
+    return s_saved_us;
+}
+
+uint32_t matrix_ws2812_get_last_fence_us(void)
+{
+    return s_fence_us;
+}
+
+esp_err_t matrix_ws2812_wait_done(uint32_t timeout_ms)
+{
+    if (!s_chan) return ESP_ERR_INVALID_STATE;
+    if (!s_tx_pending) return ESP_OK;
+
+    const esp_err_t err = rmt_tx_wait_all_done(s_chan, (int)timeout_ms);
+    if (err == ESP_OK) s_tx_pending = false;
+    return err;
+}
+
+uint32_t matrix_ws2812_get_last_tx_us(void)
+{
+    return s_tx_last_us;
 }
 
 esp_err_t matrix_ws2812_show(void)
 {
-    if (!s_strip) return ESP_ERR_INVALID_STATE;
-    return led_strip_refresh(s_strip);
+    // Явный refresh: без static-frame elision
+    const esp_err_t err = ws2812_submit(true);
+    if (err != ESP_OK) return err;
+    return matrix_ws2812_wait_done(MATRIX_WS2812_TX_TIMEOUT_MS);
 }
 
 void matrix_ws2812_set_pixel_xy(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
 {
-    if (!s_strip) return;
+    if (!s_chan) return;
 
     // Доп. защита: если координаты вне диапазона, не трогаем буфер.
     if (x >= MATRIX_W || y >= MATRIX_H) {
         return;
     }
 
-    const uint16_t idx = matrix_ws2812_xy_to_index(x, y);
+    // Яркость/гамма применяются в выходном каскаде на submit(), здесь только GRB.
+    uint8_t *p = &s_back[s_xy_ofs[y * MATRIX_W + x]];
+    if (p[0] != g || p[1] != r || p[2] != b) s_back_dirty = true;
+    p[0] = g;
+    p[1] = r;
+    p[2] = b;
+}
 
-    // Яркость масштабируем сами, чтобы управлять токами и исключить "внезапную 100% яркость".
-    (void)led_strip_set_pixel(s_strip, idx, scale_bri(r), scale_bri(g), scale_bri(b));
+void matrix_ws2812_blit(const uint8_t *rgb)
+{
+    matrix_ws2812_blit_rows(rgb, 0, MATRIX_H);
+}
+
+void matrix_ws2812_blit_rows(const uint8_t *rgb, uint16_t y0, uint16_t rows)
+{
+    if (!s_chan || !rgb || y0 >= MATRIX_H) return;
+    if (rows > (uint16_t)(MATRIX_H - y0)) rows = (uint16_t)(MATRIX_H - y0);
+
+    // Один проход по полосе: XY->смещение из таблицы, RGB->GRB (яркость — в выходном каскаде).
+    // Попутно (без ветвлений) — изменилось ли что-то: статичный кадр не гоняет dithering.
+    const uint16_t end = (uint16_t)((y0 + rows) * MATRIX_W);
+    uint32_t diff = 0;
+    for (uint16_t i = (uint16_t)(y0 * MATRIX_W); i < end; i++) {
+        uint8_t *p = &s_back[s_xy_ofs[i]];
+        diff |= (uint32_t)(p[0] ^ rgb[1]) | (uint32_t)(p[1] ^ rgb[0]) | (uint32_t)(p[2] ^ rgb[2]);
+        p[0] = rgb[1];
+        p[1] = rgb[0];
+        p[2] = rgb[2];
+        rgb += 3;
+    }
+    if (diff) s_back_dirty = true;
 }
 
 /* ============================================================
@@ -162,7 +544,7 @@ void matrix_ws2812_static_one_pixel_test(uint16_t x, uint16_t y,
                                          uint8_t r, uint8_t g, uint8_t b,
                                          uint8_t bri_0_255)
 {
-    if (!s_strip) return;
+    if (!s_chan) return;
 
     // Ограничим доступ по координатам, чтобы тест не "случайно" писал в idx=0.
     if (x >= MATRIX_W || y >= MATRIX_H) {
@@ -171,17 +553,17 @@ void matrix_ws2812_static_one_pixel_test(uint16_t x, uint16_t y,
     }
 
     // Фиксируем яркость на время теста.
-    s_bri = bri_0_255;
+    matrix_ws2812_set_brightness(bri_0_255);
 
     // Чистим буфер и ставим один пиксель
-    (void)led_strip_clear(s_strip);
+    memset(s_back, 0, MATRIX_FRAME_BYTES);
     {
         const uint16_t idx = matrix_ws2812_xy_to_index(x, y);
-        (void)led_strip_set_pixel(s_strip, idx, scale_bri(r), scale_bri(g), scale_bri(b));
+        back_put(idx, r, g, b);
     }
 
-    // ВАЖНО: refresh ровно один раз
-    (void)led_strip_refresh(s_strip);
+    // ВАЖНО: refresh ровно один раз (и дождаться его окончания)
+    (void)matrix_ws2812_show();
 
     // Дальше намеренно НИЧЕГО не делаем:
     // - не вызываем set_pixel
@@ -6,15 +6,20 @@
  * Назначение:
  *   Низкоуровневый драйвер "буфера кадра" для WS2812 (NeoPixel) в проекте Jinny Lamp.
  *   Отвечает за:
- *     - инициализацию драйвера ESP-IDF led_strip на RMT (с DMA на ESP32-S3),
+ *     - инициализацию RMT TX канала (с DMA на ESP32-S3) и собственного энкодера WS2812,
  *     - перевод координат (x,y) -> индекс в цепочке светодиодов (учёт 3х панелей 16x16, "змейка"),
  *     - установку пикселей в буфер (без отправки на ленту),
  *     - отправку буфера на светодиоды (refresh/show),
+ *     - двойную буферизацию кадра: back-буфер (пишем) + front (уходит в линию),
+ *       неблокирующий submit() и fence (wait_done) для конвейера render/show,
  *     - статический "стерильный" тест одного пикселя (1 refresh и стоп).
  *
  * Важно / инварианты (проектные):
- *   - Мы масштабируем яркость сами (software scaling) для безопасного старта и контроля токов.
+ *   - Мы масштабируем яркость сами (software scaling) для безопасного старта и контроля токов:
+ *     выходной каскад на submit() = gamma LUT (12 бит) + яркость + temporal dithering.
  *   - show()/refresh отправляет текущий буфер на WS2812.
+ *   - submit() не ждёт окончания передачи: кадр N уходит по RMT/DMA, пока рендерится N+1.
+ *     Back-буфер после submit() остаётся валидным (содержит отправленный кадр).
  *   - Для поиска аппаратных проблем полезен static_one_pixel_test: один refresh и дальше тишина.
  *
  * Примечание по конфигу:
@@ -77,18 +82,47 @@
 // Инициализация LED strip на заданном GPIO (WS2812 data). Повторный вызов безопасен.
 esp_err_t matrix_ws2812_init(gpio_num_t data_gpio);
 
-// Освободить ресурсы led_strip (если нужно для тестов/перезапуска).
+// Освободить RMT канал и энкодер (если нужно для тестов/перезапуска).
 void      matrix_ws2812_deinit(void);
 
-// Установить яркость 0..255 (масштабирование выполняется софтверно при set_pixel).
+// Установить яркость 0..255 (LUT gamma*яркость пересобирается только при смене уровня,
+// применяется софтверно в выходном каскаде submit()/show()).
 void      matrix_ws2812_set_brightness(uint8_t bri_0_255);
 
 // Очистить буфер (не отправляет на светодиоды до matrix_ws2812_show()).
 void      matrix_ws2812_clear(void);
 
-// Отправить текущий буфер на светодиоды (refresh).
+// Отправить текущий буфер на светодиоды (refresh) и дождаться окончания передачи.
 esp_err_t matrix_ws2812_show(void);
 
+// ====== Double buffer / pipeline ======
+// Неблокирующая отправка кадра:
+//   - ждёт fence предыдущего кадра (если он ещё в линии),
+//   - back -> выходной каскад -> wire-буфер (буфер передачи),
+//   - запускает передачу и сразу возвращается.
+// Пока кадр N уходит в линию, вызывающий может рисовать кадр N+1.
+// Если выход совпадает с последним отправленным кадром, refresh пропускается
+// (keep-alive раз в MATRIX_WS2812_KEEPALIVE_MS). Иначе уходит только префикс цепочки
+// до старшего изменившегося LED. show() отправляет всю цепочку всегда.
+esp_err_t matrix_ws2812_submit(void);
+
+// Fence: дождаться окончания передачи последнего submit() (timeout в ms).
+// ESP_OK — линия свободна, ESP_ERR_TIMEOUT — передача не завершилась.
+esp_err_t matrix_ws2812_wait_done(uint32_t timeout_ms);
+
+// Длительность передачи последнего завершённого кадра (us), 0 если ещё не было.
+uint32_t  matrix_ws2812_get_last_tx_us(void);
+
+// Счётчики static-frame elision с init (монотонные, для ANIM_PERF): отправлено / пропущено.
+void      matrix_ws2812_get_frame_counters(uint32_t *sent, uint32_t *skipped);
+
+// Время линии (us), сэкономленное последним submit() (усечённый префикс или пропуск кадра).
+uint32_t  matrix_ws2812_get_last_saved_us(void);
+
+// Сколько последний submit()/show() ждал fence предыдущей передачи (us), 0 — линия была свободна.
+// Это время линии, а не CPU: governor кадров его не учитывает.
+uint32_t  matrix_ws2812_get_last_fence_us(void);
+
 // Установка пикселя по XY в общей системе координат (по умолчанию 48x16).
 // Внимание: функция не вызывает show(); это только запись в буфер.
 void      matrix_ws2812_set_pixel_xy(uint16_t x, uint16_t y,
@@ -97,6 +131,15 @@ void      matrix_ws2812_set_pixel_xy(uint16_t x, uint16_t y,
 // Вспомогательное: XY->индекс в цепочке WS2812.
 uint16_t  matrix_ws2812_xy_to_index(uint16_t x, uint16_t y);
 
+// Bulk-запись целого кадра в back-буфер за один проход.
+// rgb: row-major RGB (y*MATRIX_W + x)*3, размер MATRIX_W*MATRIX_H*3 байт.
+// Использует таблицу XY->индекс (строится в init); яркость — в submit(), show() не вызывает.
+void      matrix_ws2812_blit(const uint8_t *rgb);
+
+// Bulk-запись полосы строк: rgb — rows строк row-major RGB, ложатся в строки y0..y0+rows-1.
+// Нужна для canvas с кольцевым смещением строк (кадр отдаётся двумя кусками).
+void      matrix_ws2812_blit_rows(const uint8_t *rgb, uint16_t y0, uint16_t rows);
+
 /*
  * "Стерильный" тест:
  *   - очищает буфер
@@ -0,0 +1,98 @@
+#include "matrix_ws2812_enc.h"
+
+/*
+ * matrix_ws2812_enc.c
+ *
+ * RMT-энкодер WS2812: байты кадра -> символы прямо в память RMT-канала.
+ *
+ * Важно:
+ *   - ws2812_enc_cb() вызывается из ISR RMT (CONFIG_RMT_ENCODER_FUNC_IN_IRAM=y),
+ *     поэтому он и данные энкодера живут в IRAM/DRAM, без логов и блокировок.
+ *   - Позиция в кадре восстанавливается из symbols_written: ровно 8 символов на байт,
+ *     reset — последним символом транзакции.
+ */
+
+#include <stdbool.h>
+#include "esp_attr.h"
+#include "esp_log.h"
+
+static const char *TAG = "WS2812_ENC";
+
+// Минимальный кусок для callback: один байт (8 символов) или reset
+#define WS2812_ENC_MIN_CHUNK    8u
+
+void matrix_ws2812_enc_timing_init(matrix_ws2812_enc_timing_t *t, uint32_t resolution_hz)
+{
+    // ticks = us * res / 1e6 (в десятых долях us, чтобы 0.3/0.9 считались целочисленно)
+    const uint32_t t03 = (3u * resolution_hz) / 10000000u;   // 0.3 us
+    const uint32_t t09 = (9u * resolution_hz) / 10000000u;   // 0.9 us
+    const uint32_t rst = (resolution_hz / 1000000u) * 280u / 2u; // 280 us, две половины символа
+
+    t->bit0  = matrix_ws2812_enc_pack((uint16_t)t03, 1, (uint16_t)t09, 0);
+    t->bit1  = matrix_ws2812_enc_pack((uint16_t)t09, 1, (uint16_t)t03, 0);
+    t->reset = matrix_ws2812_enc_pack((uint16_t)rst, 0, (uint16_t)rst, 0);
+}
+
+size_t matrix_ws2812_enc_bytes(const matrix_ws2812_enc_timing_t *t,
+                               const uint8_t *src, size_t n, uint32_t *out)
+{
+    for (size_t i = 0; i < n; i++) {
+        matrix_ws2812_enc_byte(t, src[i], &out[i * 8u]);
+    }
+    return n * 8u;
+}
+
+static IRAM_ATTR size_t ws2812_enc_cb(const void *data, size_t data_size,
+                                      size_t symbols_written, size_t symbols_free,
+                                      rmt_symbol_word_t *symbols, bool *done, void *arg)
+{
+    const matrix_ws2812_enc_timing_t *t = (const matrix_ws2812_enc_timing_t *)arg;
+    const uint8_t *src = (const uint8_t *)data;
+
+    const size_t pos = symbols_written / 8u;   // байт кадра, с которого продолжаем
+
+    if (pos < data_size) {
+        // Кодируем столько целых байт, сколько влезает в свободную память канала
+        size_t n = symbols_free / 8u;
+        if (n == 0) return 0;                  // подождать, пока RMT освободит место
+        if (n > data_size - pos) n = data_size - pos;
+
+        size_t k = 0;
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t b = src[pos + i];
+            for (uint8_t m = 0x80u; m != 0; m >>= 1) {
+                symbols[k++].val = (b & m) ? t->bit1 : t->bit0;
+            }
+        }
+        return k;
+    }
+
+    // Все байты ушли: latch/reset и конец транзакции
+    if (symbols_free < 1u) return 0;
+    symbols[0].val = t->reset;
+    *done = true;
+    return 1;
+}
+
+esp_err_t matrix_ws2812_enc_new(uint32_t resolution_hz, rmt_encoder_handle_t *ret_encoder)
+{
+    if (!ret_encoder || resolution_hz == 0) return ESP_ERR_INVALID_ARG;
+
+    // Тайминги живут столько же, сколько энкодер. Энкодер создаётся один раз на init,
+    // освобождать отдельно не нужно: повторный init переиспользует эту же структуру.
+    static DRAM_ATTR matrix_ws2812_enc_timing_t s_timing;
+    matrix_ws2812_enc_timing_init(&s_timing, resolution_hz);
+
+    const rmt_simple_encoder_config_t cfg = {
+        .callback = ws2812_enc_cb,
+        .arg = &s_timing,
+        .min_chunk_size = WS2812_ENC_MIN_CHUNK,
+    };
+
+    const esp_err_t err = rmt_new_simple_encoder(&cfg, ret_encoder);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "rmt_new_simple_encoder failed: %s", esp_err_to_name(err));
+        *ret_encoder = NULL;
+    }
+    return err;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+ * matrix_ws2812_enc.h
+ *
+ * Назначение:
+ *   Собственный RMT-энкодер WS2812 для matrix_ws2812.
+ *   Превращает байты GRB в RMT-символы "на лету" прямо из буфера кадра лампы
+ *   (без промежуточного pixel-буфера led_strip и без копии кадра).
+ *
+ * Устройство:
+ *   - Логика byte -> 8 символов (MSB first) и символ reset — чистые функции без
+ *     зависимостей от драйвера (symbol = упакованный uint32, раскладка rmt_symbol_word_t).
+ *     Их можно собирать и сверять с эталонным битстримом на хосте.
+ *   - matrix_ws2812_enc_new() заворачивает их в rmt_new_simple_encoder():
+ *     callback вызывается из ISR RMT по мере освобождения памяти канала.
+ *   - Источник данных задаётся в rmt_transmit() (primary_data), поэтому любой из
+ *     буферов double buffer может быть отправлен напрямую.
+ *
+ * Тайминги (WS2812, как в led_strip): T0H=0.3us T0L=0.9us, T1H=0.9us T1L=0.3us,
+ * reset = 280us LOW (совместимо с WS2812B-V5).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "driver/rmt_encoder.h"
+
+// Упаковка RMT-символа: duration0[14:0] level0[15] duration1[30:16] level1[31]
+static inline uint32_t matrix_ws2812_enc_pack(uint16_t d0, uint8_t l0, uint16_t d1, uint8_t l1)
+{
+    return  (uint32_t)(d0 & 0x7FFFu)
+         | ((uint32_t)(l0 & 1u) << 15)
+         | ((uint32_t)(d1 & 0x7FFFu) << 16)
+         | ((uint32_t)(l1 & 1u) << 31);
+}
+
+typedef struct {
+    uint32_t bit0;   // символ для бита '0'
+    uint32_t bit1;   // символ для бита '1'
+    uint32_t reset;  // символ latch/reset (LOW)
+} matrix_ws2812_enc_timing_t;
+
+// Посчитать символы для заданного разрешения RMT (Гц, обычно 10 MHz).
+void matrix_ws2812_enc_timing_init(matrix_ws2812_enc_timing_t *t, uint32_t resolution_hz);
+
+// Один байт -> 8 символов, старший бит первым (порядок линии WS2812: G7..G0 R7..R0 B7..B0).
+static inline void matrix_ws2812_enc_byte(const matrix_ws2812_enc_timing_t *t, uint8_t b, uint32_t out[8])
+{
+    for (uint8_t i = 0; i < 8u; i++) {
+        out[i] = (b & (uint8_t)(0x80u >> i)) ? t->bit1 : t->bit0;
+    }
+}
+
+// n байт -> n*8 символов (reset не добавляется). Возвращает число записанных символов.
+size_t matrix_ws2812_enc_bytes(const matrix_ws2812_enc_timing_t *t,
+                               const uint8_t *src, size_t n, uint32_t *out);
+
+// Создать RMT-энкодер (simple encoder + наш callback). Удаляется rmt_del_encoder().
+esp_err_t matrix_ws2812_enc_new(uint32_t resolution_hz, rmt_encoder_handle_t *ret_encoder);
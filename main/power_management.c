@@ -170,7 +170,7 @@ esp_err_t power_mgmt_enter_soft_off(power_src_t src)
     matrix_anim_stop_and_wait();
 
 
-    // Важно: сбросить led_strip/RMT, чтобы следующий start сделал полноценный init GPIO/RMT
+    // Важно: сбросить RMT канал WS2812, чтобы следующий start сделал полноценный init GPIO/RMT
     matrix_ws2812_deinit();
 
 
@@ -209,7 +209,7 @@ esp_err_t power_mgmt_exit_soft_off(power_src_t src)
         return err;
     }
 
-    // 2) Re-init led_strip/RMT after SOFT OFF deinit
+    // 2) Re-init WS2812 RMT channel after SOFT OFF deinit
     const esp_err_t init_err = matrix_ws2812_init(s_data_gpio);
     if (init_err != ESP_OK) {
         ESP_LOGE(TAG, "matrix_ws2812_init failed: %s -> back to SOFT OFF", esp_err_to_name(init_err));
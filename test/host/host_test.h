@@ -0,0 +1,80 @@
+#pragma once
+/*
+ * host_test.h
+ *
+ * Мини-фреймворк хостовых тестов: проверки (CHECK*) и замер времени (HOST_BENCH).
+ * Каждый test_*.c — отдельный исполняемый файл, main() заканчивается host_test_done():
+ * код возврата != 0, если хоть одна проверка упала (ctest видит это как FAIL).
+ *
+ * Время на хосте — не время ESP32-S3: бенчмарки печатают us и отношение "было/стало",
+ * а проверяют только корректность. Абсолютные цифры на железе — ANIM_PERF.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static int s_host_fails = 0;
+static int s_host_checks = 0;
+
+#define CHECK(cond) do { \
+    s_host_checks++; \
+    if (!(cond)) { \
+        s_host_fails++; \
+        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+    } \
+} while (0)
+
+#define CHECK_EQ_U(a, b) do { \
+    const unsigned long long a_ = (unsigned long long)(a); \
+    const unsigned long long b_ = (unsigned long long)(b); \
+    s_host_checks++; \
+    if (a_ != b_) { \
+        s_host_fails++; \
+        printf("FAIL %s:%d: %s == %s (%llu != %llu)\n", __FILE__, __LINE__, #a, #b, a_, b_); \
+    } \
+} while (0)
+
+#define CHECK_MEM(a, b, n) do { \
+    s_host_checks++; \
+    if (memcmp((a), (b), (n)) != 0) { \
+        s_host_fails++; \
+        printf("FAIL %s:%d: memcmp(%s, %s, %s)\n", __FILE__, __LINE__, #a, #b, #n); \
+    } \
+} while (0)
+
+static inline double host_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+/* Прогнать body iters раз, вернуть среднее us на итерацию (лучшее из 3 прогонов) */
+#define HOST_BENCH(out_us, iters, body) do { \
+    double best_ = 1e300; \
+    for (int rep_ = 0; rep_ < 3; rep_++) { \
+        const double t0_ = host_now_us(); \
+        for (long it_ = 0; it_ < (long)(iters); it_++) { body; } \
+        const double dt_ = (host_now_us() - t0_) / (double)(iters); \
+        if (dt_ < best_) best_ = dt_; \
+    } \
+    (out_us) = best_; \
+} while (0)
+
+/* Не дать компилятору выкинуть результат бенчмарка */
+static volatile uint32_t g_host_sink;
+
+static inline void host_bench_report(const char *name, double old_us, double new_us)
+{
+    printf("BENCH %-40s old %9.3f us  new %9.3f us  x%.2f\n",
+           name, old_us, new_us, new_us > 0.0 ? old_us / new_us : 0.0);
+}
+
+static inline int host_test_done(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, s_host_checks, s_host_fails);
+    return s_host_fails ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+/*
+ * ref_canvas.h
+ *
+ * Эталон: fx_canvas как в baseline (09f7ec8) — плоский буфер без кольца строк,
+ * dim с делением на 255, shift_* попиксельно через get/set, present через
+ * baseline set_pixel_xy (ref_ws2812). Только для хостовых тестов.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+void ref_canvas_clear(uint8_t r, uint8_t g, uint8_t b);
+void ref_canvas_set(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b);
+bool ref_canvas_get(uint16_t x, uint16_t y, uint8_t *r, uint8_t *g, uint8_t *b);
+void ref_canvas_dim(uint8_t scale);
+void ref_canvas_shift_down(uint8_t fill_r, uint8_t fill_g, uint8_t fill_b);
+void ref_canvas_shift_towards_y0(uint8_t r0, uint8_t g0, uint8_t b0);
+void ref_canvas_shift_up(uint8_t fill_r, uint8_t fill_g, uint8_t fill_b);
+void ref_canvas_present(void);
+
+/* Буфер baseline (row-major RGB, y*MATRIX_W + x) */
+uint8_t *ref_canvas_buf(void);
@@ -0,0 +1,215 @@
+#include "ref_fx_simple.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "matrix_ws2812.h"
+#include "ref_ws2812.h"
+
+/* ---- fx_effects_simple.c @ 09f7ec8 ---- */
+
+static inline uint32_t xorshift32_u32(uint32_t *s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+static inline uint32_t xorshift32(uint32_t *state) { return xorshift32_u32(state); }
+
+void ref_hsv_to_rgb(uint8_t h, uint8_t s, uint8_t v, uint8_t *r, uint8_t *g, uint8_t *b)
+{
+    const uint8_t region = h / 43;
+    const uint8_t rem = (h - (region * 43)) * 6;
+
+    const uint8_t p = (uint8_t)((v * (255 - s)) >> 8);
+    const uint8_t q = (uint8_t)((v * (255 - ((s * rem) >> 8))) >> 8);
+    const uint8_t t = (uint8_t)((v * (255 - ((s * (255 - rem)) >> 8))) >> 8);
+
+    switch (region) {
+        default:
+        case 0: *r = v; *g = t; *b = p; break;
+        case 1: *r = q; *g = v; *b = p; break;
+        case 2: *r = p; *g = v; *b = t; break;
+        case 3: *r = p; *g = q; *b = v; break;
+        case 4: *r = t; *g = p; *b = v; break;
+        case 5: *r = v; *g = p; *b = q; break;
+    }
+}
+
+void ref_fx_diag_rainbow_render(fx_ctx_t *ctx)
+{
+    if (!ctx) return;
+
+    const uint32_t phase = (ctx->anim_ms / 20u);
+
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const uint8_t h = (uint8_t)(phase + (x * 7u) + (y * 9u));
+            uint8_t r,g,b;
+            ref_hsv_to_rgb(h, 255, 210, &r,&g,&b);
+            ref_ws2812_set_pixel_xy(x, y, r, g, b);
+        }
+    }
+}
+
+void ref_fx_glitter_rainbow_render(fx_ctx_t *ctx)
+{
+    if (!ctx) return;
+
+    const uint32_t phase = (ctx->anim_ms / 20u);
+
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const uint8_t h = (uint8_t)(phase + x * 6u);
+            uint8_t r,g,b;
+            ref_hsv_to_rgb(h, 255, 180, &r,&g,&b);
+            ref_ws2812_set_pixel_xy(x, y, r, g, b);
+        }
+    }
+
+    // small glitter, deterministic from time
+    uint32_t s = (uint32_t)(0x9E3779B9u ^ (phase * 33u) ^ (ctx->wall_ms * 17u));
+    for (int i = 0; i < 16; i++) {
+        const uint32_t rr = xorshift32(&s);
+        const uint16_t x = (uint16_t)(rr % MATRIX_W);
+        const uint16_t y = (uint16_t)((rr >> 8) % MATRIX_H);
+        ref_ws2812_set_pixel_xy(x, y, 255, 255, 255);
+    }
+}
+
+void ref_fx_radial_ripple_render(fx_ctx_t *ctx)
+{
+    if (!ctx) return;
+
+    const uint32_t phase = (ctx->anim_ms / 18u);
+
+    const int16_t cx = (int16_t)(MATRIX_W / 2u);
+    const int16_t cy = (int16_t)(MATRIX_H / 2u);
+
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const int16_t dx = (int16_t)x - cx;
+            const int16_t dy = (int16_t)y - cy;
+            const uint16_t dist = (uint16_t)(abs(dx) + abs(dy)); // cheap "radius"
+            const uint8_t h = (uint8_t)(phase + dist * 9u);
+
+            uint8_t v = 200;
+            const uint8_t m = (uint8_t)((phase + dist * 12u) & 0xFFu);
+            if (m < 40u) v = 255;
+
+            uint8_t r,g,b;
+            ref_hsv_to_rgb(h, 255, v, &r,&g,&b);
+            ref_ws2812_set_pixel_xy(x, y, r, g, b);
+        }
+    }
+}
+
+static inline void fill_black(void)
+{
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            ref_ws2812_set_pixel_xy(x, y, 0, 0, 0);
+        }
+    }
+}
+
+void ref_fx_cubes_render(fx_ctx_t *ctx)
+{
+    if (!ctx) return;
+
+    fill_black();
+
+    const int w = (int)MATRIX_W;
+    const int h = (int)MATRIX_H;
+    const int cx = w / 2;
+    const int cy = h / 2;
+
+    const float t = (float)ctx->anim_ms * 0.0020f;
+
+    for (int k = 0; k < 4; k++) {
+        const float pulse = 0.55f + 0.45f * sinf(t + (float)k * 0.9f);
+        int hw = (int)((10 + k * 6) * pulse);
+        int hh = (int)((5  + k * 3) * pulse);
+
+        if (hw < 2) hw = 2;
+        if (hh < 2) hh = 2;
+
+        const uint8_t hue = (uint8_t)((ctx->anim_ms >> 4) + (uint8_t)(k * 50));
+        uint8_t r,g,b;
+        ref_hsv_to_rgb(hue, 255, 200, &r,&g,&b);
+
+        for (int x = cx - hw; x <= cx + hw; x++) {
+            const int y1 = cy - hh;
+            const int y2 = cy + hh;
+            if ((unsigned)x < MATRIX_W) {
+                if ((unsigned)y1 < MATRIX_H) ref_ws2812_set_pixel_xy((uint16_t)x, (uint16_t)y1, r,g,b);
+                if ((unsigned)y2 < MATRIX_H) ref_ws2812_set_pixel_xy((uint16_t)x, (uint16_t)y2, r,g,b);
+            }
+        }
+
+        for (int y = cy - hh; y <= cy + hh; y++) {
+            const int x1 = cx - hw;
+            const int x2 = cx + hw;
+            if ((unsigned)y < MATRIX_H) {
+                if ((unsigned)x1 < MATRIX_W) ref_ws2812_set_pixel_xy((uint16_t)x1, (uint16_t)y, r,g,b);
+                if ((unsigned)x2 < MATRIX_W) ref_ws2812_set_pixel_xy((uint16_t)x2, (uint16_t)y, r,g,b);
+            }
+        }
+    }
+
+    uint32_t seed = 0xA53C91u ^ (ctx->anim_ms * 2654435761u);
+    for (int i = 0; i < 12; i++) {
+        const uint32_t rr = xorshift32(&seed);
+        const uint16_t x = (uint16_t)(rr % MATRIX_W);
+        const uint16_t y = (uint16_t)((rr >> 8) % MATRIX_H);
+        ref_ws2812_set_pixel_xy(x, y, 255, 255, 255);
+    }
+}
+
+void ref_fx_orbit_dots_render(fx_ctx_t *ctx)
+{
+    if (!ctx) return;
+
+    const uint32_t t = ctx->anim_ms;
+    const float tf = (float)t * 0.0012f;
+
+    const float cx = (float)(MATRIX_W - 1) * 0.5f;
+    const float cy = (float)(MATRIX_H - 1) * 0.5f;
+
+    const float r0 = 4.0f;
+    const float r1 = 6.0f;
+    const float r2 = 8.0f;
+
+    const float a0 = tf;
+    const float a1 = -tf * 1.3f;
+    const float a2 = tf * 0.7f;
+
+    const int x0 = (int)(cx + cosf(a0) * r0);
+    const int y0 = (int)(cy + sinf(a0) * r0);
+
+    const int x1 = (int)(cx + cosf(a1) * r1);
+    const int y1 = (int)(cy + sinf(a1) * r1);
+
+    const int x2 = (int)(cx + cosf(a2) * r2);
+    const int y2 = (int)(cy + sinf(a2) * r2);
+
+    fill_black();
+
+    if ((unsigned)x0 < MATRIX_W && (unsigned)y0 < MATRIX_H) ref_ws2812_set_pixel_xy((uint16_t)x0, (uint16_t)y0, 255, 80, 40);
+    if ((unsigned)x1 < MATRIX_W && (unsigned)y1 < MATRIX_H) ref_ws2812_set_pixel_xy((uint16_t)x1, (uint16_t)y1, 40, 255, 80);
+    if ((unsigned)x2 < MATRIX_W && (unsigned)y2 < MATRIX_H) ref_ws2812_set_pixel_xy((uint16_t)x2, (uint16_t)y2, 80, 40, 255);
+
+    // small trail
+    for (int i = 0; i < 8; i++) {
+        const float aa = tf - (float)i * 0.25f;
+        const int xt = (int)(cx + cosf(aa) * r1);
+        const int yt = (int)(cy + sinf(aa) * r1);
+        if ((unsigned)xt < MATRIX_W && (unsigned)yt < MATRIX_H) {
+            ref_ws2812_set_pixel_xy((uint16_t)xt, (uint16_t)yt, 40, 40, 40);
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+/*
+ * ref_fx_simple.h
+ *
+ * Эталон: простые эффекты и hsv_to_rgb как в baseline (09f7ec8) — цикл по пикселям,
+ * hsv_to_rgb на каждый и matrix_ws2812_set_pixel_xy() baseline-драйвера (ref_ws2812).
+ * CUBES / ORBIT DOTS — на float sinf/cosf, как до fx_math.
+ * Только для хостовых тестов.
+ */
+#include <stdint.h>
+
+#include "fx_engine.h"
+
+void ref_hsv_to_rgb(uint8_t h, uint8_t s, uint8_t v, uint8_t *r, uint8_t *g, uint8_t *b);
+
+void ref_fx_diag_rainbow_render(fx_ctx_t *ctx);
+void ref_fx_glitter_rainbow_render(fx_ctx_t *ctx);
+void ref_fx_radial_ripple_render(fx_ctx_t *ctx);
+void ref_fx_cubes_render(fx_ctx_t *ctx);
+void ref_fx_orbit_dots_render(fx_ctx_t *ctx);
@@ -0,0 +1,84 @@
+#include "ref_sparks.h"
+
+#include "matrix_ws2812.h"
+#include "ref_canvas.h"
+
+/* ---- fx_effects_fire.c @ 09f7ec8 (FIRE_W 16, FIRE_H 48, map_to_canvas — тождество) ---- */
+
+#define FIRE_W  MATRIX_W
+#define FIRE_H  MATRIX_H
+
+static inline uint8_t u8_clamp_i32(int v)
+{
+    if (v < 0)   return 0;
+    if (v > 255) return 255;
+    return (uint8_t)v;
+}
+
+static inline uint8_t scale_u8(uint8_t v, uint8_t scale)
+{
+    return (uint8_t)(((uint16_t)v * (uint16_t)scale + 127u) / 255u);
+}
+
+static inline int wrap_x(int x)
+{
+    return (x & (FIRE_W - 1));
+}
+
+void ref_sparks_step_and_render(ref_spark_t *s_spk, int cap, uint8_t life_max, uint8_t bri, int16_t wind_q8)
+{
+    for (int i = 0; i < cap; i++) {
+        ref_spark_t *s = &s_spk[i];
+        if (!s->alive) continue;
+
+        if (s->life == 0) { s->alive = false; continue; }
+        s->life--;
+
+        /* wind influence */
+        s->vx_q8 = (int16_t)(s->vx_q8 + (wind_q8 / 60));
+
+        s->x_q8 = (int16_t)(s->x_q8 + s->vx_q8);
+        s->y_q8 = (int16_t)(s->y_q8 + s->vy_q8);
+
+        int x = wrap_x((int)(s->x_q8 >> 8));
+        int y = (int)(s->y_q8 >> 8);
+
+        if (y < 0 || y >= FIRE_H) { s->alive = false; continue; }
+
+        /* life fade: map remaining life -> 80..255 (never fully off mid-flight) */
+        uint8_t life_k = (uint8_t)(
+            80 + (uint16_t)s->life * 175u / (uint16_t)life_max
+        );
+
+        /* render head + tail (additive) */
+        for (int t = 0; t <= (int)s->tail; t++) {
+            int yy = y - t;
+            if (yy < 0) break;
+
+            uint16_t cx = (uint16_t)x, cy = (uint16_t)yy;
+
+            /* tail attenuation */
+            uint8_t tail_k = 255;
+            if (t == 1) tail_k = 140;
+            else if (t >= 2) tail_k = 90;
+
+            uint8_t k = scale_u8(life_k, tail_k);
+
+            uint8_t r = scale_u8(s->r, k);
+            uint8_t g = scale_u8(s->g, k);
+            uint8_t b = scale_u8(s->b, k);
+
+            /* apply global brightness (variant A uses bri passed in) */
+            r = scale_u8(r, bri);
+            g = scale_u8(g, bri);
+            b = scale_u8(b, bri);
+
+            uint8_t cr, cg, cb;
+            (void)ref_canvas_get(cx, cy, &cr, &cg, &cb);
+            cr = u8_clamp_i32((int)cr + r);
+            cg = u8_clamp_i32((int)cg + g);
+            cb = u8_clamp_i32((int)cb + b);
+            ref_canvas_set(cx, cy, cr, cg, cb);
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+/*
+ * ref_sparks.h
+ *
+ * Эталон: искры FIRE как в baseline (09f7ec8) — массив struct с флагом alive фиксированной
+ * ёмкости, проход по всей ёмкости, аддитивная запись через get + clamp + set в canvas
+ * baseline (ref_canvas). Поле 16x48 без маппинга сегментов. Только для хостовых тестов.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    bool    alive;
+    int16_t x_q8;
+    int16_t y_q8;
+    int16_t vx_q8;
+    int16_t vy_q8;
+    uint8_t r, g, b;
+    uint8_t life;      // steps
+    uint8_t tail;      // 0 point, 1..2 tail length
+} ref_spark_t;
+
+/* Тик + отрисовка всех живых из s[0..cap) (sparks_step_and_render baseline) */
+void ref_sparks_step_and_render(ref_spark_t *s, int cap, uint8_t life_max, uint8_t bri, int16_t wind_q8);
@@ -0,0 +1,98 @@
+#include "matrix_ws2812.h"
+#include "ref_ws2812.h"
+
+#include <stdbool.h>
+
+/* ---- led_strip (espressif/led_strip 2.x, RMT backend): set_pixel в свой буфер ---- */
+
+static uint8_t s_strip[REF_WS2812_BYTES];
+
+static int ref_led_strip_set_pixel(uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    if (index >= MATRIX_LEDS_TOTAL) return -1;
+    const uint32_t start = index * 3u;
+    s_strip[start + 0] = (uint8_t)(green & 0xFF);
+    s_strip[start + 1] = (uint8_t)(red & 0xFF);
+    s_strip[start + 2] = (uint8_t)(blue & 0xFF);
+    return 0;
+}
+
+/* ---- matrix_ws2812.c @ 09f7ec8 ---- */
+
+static uint8_t s_bri = 32u;
+
+static inline uint8_t scale_bri(uint8_t v)
+{
+    return (uint8_t)(((uint16_t)v * (uint16_t)s_bri) / 255u);
+}
+
+void ref_ws2812_set_brightness(uint8_t bri)
+{
+    s_bri = bri;
+}
+
+uint16_t ref_ws2812_xy_to_index(uint16_t x, uint16_t y)
+{
+    if (x >= MATRIX_W || y >= MATRIX_H) {
+        return 0u;
+    }
+
+#if MATRIX_PANELS_HORIZONTAL
+    uint16_t panel = (uint16_t)(x / MATRIX_PANEL_W);
+    uint16_t lx    = (uint16_t)(x % MATRIX_PANEL_W);
+    uint16_t ly    = y;
+#else
+    uint16_t panel = (uint16_t)(y / MATRIX_PANEL_H);
+    uint16_t lx    = x;
+    uint16_t ly    = (uint16_t)(y % MATRIX_PANEL_H);
+#endif
+
+#if MATRIX_PANEL_ORDER_REVERSED
+    panel = (uint16_t)(MATRIX_PANELS - 1u - panel);
+#endif
+
+#if MATRIX_SERPENTINE
+    const bool row_even = ((ly & 1u) == 0u);
+    const bool ltr = MATRIX_ROW0_LTR ? row_even : !row_even;
+    const uint16_t local = (uint16_t)(ly * MATRIX_PANEL_W +
+                              (ltr ? lx : (MATRIX_PANEL_W - 1u - lx)));
+#else
+    const uint16_t local = (uint16_t)(ly * MATRIX_PANEL_W + lx);
+#endif
+
+    return (uint16_t)(panel * MATRIX_PANEL_LEDS + local);
+}
+
+void ref_ws2812_set_pixel_xy(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (x >= MATRIX_W || y >= MATRIX_H) {
+        return;
+    }
+
+    const uint16_t idx = ref_ws2812_xy_to_index(x, y);
+    (void)ref_led_strip_set_pixel(idx, scale_bri(r), scale_bri(g), scale_bri(b));
+}
+
+void ref_ws2812_scale_bytes(const uint8_t *src, uint8_t *dst, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        dst[i] = scale_bri(src[i]);
+    }
+}
+
+const uint8_t *ref_ws2812_strip(void)
+{
+    return s_strip;
+}
+
+/* ---- fx_canvas_present() @ 09f7ec8 ---- */
+
+void ref_ws2812_present_per_pixel(const uint8_t *rgb)
+{
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const uint32_t i = ((uint32_t)y * (uint32_t)MATRIX_W + (uint32_t)x) * 3u;
+            ref_ws2812_set_pixel_xy(x, y, rgb[i + 0], rgb[i + 1], rgb[i + 2]);
+        }
+    }
+}
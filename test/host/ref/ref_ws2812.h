@@ -0,0 +1,23 @@
+#pragma once
+/*
+ * ref_ws2812.h
+ *
+ * Эталон для сравнения: путь present -> matrix_ws2812 как в baseline (09f7ec8):
+ * на каждый пиксель — проверка границ, пересчёт "змейки"/панелей, scale_bri() (три деления
+ * на 255) и led_strip_set_pixel() в GRB-буфер led_strip. Только для хостовых тестов.
+ */
+#include <stdint.h>
+
+#define REF_WS2812_BYTES    (MATRIX_LEDS_TOTAL * 3u)
+
+void     ref_ws2812_set_brightness(uint8_t bri);
+uint16_t ref_ws2812_xy_to_index(uint16_t x, uint16_t y);
+void     ref_ws2812_set_pixel_xy(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b);
+/* GRB-буфер led_strip (индекс = индекс в цепочке, яркость уже применена) */
+const uint8_t *ref_ws2812_strip(void);
+
+/* Только яркость baseline: scale_bri() на каждый байт кадра (n байт) */
+void     ref_ws2812_scale_bytes(const uint8_t *src, uint8_t *dst, uint32_t n);
+
+/* baseline fx_canvas_present(): 768 вызовов set_pixel_xy из row-major RGB кадра */
+void     ref_ws2812_present_per_pixel(const uint8_t *rgb);
@@ -0,0 +1,32 @@
+#pragma once
+/* host stub: RMT encoder API (раскладка rmt_symbol_word_t — как у ESP32-S3) */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+typedef struct rmt_channel_t *rmt_channel_handle_t;
+typedef struct rmt_encoder_t *rmt_encoder_handle_t;
+
+typedef union {
+    struct {
+        uint16_t duration0 : 15;
+        uint16_t level0 : 1;
+        uint16_t duration1 : 15;
+        uint16_t level1 : 1;
+    };
+    uint32_t val;
+} rmt_symbol_word_t;
+
+typedef size_t (*rmt_encode_simple_cb_t)(const void *data, size_t data_size,
+                                         size_t symbols_written, size_t symbols_free,
+                                         rmt_symbol_word_t *symbols, bool *done, void *arg);
+
+typedef struct {
+    rmt_encode_simple_cb_t callback;
+    void  *arg;
+    size_t min_chunk_size;
+} rmt_simple_encoder_config_t;
+
+esp_err_t rmt_new_simple_encoder(const rmt_simple_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder);
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t encoder);
@@ -0,0 +1,53 @@
+#pragma once
+/* host stub: RMT TX. Передача — синхронная (см. host_rmt.h): энкодер прогоняется целиком
+ * внутри rmt_transmit(), байты и символы сохраняются для проверок. */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/rmt_encoder.h"
+
+typedef int rmt_clock_source_t;
+#define RMT_CLK_SRC_DEFAULT 1
+
+typedef struct {
+    int gpio_num;
+    rmt_clock_source_t clk_src;
+    uint32_t resolution_hz;
+    size_t mem_block_symbols;
+    size_t trans_queue_depth;
+    int intr_priority;
+    struct {
+        uint32_t invert_out : 1;
+        uint32_t with_dma : 1;
+    } flags;
+} rmt_tx_channel_config_t;
+
+typedef struct {
+    int loop_count;
+    struct {
+        uint32_t eot_level : 1;
+        uint32_t queue_nonblocking : 1;
+    } flags;
+} rmt_transmit_config_t;
+
+typedef struct {
+    size_t num_symbols;
+} rmt_tx_done_event_data_t;
+
+typedef bool (*rmt_tx_done_callback_t)(rmt_channel_handle_t tx_chan,
+                                       const rmt_tx_done_event_data_t *edata, void *user_ctx);
+
+typedef struct {
+    rmt_tx_done_callback_t on_trans_done;
+} rmt_tx_event_callbacks_t;
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *config, rmt_channel_handle_t *ret_chan);
+esp_err_t rmt_transmit(rmt_channel_handle_t chan, rmt_encoder_handle_t encoder,
+                       const void *payload, size_t payload_bytes, const rmt_transmit_config_t *config);
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t chan, int timeout_ms);
+esp_err_t rmt_tx_register_event_callbacks(rmt_channel_handle_t chan,
+                                          const rmt_tx_event_callbacks_t *cbs, void *user_data);
+esp_err_t rmt_enable(rmt_channel_handle_t chan);
+esp_err_t rmt_disable(rmt_channel_handle_t chan);
+esp_err_t rmt_del_channel(rmt_channel_handle_t chan);
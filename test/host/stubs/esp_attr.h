@@ -0,0 +1,4 @@
+#pragma once
+/* host stub: размещение в IRAM/DRAM на хосте ничего не значит */
+#define IRAM_ATTR
+#define DRAM_ATTR
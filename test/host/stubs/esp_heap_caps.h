@@ -0,0 +1,18 @@
+#pragma once
+/* host stub: heap_caps_* — libc, флаги памяти на хосте ничего не значат */
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT         (1u << 2)
+#define MALLOC_CAP_INTERNAL     (1u << 11)
+
+static inline void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+static inline void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
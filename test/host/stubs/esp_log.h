@@ -0,0 +1,16 @@
+#pragma once
+/* host stub: логи модулей молчат, если не собрано с -DHOST_LOG=1 */
+#include <stdio.h>
+
+#ifndef HOST_LOG
+#define HOST_LOG 0
+#endif
+
+#define HOST_LOG_PRINT(lvl, tag, fmt, ...) \
+    do { if (HOST_LOG) printf("%s (%s) " fmt "\n", lvl, tag, ##__VA_ARGS__); } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) HOST_LOG_PRINT("E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) HOST_LOG_PRINT("W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) HOST_LOG_PRINT("I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) HOST_LOG_PRINT("D", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) HOST_LOG_PRINT("V", tag, fmt, ##__VA_ARGS__)
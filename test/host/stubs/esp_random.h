@@ -0,0 +1,6 @@
+#pragma once
+/* host stub: детерминированный ГПСЧ (xorshift32), зерно задаёт тест */
+#include <stdint.h>
+
+uint32_t esp_random(void);
+void     host_random_seed(uint32_t seed);
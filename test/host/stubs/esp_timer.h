@@ -0,0 +1,9 @@
+#pragma once
+/* host stub: esp_timer_get_time() = CLOCK_MONOTONIC в us; host_timer_step_us() — шаговые часы теста */
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+/* step > 0: каждый esp_timer_get_time() = прошлое значение + step (пара замеров вокруг
+ * участка без своих вызовов часов даёт ровно step); 0 — снова CLOCK_MONOTONIC */
+void host_timer_step_us(int64_t step);
@@ -0,0 +1,17 @@
+#pragma once
+/* host stub: FreeRTOS поверх pthreads (freertos_host.c), тик как в sdkconfig — 10 ms */
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t      TickType_t;
+typedef long          BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              1
+#define pdFAIL              0
+#define portMAX_DELAY       0xFFFFFFFFu
+#define configTICK_RATE_HZ  100
+#define portTICK_PERIOD_MS  (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000u))
@@ -0,0 +1,10 @@
+#pragma once
+/* host stub: binary semaphore на mutex + cond */
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_sem_s *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks);
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t s);
+void              vSemaphoreDelete(SemaphoreHandle_t s);
@@ -0,0 +1,13 @@
+#pragma once
+/* host stub: задачи — pthread'ы, core/prio игнорируются; task notify — счётчик (Give/Take) */
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_task_s *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t   xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                     UBaseType_t prio, TaskHandle_t *out, BaseType_t core);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t   xTaskNotifyGive(TaskHandle_t t);
+uint32_t     ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+void         vTaskDelay(TickType_t ticks);
@@ -0,0 +1,256 @@
+/*
+ * freertos_host.c
+ *
+ * FreeRTOS для хостовых тестов поверх pthreads — ровно то, что трогают модули лампы:
+ *   - xTaskCreatePinnedToCore(): отдельный pthread (core/prio игнорируются, задача живёт до exit);
+ *   - task notify как счётчик: xTaskNotifyGive() / ulTaskNotifyTake() с таймаутом в тиках;
+ *   - binary semaphore: Give насыщается на 1, Take с таймаутом.
+ * Плюс esp_random() (xorshift32 с зерном теста) и esp_partition поверх буферов теста.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_random.h"
+#include "esp_partition.h"
+
+/* ============================================================
+ * Время
+ * ============================================================ */
+
+static void deadline_after_ticks(struct timespec *ts, TickType_t ticks)
+{
+    clock_gettime(CLOCK_REALTIME, ts);
+    const uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000ull;
+    ts->tv_sec  += (time_t)(ns / 1000000000ull);
+    ts->tv_nsec += (long)(ns % 1000000000ull);
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/* Ждать cond, пока *count == 0; false — таймаут */
+static bool wait_count(pthread_mutex_t *m, pthread_cond_t *c, const uint32_t *count, TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) {
+        while (*count == 0) pthread_cond_wait(c, m);
+        return true;
+    }
+    struct timespec ts;
+    deadline_after_ticks(&ts, ticks);
+    while (*count == 0) {
+        if (pthread_cond_timedwait(c, m, &ts) == ETIMEDOUT) return *count != 0;
+    }
+    return true;
+}
+
+/* ============================================================
+ * Задачи
+ * ============================================================ */
+
+struct host_task_s {
+    pthread_t       th;
+    pthread_mutex_t mu;
+    pthread_cond_t  cv;
+    uint32_t        notify;
+    TaskFunction_t  fn;
+    void           *arg;
+};
+
+static __thread struct host_task_s *s_cur_task = NULL;
+static struct host_task_s s_main_task = {
+    .mu = PTHREAD_MUTEX_INITIALIZER,
+    .cv = PTHREAD_COND_INITIALIZER,
+};
+
+static void *task_entry(void *p)
+{
+    struct host_task_s *t = (struct host_task_s *)p;
+    s_cur_task = t;
+    t->fn(t->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *out, BaseType_t core)
+{
+    (void)name; (void)stack; (void)prio; (void)core;
+
+    struct host_task_s *t = calloc(1, sizeof(*t));
+    if (!t) return pdFAIL;
+    pthread_mutex_init(&t->mu, NULL);
+    pthread_cond_init(&t->cv, NULL);
+    t->fn = fn;
+    t->arg = arg;
+    if (out) *out = t;   // до старта: задача может сразу ждать notify
+
+    if (pthread_create(&t->th, NULL, task_entry, t) != 0) {
+        if (out) *out = NULL;
+        free(t);
+        return pdFAIL;
+    }
+    pthread_detach(t->th);
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return s_cur_task ? s_cur_task : &s_main_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t t)
+{
+    if (!t) return pdFAIL;
+    pthread_mutex_lock(&t->mu);
+    t->notify++;
+    pthread_cond_signal(&t->cv);
+    pthread_mutex_unlock(&t->mu);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    struct host_task_s *t = xTaskGetCurrentTaskHandle();
+    pthread_mutex_lock(&t->mu);
+    uint32_t v = 0;
+    if (wait_count(&t->mu, &t->cv, &t->notify, ticks)) {
+        v = t->notify;
+        t->notify = clear_on_exit ? 0 : (t->notify - 1u);
+    }
+    pthread_mutex_unlock(&t->mu);
+    return v;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    const uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000ull;
+    const struct timespec ts = { .tv_sec = (time_t)(ns / 1000000000ull), .tv_nsec = (long)(ns % 1000000000ull) };
+    nanosleep(&ts, NULL);
+}
+
+/* ============================================================
+ * Семафоры
+ * ============================================================ */
+
+struct host_sem_s {
+    pthread_mutex_t mu;
+    pthread_cond_t  cv;
+    uint32_t        count;
+};
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    struct host_sem_s *s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    pthread_mutex_init(&s->mu, NULL);
+    pthread_cond_init(&s->cv, NULL);
+    return s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks)
+{
+    pthread_mutex_lock(&s->mu);
+    const bool ok = wait_count(&s->mu, &s->cv, &s->count, ticks);
+    if (ok) s->count = 0;
+    pthread_mutex_unlock(&s->mu);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s)
+{
+    pthread_mutex_lock(&s->mu);
+    const BaseType_t ok = (s->count == 0) ? pdTRUE : pdFALSE;
+    s->count = 1;
+    pthread_cond_signal(&s->cv);
+    pthread_mutex_unlock(&s->mu);
+    return ok;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t s)
+{
+    if (!s) return;
+    pthread_cond_destroy(&s->cv);
+    pthread_mutex_destroy(&s->mu);
+    free(s);
+}
+
+/* ============================================================
+ * esp_random / esp_partition
+ * ============================================================ */
+
+static uint32_t s_rng = 0x2545F491u;
+
+void host_random_seed(uint32_t seed)
+{
+    s_rng = seed ? seed : 0x2545F491u;
+}
+
+uint32_t esp_random(void)
+{
+    uint32_t x = s_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_rng = x;
+    return x;
+}
+
+#define HOST_PARTITIONS_MAX 4
+
+static esp_partition_t s_parts[HOST_PARTITIONS_MAX];
+static const void     *s_part_data[HOST_PARTITIONS_MAX];
+static uint32_t        s_parts_n = 0;
+
+void host_partition_add(const char *label, const void *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < s_parts_n; i++) {
+        if (strcmp(s_parts[i].label, label) == 0) {
+            s_parts[i].size = size;
+            s_part_data[i] = data;
+            return;
+        }
+    }
+    if (s_parts_n >= HOST_PARTITIONS_MAX) abort();
+    esp_partition_t *p = &s_parts[s_parts_n];
+    memset(p, 0, sizeof(*p));
+    strncpy(p->label, label, sizeof(p->label) - 1u);
+    p->size = size;
+    s_part_data[s_parts_n] = data;
+    s_parts_n++;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    (void)type; (void)subtype;
+    for (uint32_t i = 0; i < s_parts_n; i++) {
+        if (label && strcmp(s_parts[i].label, label) == 0) return &s_parts[i];
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *part, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle)
+{
+    (void)memory;
+    if (!part) return ESP_ERR_INVALID_ARG;
+    const uint32_t i = (uint32_t)(part - s_parts);
+    if (i >= s_parts_n || offset + size > part->size) return ESP_ERR_INVALID_ARG;
+    *out_ptr = (const uint8_t *)s_part_data[i] + offset;
+    if (out_handle) *out_handle = i;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+    (void)handle;
+}
@@ -0,0 +1,19 @@
+/*
+ * fx_deps_host.c
+ *
+ * Соседи эффектов, которых на хосте нет (аудио-часть): DOA и уровень ASR — "данных нет".
+ */
+
+#include "doa_probe.h"
+#include "asr_debug.h"
+
+bool doa_probe_get_snapshot(doa_snapshot_t *out)
+{
+    (void)out;
+    return false;
+}
+
+uint16_t asr_debug_get_level(void)
+{
+    return 0;
+}
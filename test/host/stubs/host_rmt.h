@@ -0,0 +1,23 @@
+#pragma once
+/* Хостовый RMT: что ушло "в линию" последним rmt_transmit() и счётчики вызовов */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define HOST_RMT_MAX_BYTES      (4u * 1024u)
+#define HOST_RMT_MAX_SYMBOLS    (HOST_RMT_MAX_BYTES * 8u + 1u)
+
+typedef struct {
+    uint8_t  bytes[HOST_RMT_MAX_BYTES];        // payload последней передачи
+    size_t   n_bytes;
+    uint32_t symbols[HOST_RMT_MAX_SYMBOLS];    // что выдал энкодер (rmt_symbol_word_t.val)
+    size_t   n_symbols;
+    uint32_t transmits;                        // rmt_transmit() всего
+    uint32_t waits;                            // rmt_tx_wait_all_done() всего
+    size_t   chunk_symbols;                    // "память канала" на один вызов callback (0 = 64)
+    bool     no_encode;                        // true: только payload, энкодер не гоняем (бенчмарки)
+} host_rmt_t;
+
+extern host_rmt_t g_host_rmt;
+
+void host_rmt_reset(void);
@@ -0,0 +1,158 @@
+/*
+ * idf_host.c
+ *
+ * Минимальная хостовая реализация API ESP-IDF, которые трогают чистые модули лампы:
+ *   - esp_timer_get_time(): CLOCK_MONOTONIC или шаговые часы теста (host_timer_step_us);
+ *   - RMT TX + simple encoder: передача синхронная, callback энкодера прогоняется целиком
+ *     кусками по chunk_symbols (как память канала в ISR), payload и символы — в g_host_rmt.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "driver/rmt_tx.h"
+#include "host_rmt.h"
+
+host_rmt_t g_host_rmt;
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                return "ESP_OK";
+    case ESP_FAIL:              return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+    default:                    return "ESP_ERR_?";
+    }
+}
+
+static int64_t s_timer_step_us = 0;
+static int64_t s_timer_now_us  = 0;
+
+void host_timer_step_us(int64_t step)
+{
+    s_timer_step_us = step;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    if (s_timer_step_us > 0) {
+        s_timer_now_us += s_timer_step_us;
+        return s_timer_now_us;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* ============================================================
+ * RMT
+ * ============================================================ */
+
+struct rmt_channel_t {
+    rmt_tx_done_callback_t on_done;
+    void *ctx;
+};
+
+struct rmt_encoder_t {
+    rmt_simple_encoder_config_t cfg;
+};
+
+void host_rmt_reset(void)
+{
+    const size_t chunk = g_host_rmt.chunk_symbols;
+    const bool no_encode = g_host_rmt.no_encode;
+    memset(&g_host_rmt, 0, sizeof(g_host_rmt));
+    g_host_rmt.chunk_symbols = chunk;
+    g_host_rmt.no_encode = no_encode;
+}
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *config, rmt_channel_handle_t *ret_chan)
+{
+    if (!config || !ret_chan) return ESP_ERR_INVALID_ARG;
+    *ret_chan = calloc(1, sizeof(struct rmt_channel_t));
+    return *ret_chan ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t rmt_new_simple_encoder(const rmt_simple_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
+{
+    if (!config || !ret_encoder || !config->callback) return ESP_ERR_INVALID_ARG;
+    *ret_encoder = calloc(1, sizeof(struct rmt_encoder_t));
+    if (!*ret_encoder) return ESP_ERR_NO_MEM;
+    (*ret_encoder)->cfg = *config;
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t encoder)
+{
+    free(encoder);
+    return ESP_OK;
+}
+
+esp_err_t rmt_tx_register_event_callbacks(rmt_channel_handle_t chan,
+                                          const rmt_tx_event_callbacks_t *cbs, void *user_data)
+{
+    if (!chan || !cbs) return ESP_ERR_INVALID_ARG;
+    chan->on_done = cbs->on_trans_done;
+    chan->ctx = user_data;
+    return ESP_OK;
+}
+
+esp_err_t rmt_enable(rmt_channel_handle_t chan)  { return chan ? ESP_OK : ESP_ERR_INVALID_ARG; }
+esp_err_t rmt_disable(rmt_channel_handle_t chan) { return chan ? ESP_OK : ESP_ERR_INVALID_ARG; }
+
+esp_err_t rmt_del_channel(rmt_channel_handle_t chan)
+{
+    free(chan);
+    return ESP_OK;
+}
+
+esp_err_t rmt_transmit(rmt_channel_handle_t chan, rmt_encoder_handle_t encoder,
+                       const void *payload, size_t payload_bytes, const rmt_transmit_config_t *config)
+{
+    (void)config;
+    if (!chan || !encoder || !payload) return ESP_ERR_INVALID_ARG;
+    if (payload_bytes > HOST_RMT_MAX_BYTES) return ESP_ERR_INVALID_SIZE;
+
+    host_rmt_t *r = &g_host_rmt;
+    memcpy(r->bytes, payload, payload_bytes);
+    r->n_bytes = payload_bytes;
+    r->n_symbols = 0;
+    r->transmits++;
+
+    const size_t chunk = r->chunk_symbols ? r->chunk_symbols : 64u;
+    bool done = r->no_encode;
+    while (!done) {
+        size_t free_syms = HOST_RMT_MAX_SYMBOLS - r->n_symbols;
+        if (free_syms > chunk) free_syms = chunk;
+        if (free_syms < encoder->cfg.min_chunk_size) return ESP_ERR_INVALID_SIZE;
+
+        const size_t n = encoder->cfg.callback(payload, payload_bytes, r->n_symbols, free_syms,
+                                               (rmt_symbol_word_t *)&r->symbols[r->n_symbols],
+                                               &done, encoder->cfg.arg);
+        if (n > free_syms) return ESP_FAIL;
+        if (n == 0 && !done) return ESP_FAIL;   // callback не продвинулся при min_chunk свободных
+        r->n_symbols += n;
+    }
+
+    if (chan->on_done) {
+        const rmt_tx_done_event_data_t ev = { .num_symbols = r->n_symbols };
+        (void)chan->on_done(chan, &ev, chan->ctx);
+    }
+    return ESP_OK;
+}
+
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t chan, int timeout_ms)
+{
+    (void)timeout_ms;
+    if (!chan) return ESP_ERR_INVALID_ARG;
+    g_host_rmt.waits++;
+    return ESP_OK;
+}
@@ -0,0 +1,446 @@
+/*
+ * test_canvas.c — bulk-ядра и кольцо строк fx_canvas против baseline (user-013, user-014)
+ *
+ *   - dim (все 256 scale), clear, shift_down / shift_towards_y0 / shift_up дают те же байты,
+ *     что baseline (попиксельный get/set, деление на 255), в том числе при ненулевом кольце;
+ *   - replay: 200k случайных операций (set/get/row/load/dim/shift/clear) на обоих canvas,
+ *     каждый get() совпадает, периодически — весь кадр и то, что present() отдал в линию
+ *     (выходной каскад линейный: при яркости 255 байт в линии == байт canvas);
+ *   - present с HDR в части строк (между ними bulk-серии, шов кольца) == present кадра flatten;
+ *   - слои (user-015): REPLACE / ALPHA / MAX / ADD против попиксельной формулы режима, a == 0 прозрачен;
+ *     чистый слой не сводится, dirty rect — bounding box записей и сбрасывается после present;
+ *   - бенчмарки: dim, shift, clear и кадр SNOW FALL (dim + shift) было/стало.
+ */
+#include "host_test.h"
+#include "host_rmt.h"
+
+#include "matrix_ws2812.h"
+#include "fx_canvas.h"
+#include "ref/ref_ws2812.h"
+#include "ref/ref_canvas.h"
+
+#define FRAME_BYTES     ((uint32_t)MATRIX_W * MATRIX_H * 3u)
+#define REPLAY_OPS      200000u
+
+static uint8_t s_rgb[FRAME_BYTES];
+static uint8_t s_flat[FRAME_BYTES];
+
+static uint32_t s_seed = 0x13579BDFu;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525u + 1013904223u;
+    return s_seed >> 8;
+}
+
+static void fill_random(uint8_t *rgb)
+{
+    for (uint32_t i = 0; i < FRAME_BYTES; i++) rgb[i] = (uint8_t)rnd();
+}
+
+static void load_both(const uint8_t *rgb)
+{
+    fx_canvas_load(rgb);
+    memcpy(ref_canvas_buf(), rgb, FRAME_BYTES);
+}
+
+static bool same_frame(void)
+{
+    fx_canvas_flatten(NULL, s_flat);
+    return memcmp(s_flat, ref_canvas_buf(), FRAME_BYTES) == 0;
+}
+
+/* present обоих: новый — через выходной каскад в RMT, baseline — в strip led_strip */
+static bool same_present(void)
+{
+    fx_canvas_present();
+    if (matrix_ws2812_show() != ESP_OK) return false;
+    ref_canvas_present();
+    return g_host_rmt.n_bytes == REF_WS2812_BYTES &&
+           memcmp(g_host_rmt.bytes, ref_ws2812_strip(), REF_WS2812_BYTES) == 0;
+}
+
+/* ============================================================
+ * user-013: ядра
+ * ============================================================ */
+
+static void test_dim_all_scales(void)
+{
+    uint32_t bad = 0;
+    for (uint32_t scale = 0; scale < 256u; scale++) {
+        fill_random(s_rgb);
+        load_both(s_rgb);
+        // половина прогонов — со сдвинутым кольцом
+        if (scale & 1u) {
+            for (uint32_t k = 0; k < scale % 7u + 1u; k++) {
+                fx_canvas_shift_towards_y0(1, 2, 3);
+                ref_canvas_shift_towards_y0(1, 2, 3);
+            }
+        }
+        fx_canvas_dim((uint8_t)scale);
+        ref_canvas_dim((uint8_t)scale);
+        if (!same_frame()) bad++;
+    }
+    CHECK_EQ_U(bad, 0);
+}
+
+static void test_clear_and_shifts(void)
+{
+    static const uint8_t colors[][3] = {
+        { 0, 0, 0 }, { 255, 255, 255 }, { 7, 7, 7 }, { 1, 2, 3 }, { 200, 0, 17 }, { 0, 128, 255 },
+    };
+    uint32_t bad = 0;
+
+    for (size_t c = 0; c < sizeof(colors) / sizeof(colors[0]); c++) {
+        const uint8_t *k = colors[c];
+
+        fill_random(s_rgb);
+        load_both(s_rgb);
+        fx_canvas_clear(k[0], k[1], k[2]);
+        ref_canvas_clear(k[0], k[1], k[2]);
+        if (!same_frame()) bad++;
+
+        for (uint32_t n = 1; n <= MATRIX_H + 3u; n++) {
+            fill_random(s_rgb);
+            load_both(s_rgb);
+            for (uint32_t i = 0; i < n; i++) {
+                fx_canvas_shift_down(k[0], k[1], k[2]);
+                ref_canvas_shift_down(k[0], k[1], k[2]);
+            }
+            if (!same_frame()) bad++;
+
+            load_both(s_rgb);
+            for (uint32_t i = 0; i < n; i++) {
+                fx_canvas_shift_towards_y0(k[0], k[1], k[2]);
+                ref_canvas_shift_towards_y0(k[0], k[1], k[2]);
+            }
+            if (!same_frame()) bad++;
+
+            load_both(s_rgb);
+            for (uint32_t i = 0; i < n; i++) {
+                fx_canvas_shift_up(k[0], k[1], k[2]);
+                ref_canvas_shift_up(k[0], k[1], k[2]);
+            }
+            if (!same_frame()) bad++;
+        }
+    }
+    CHECK_EQ_U(bad, 0);
+}
+
+/* ============================================================
+ * user-020: present с HDR в отдельных строках
+ * ============================================================ */
+
+static void hdr_sparse(void)
+{
+    for (uint16_t y = 1; y < MATRIX_H; y = (uint16_t)(y + 2u + y % 5u)) {
+        fx_canvas_hdr_add((uint16_t)(y % MATRIX_W), y, 200, 120, 40);
+        fx_canvas_hdr_add((uint16_t)((y * 7u) % MATRIX_W), y, 30, 60, 90);
+    }
+}
+
+/* Тронутые строки идут через tone-map, чистые между ними — bulk: в линии то же, что flatten */
+static void test_present_hdr_rows(void)
+{
+#if FX_CANVAS_HDR_ENABLE
+    uint32_t bad = 0;
+
+    for (uint32_t n = 0; n < 8u; n++) {
+        fill_random(s_rgb);
+        load_both(s_rgb);
+        for (uint32_t i = 0; i < n * 5u; i++) {   // кольцо: шов режет bulk-серии
+            fx_canvas_shift_towards_y0(1, 2, 3);
+            ref_canvas_shift_towards_y0(1, 2, 3);
+        }
+        hdr_sparse();
+        fx_canvas_flatten(NULL, s_flat);
+        memcpy(ref_canvas_buf(), s_flat, FRAME_BYTES);
+
+        hdr_sparse();
+        if (!same_present()) bad++;
+    }
+    CHECK_EQ_U(bad, 0);
+#endif
+}
+
+/* ============================================================
+ * user-015: слои
+ * ============================================================ */
+
+/* present -> линия (линейный каскад, яркость 255) -> кадр обратно в row-major RGB */
+static void present_to_rgb(uint8_t *out)
+{
+    fx_canvas_present();
+    (void)matrix_ws2812_show();
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const uint8_t *w = &g_host_rmt.bytes[(uint32_t)matrix_ws2812_xy_to_index(x, y) * 3u];
+            uint8_t *o = &out[((uint32_t)y * MATRIX_W + x) * 3u];
+            o[0] = w[1];   // GRB
+            o[1] = w[0];
+            o[2] = w[2];
+        }
+    }
+}
+
+/* Эталон режима на один канал (формулы fx_canvas.h; ALPHA — каждое слагаемое floor(./255)) */
+static uint8_t ref_blend(fx_blend_t mode, uint8_t d, uint8_t s, uint8_t a)
+{
+    if (a == 0) return d;
+    switch (mode) {
+    case FX_BLEND_REPLACE: return s;
+    case FX_BLEND_ADD:     return (uint8_t)((d + s > 255) ? 255 : d + s);
+    case FX_BLEND_MAX:     return s > d ? s : d;
+    case FX_BLEND_ALPHA:
+    default:               return (uint8_t)((uint32_t)s * a / 255u + (uint32_t)d * (255u - a) / 255u);
+    }
+}
+
+#define LAYER_X0   2u
+#define LAYER_X1   13u
+#define LAYER_Y0   5u
+#define LAYER_Y1   31u
+
+static void test_layer_blend_modes(void)
+{
+    static const struct { fx_blend_t mode; const char *name; } modes[] = {
+        { FX_BLEND_REPLACE, "REPLACE" }, { FX_BLEND_ALPHA, "ALPHA" },
+        { FX_BLEND_MAX, "MAX" },         { FX_BLEND_ADD, "ADD" },
+    };
+    static uint8_t layer[FRAME_BYTES * 4u / 3u];
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        uint32_t bad = 0, lerp_off = 0;
+        for (uint32_t rep = 0; rep < 4u; rep++) {
+            fill_random(s_rgb);
+            fx_canvas_load(s_rgb);
+            fx_layer_set_blend(FX_LAYER_OVERLAY, modes[m].mode);
+
+            // прямоугольник пикселей слоя; a: 0 (прозрачен), 255 и случайные промежуточные
+            memset(layer, 0, sizeof(layer));
+            for (uint16_t y = LAYER_Y0; y < LAYER_Y1; y++) {
+                for (uint16_t x = LAYER_X0; x < LAYER_X1; x++) {
+                    uint8_t *l = &layer[((uint32_t)y * MATRIX_W + x) * 4u];
+                    const uint32_t r = rnd();
+                    l[0] = (uint8_t)rnd(); l[1] = (uint8_t)rnd(); l[2] = (uint8_t)rnd();
+                    l[3] = (r % 8u == 0u) ? 0u : (r % 8u == 1u) ? 255u : (uint8_t)(r >> 8);
+                    fx_layer_set(FX_LAYER_OVERLAY, x, y, l[0], l[1], l[2], l[3]);
+                }
+            }
+            present_to_rgb(s_flat);
+
+            for (uint32_t p = 0; p < (uint32_t)MATRIX_W * MATRIX_H; p++) {
+                const uint8_t *l = &layer[p * 4u];
+                for (uint32_t c = 0; c < 3u; c++) {
+                    const uint8_t d = s_rgb[p * 3u + c];
+                    if (s_flat[p * 3u + c] != ref_blend(modes[m].mode, d, l[c], l[3])) bad++;
+                    if (modes[m].mode == FX_BLEND_ALPHA && l[3]) {
+                        // и от точного lerp (floor) — не больше чем на 1 вниз
+                        const int32_t lerp = (int32_t)(((uint32_t)l[c] * l[3] + (uint32_t)d * (255u - l[3])) / 255u);
+                        const int32_t diff = lerp - (int32_t)s_flat[p * 3u + c];
+                        if (diff < 0 || diff > 1) lerp_off++;
+                    }
+                }
+            }
+        }
+        if (bad || lerp_off) printf("  blend %s: bad=%u lerp_off=%u\n", modes[m].name, (unsigned)bad, (unsigned)lerp_off);
+        CHECK_EQ_U(bad, 0);
+        CHECK_EQ_U(lerp_off, 0);
+    }
+    fx_layer_set_blend(FX_LAYER_OVERLAY, FX_BLEND_REPLACE);
+}
+
+static void test_layer_dirty_rect(void)
+{
+    uint16_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+    fill_random(s_rgb);
+    fx_canvas_load(s_rgb);
+
+    // чистый слой: dirty нет, present отдаёт базу как есть
+    CHECK(!fx_layer_get_dirty(FX_LAYER_OVERLAY, NULL, NULL, NULL, NULL));
+    CHECK(!fx_layer_get_dirty(FX_LAYER_PARTICLES, NULL, NULL, NULL, NULL));
+    present_to_rgb(s_flat);
+    CHECK_MEM(s_flat, s_rgb, FRAME_BYTES);
+
+    // dirty rect — bounding box записей, [x0,x1) x [y0,y1)
+    fx_layer_set(FX_LAYER_OVERLAY, 9, 40, 255, 0, 0, 255);
+    fx_layer_set(FX_LAYER_OVERLAY, 3, 12, 0, 255, 0, 255);
+    CHECK(fx_layer_get_dirty(FX_LAYER_OVERLAY, &x0, &y0, &x1, &y1));
+    CHECK_EQ_U(x0, 3);
+    CHECK_EQ_U(y0, 12);
+    CHECK_EQ_U(x1, 10);
+    CHECK_EQ_U(y1, 41);
+    CHECK(!fx_layer_get_dirty(FX_LAYER_PARTICLES, NULL, NULL, NULL, NULL));
+
+    // очищенный до present слой снова чистый и не сводится
+    fx_layer_clear(FX_LAYER_OVERLAY);
+    CHECK(!fx_layer_get_dirty(FX_LAYER_OVERLAY, NULL, NULL, NULL, NULL));
+    present_to_rgb(s_flat);
+    CHECK_MEM(s_flat, s_rgb, FRAME_BYTES);
+
+    // present сводит и сбрасывает: следующий кадр без записей — снова база,
+    // следующая запись начинает rect заново (без хвоста прошлого кадра)
+    fx_layer_set(FX_LAYER_OVERLAY, 9, 40, 255, 0, 0, 255);
+    fx_layer_add(FX_LAYER_PARTICLES, 1, 1, 10, 10, 10);
+    present_to_rgb(s_flat);
+    CHECK(s_flat[(40u * MATRIX_W + 9u) * 3u] == 255u);
+    CHECK(!fx_layer_get_dirty(FX_LAYER_OVERLAY, NULL, NULL, NULL, NULL));
+    CHECK(!fx_layer_get_dirty(FX_LAYER_PARTICLES, NULL, NULL, NULL, NULL));
+    present_to_rgb(s_flat);
+    CHECK_MEM(s_flat, s_rgb, FRAME_BYTES);
+
+    fx_layer_set(FX_LAYER_OVERLAY, 0, 0, 1, 2, 3, 255);
+    CHECK(fx_layer_get_dirty(FX_LAYER_OVERLAY, &x0, &y0, &x1, &y1));
+    CHECK_EQ_U(x0, 0);
+    CHECK_EQ_U(y0, 0);
+    CHECK_EQ_U(x1, 1);
+    CHECK_EQ_U(y1, 1);
+    fx_layer_clear(FX_LAYER_OVERLAY);
+}
+
+/* ============================================================
+ * user-014: replay
+ * ============================================================ */
+
+static void test_replay(void)
+{
+    uint32_t bad_get = 0, bad_frame = 0, bad_present = 0, presents = 0;
+
+    fill_random(s_rgb);
+    load_both(s_rgb);
+
+    for (uint32_t op = 0; op < REPLAY_OPS; op++) {
+        const uint32_t r = rnd();
+        const uint8_t cr = (uint8_t)rnd(), cg = (uint8_t)rnd(), cb = (uint8_t)rnd();
+        // координаты с выходом за край: set/get должны его игнорировать одинаково
+        const uint16_t x = (uint16_t)(rnd() % (MATRIX_W + 2u));
+        const uint16_t y = (uint16_t)(rnd() % (MATRIX_H + 2u));
+
+        switch (r % 16u) {
+        case 0: case 1: case 2: case 3: case 4:
+            fx_canvas_set(x, y, cr, cg, cb);
+            ref_canvas_set(x, y, cr, cg, cb);
+            break;
+        case 5: case 6: case 7: {
+            uint8_t a[3] = { 0 }, b[3] = { 0 };
+            const bool ok_a = fx_canvas_get(x, y, &a[0], &a[1], &a[2]);
+            const bool ok_b = ref_canvas_get(x, y, &b[0], &b[1], &b[2]);
+            if (ok_a != ok_b || memcmp(a, b, 3) != 0) bad_get++;
+            break;
+        }
+        case 8: {
+            // строка напрямую (эффекты-shader'ы): логическая y
+            uint8_t *row = fx_canvas_row(y);
+            if ((row != NULL) != (y < MATRIX_H)) bad_get++;
+            if (row) {
+                for (uint16_t i = 0; i < MATRIX_W; i++) {
+                    row[i * 3u + 0] = (uint8_t)(cr + i);
+                    row[i * 3u + 1] = cg;
+                    row[i * 3u + 2] = (uint8_t)(cb ^ i);
+                    ref_canvas_set(i, y, (uint8_t)(cr + i), cg, (uint8_t)(cb ^ i));
+                }
+            }
+            break;
+        }
+        case 9:
+            fx_canvas_dim(cr);
+            ref_canvas_dim(cr);
+            break;
+        case 10:
+            fx_canvas_shift_down(cr, cg, cb);
+            ref_canvas_shift_down(cr, cg, cb);
+            break;
+        case 11: case 12:
+            fx_canvas_shift_towards_y0(cr, cg, cb);
+            ref_canvas_shift_towards_y0(cr, cg, cb);
+            break;
+        case 13:
+            fx_canvas_shift_up(cr, cg, cb);
+            ref_canvas_shift_up(cr, cg, cb);
+            break;
+        case 14:
+            if ((r >> 4) % 64u == 0u) {
+                fx_canvas_clear(cr, cg, cb);
+                ref_canvas_clear(cr, cg, cb);
+            }
+            break;
+        default:
+            if ((r >> 4) % 256u == 0u) {
+                fill_random(s_rgb);
+                load_both(s_rgb);
+            }
+            break;
+        }
+
+        if (op % 1000u == 999u && !same_frame()) bad_frame++;
+        if (op % 5000u == 4999u) {
+            presents++;
+            if (!same_present()) bad_present++;
+        }
+    }
+
+    CHECK_EQ_U(bad_get, 0);
+    CHECK_EQ_U(bad_frame, 0);
+    CHECK_EQ_U(bad_present, 0);
+    printf("replay: %u ops, %u frame checks, %u present checks\n",
+           (unsigned)REPLAY_OPS, (unsigned)(REPLAY_OPS / 1000u), (unsigned)presents);
+}
+
+/* ============================================================
+ * Бенчмарки
+ * ============================================================ */
+
+static void bench(void)
+{
+    double o = 0.0, n = 0.0;
+
+    fill_random(s_rgb);
+    load_both(s_rgb);
+
+    HOST_BENCH(o, 2000, ref_canvas_dim(250));
+    HOST_BENCH(n, 2000, fx_canvas_dim(250));
+    host_bench_report("canvas dim(250)", o, n);
+
+    HOST_BENCH(o, 2000, ref_canvas_shift_towards_y0(0, 0, 0));
+    HOST_BENCH(n, 2000, fx_canvas_shift_towards_y0(0, 0, 0));
+    host_bench_report("canvas shift_towards_y0", o, n);
+
+    HOST_BENCH(o, 2000, ref_canvas_shift_down(0, 0, 0));
+    HOST_BENCH(n, 2000, fx_canvas_shift_down(0, 0, 0));
+    host_bench_report("canvas shift_down", o, n);
+
+    HOST_BENCH(o, 2000, ref_canvas_shift_up(0, 0, 0));
+    HOST_BENCH(n, 2000, fx_canvas_shift_up(0, 0, 0));
+    host_bench_report("canvas shift_up", o, n);
+
+    HOST_BENCH(o, 2000, ref_canvas_clear(10, 20, 30));
+    HOST_BENCH(n, 2000, fx_canvas_clear(10, 20, 30));
+    host_bench_report("canvas clear(rgb)", o, n);
+
+    // кадр SNOW FALL: затухание + сдвиг к y0
+    HOST_BENCH(o, 2000, { ref_canvas_dim(235); ref_canvas_shift_towards_y0(0, 0, 0); });
+    HOST_BENCH(n, 2000, { fx_canvas_dim(235); fx_canvas_shift_towards_y0(0, 0, 0); });
+    host_bench_report("canvas snow frame (dim+shift)", o, n);
+
+    fx_canvas_flatten(NULL, s_flat);
+    g_host_sink = s_flat[5] ^ ref_canvas_buf()[5];
+}
+
+int main(void)
+{
+    g_host_rmt.no_encode = true;
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    matrix_ws2812_set_brightness(255);
+    ref_ws2812_set_brightness(255);
+
+    test_dim_all_scales();
+    test_clear_and_shifts();
+    test_layer_blend_modes();
+    test_layer_dirty_rect();
+    test_replay();
+    test_present_hdr_rows();
+    bench();
+
+    return host_test_done("test_canvas");
+}
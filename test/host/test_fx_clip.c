@@ -0,0 +1,310 @@
+/*
+ * test_fx_clip.c — декод клипов fx_clip (user-022; тест — по ревью user-021)
+ *
+ *   - пакет собирается здесь же по формату fx_clip.h (key RLE + delta skip/run/literal,
+ *     как tools/fx_clip_encode.py);
+ *   - плеер: после любого seek (подряд, назад, через key, по кругу) rgb — ровно исходный кадр
+ *     (палитра, строки снизу вверх); повторный seek того же кадра не декодирует;
+ *   - эффект CLIP через fx_engine кладёт в canvas кадр fx_clip_frame_at(anim_ms);
+ *   - битые клипы отклоняются (размер кадра, первый кадр не key, таблица кадров);
+ *   - цена: us на кадр при проигрывании подряд, на key и на худший seek (key + key_every-1 дельт), размер клипа.
+ */
+#include "host_test.h"
+#include "esp_random.h"
+#include "esp_partition.h"
+
+#include "fx_canvas.h"
+#include "fx_clip.h"
+#include "fx_engine.h"
+#include "matrix_ws2812.h"
+
+#define CLIP_ID         0xCA04u
+#define PIXELS          ((uint32_t)MATRIX_W * MATRIX_H)
+#define FRAME_BYTES     (PIXELS * 3u)
+#define CLIP_FRAMES     120
+#define KEY_EVERY       24
+#define PAL_N           64
+#define FPS_X10         250
+#define PACK_MAX        (256u * 1024u)
+#define SEEK_CASES      3000
+#define BENCH_ITERS     5000
+
+static uint8_t s_src[CLIP_FRAMES][PIXELS];   // индексы, верхняя строка первой
+static uint8_t s_pal[PAL_N][3];
+static uint8_t s_pack[PACK_MAX];
+static uint32_t s_pack_size;
+static fx_clip_player_t s_pl;
+
+static void wr16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void wr32(uint8_t *p, uint32_t v) { wr16(p, (uint16_t)v); wr16(p + 2, (uint16_t)(v >> 16)); }
+
+/* ============================================================
+ * Источник и пакет
+ * ============================================================ */
+
+/* Фон-градиент, движущийся блик и шумная полоса: в дельтах есть и пропуски, и повторы, и литералы */
+static void make_frames(void)
+{
+    host_random_seed(0xC11Bu);
+    for (int i = 0; i < PAL_N; i++) {
+        s_pal[i][0] = (uint8_t)(i * 4);
+        s_pal[i][1] = (uint8_t)(255 - i * 3);
+        s_pal[i][2] = (uint8_t)((i * 37) & 0xFF);
+    }
+    for (int f = 0; f < CLIP_FRAMES; f++) {
+        const int by = (f * 2) % (int)MATRIX_H, bx = (f / 3) % (int)MATRIX_W;
+        for (int y = 0; y < (int)MATRIX_H; y++) {
+            for (int x = 0; x < (int)MATRIX_W; x++) {
+                uint8_t v = (uint8_t)(y / 6);
+                const int dx = x - bx, dy = y - by;
+                if (dx * dx + dy * dy < 10) v = (uint8_t)(40 + (dx * dx + dy * dy));
+                if (y >= 20 && y < 23 && (esp_random() & 3u) == 0) v = (uint8_t)(50 + esp_random() % 14u);
+                s_src[f][(uint32_t)y * MATRIX_W + (uint32_t)x] = v;
+            }
+        }
+    }
+}
+
+/* key: c & 0x80 -> повтор (c & 0x7F) + 1, иначе (c + 1) литералов */
+static uint32_t enc_key(const uint8_t *idx, uint8_t *out)
+{
+    uint32_t o = 0, i = 0;
+    out[o++] = 0;   // type key
+    while (i < PIXELS) {
+        uint32_t run = 1;
+        while (i + run < PIXELS && run < 128u && idx[i + run] == idx[i]) run++;
+        if (run >= 2u) {
+            out[o++] = (uint8_t)(0x80u | (run - 1u));
+            out[o++] = idx[i];
+            i += run;
+            continue;
+        }
+        uint32_t lit = 0;
+        while (i + lit < PIXELS && lit < 128u && !(i + lit + 1u < PIXELS && idx[i + lit] == idx[i + lit + 1u])) lit++;
+        if (lit == 0) lit = 1;
+        out[o++] = (uint8_t)(lit - 1u);
+        memcpy(&out[o], &idx[i], lit);
+        o += lit;
+        i += lit;
+    }
+    return o;
+}
+
+/* delta: 0x00..0x7F пропуск (c+1), 0x80..0xBF повтор (c&0x3F)+1, 0xC0..0xFF литералы (c&0x3F)+1 */
+static uint32_t enc_delta(const uint8_t *prev, const uint8_t *idx, uint8_t *out)
+{
+    uint32_t o = 0, i = 0;
+    out[o++] = 1;   // type delta
+    while (i < PIXELS) {
+        uint32_t skip = 0;
+        while (i + skip < PIXELS && skip < 128u && idx[i + skip] == prev[i + skip]) skip++;
+        if (skip) {
+            if (i + skip == PIXELS) break;   // хвост без изменений — токены не нужны
+            out[o++] = (uint8_t)(skip - 1u);
+            i += skip;
+            continue;
+        }
+        uint32_t run = 1;
+        while (i + run < PIXELS && run < 64u && idx[i + run] == idx[i]) run++;
+        if (run >= 2u) {
+            out[o++] = (uint8_t)(0x80u | (run - 1u));
+            out[o++] = idx[i];
+            i += run;
+            continue;
+        }
+        uint32_t lit = 0;
+        while (i + lit < PIXELS && lit < 64u && idx[i + lit] != prev[i + lit] &&
+               !(i + lit + 1u < PIXELS && idx[i + lit] == idx[i + lit + 1u])) lit++;
+        if (lit == 0) lit = 1;
+        out[o++] = (uint8_t)(0xC0u | (lit - 1u));
+        memcpy(&out[o], &idx[i], lit);
+        o += lit;
+        i += lit;
+    }
+    return o;
+}
+
+static void pack_build(void)
+{
+    memset(s_pack, 0, sizeof(s_pack));
+    memcpy(s_pack, "JCPK", 4);
+    wr16(s_pack + 4, 1);
+    wr16(s_pack + 6, 1);
+    memcpy(s_pack + 12, "test", 4);
+
+    const uint32_t c0 = 12u + 16u;
+    wr32(s_pack + 12 + FX_CLIP_NAME_LEN, c0);
+
+    uint8_t *c = &s_pack[c0];
+    c[0] = MATRIX_W; c[1] = MATRIX_H;
+    wr16(c + 2, CLIP_FRAMES);
+    wr16(c + 4, FPS_X10);
+    wr16(c + 6, PAL_N);
+    wr16(c + 8, KEY_EVERY);
+    memcpy(c + 16, s_pal, sizeof(s_pal));
+
+    uint8_t *table = c + 16 + sizeof(s_pal);
+    uint32_t o = 16u + (uint32_t)sizeof(s_pal) + CLIP_FRAMES * 4u;
+    for (int f = 0; f < CLIP_FRAMES; f++) {
+        wr32(table + f * 4, o);
+        o += (f % KEY_EVERY == 0) ? enc_key(s_src[f], c + o) : enc_delta(s_src[f - 1], s_src[f], c + o);
+    }
+    wr32(c + 12, o);
+    s_pack_size = c0 + o;
+    wr32(s_pack + 8, s_pack_size);
+}
+
+/* Ожидаемый RGB кадра f: палитра, строки canvas снизу вверх */
+static bool frame_ok(const uint8_t *rgb, int f)
+{
+    for (uint32_t sy = 0; sy < MATRIX_H; sy++) {
+        const uint8_t *d = &rgb[(MATRIX_H - 1u - sy) * MATRIX_W * 3u];
+        for (uint32_t x = 0; x < MATRIX_W; x++) {
+            if (memcmp(&d[x * 3u], s_pal[s_src[f][sy * MATRIX_W + x]], 3) != 0) return false;
+        }
+    }
+    return true;
+}
+
+/* ============================================================
+ * Тесты
+ * ============================================================ */
+
+static void test_seek(void)
+{
+    CHECK_EQ_U(fx_clip_attach(s_pack, s_pack_size), ESP_OK);
+    const fx_clip_t *c = fx_clip_find("test");
+    CHECK(c != NULL);
+    if (!c) return;
+    CHECK_EQ_U(fx_clip_frames(c), CLIP_FRAMES);
+
+    fx_clip_player_open(&s_pl, c);
+
+    uint32_t bad_seq = 0;
+    for (int lap = 0; lap < 2; lap++) {
+        for (int f = 0; f < CLIP_FRAMES; f++) {
+            CHECK(fx_clip_player_seek(&s_pl, (uint16_t)f));
+            bad_seq += !frame_ok(s_pl.rgb, f);
+        }
+    }
+    CHECK_EQ_U(bad_seq, 0);
+
+    // тот же кадр — без декода
+    CHECK(!fx_clip_player_seek(&s_pl, CLIP_FRAMES - 1));
+    CHECK_EQ_U(s_pl.decode_us, 0);
+
+    // произвольные переходы: назад, вперёд через key, за концом (по кругу)
+    uint32_t bad_rnd = 0;
+    host_random_seed(0x5EE4u);
+    for (int i = 0; i < SEEK_CASES; i++) {
+        const uint16_t f = (uint16_t)(esp_random() % (CLIP_FRAMES * 3u));
+        (void)fx_clip_player_seek(&s_pl, f);
+        bad_rnd += !frame_ok(s_pl.rgb, f % CLIP_FRAMES);
+    }
+    CHECK_EQ_U(bad_rnd, 0);
+
+    // время -> кадр: fps 25.0, по кругу
+    CHECK_EQ_U(fx_clip_frame_at(c, 0), 0);
+    CHECK_EQ_U(fx_clip_frame_at(c, 39), 0);
+    CHECK_EQ_U(fx_clip_frame_at(c, 40), 1);
+    CHECK_EQ_U(fx_clip_frame_at(c, 40u * CLIP_FRAMES + 80u), 2);
+}
+
+static void test_effect(void)
+{
+    static uint8_t out[FRAME_BYTES];
+
+    host_partition_add(FX_CLIP_PART_LABEL, s_pack, s_pack_size);
+    CHECK_EQ_U(fx_clip_init(), ESP_OK);
+    CHECK_EQ_U(fx_clip_count(), 1);
+
+    fx_engine_set_speed_pct(100);
+    fx_engine_set_brightness(255);
+    fx_engine_set_effect(CLIP_ID);
+
+    uint32_t bad = 0;
+    for (uint32_t t = 0; t < 40u * CLIP_FRAMES * 2u; t += 33u) {
+        fx_engine_render(fx_engine_get_effect(), t, 33, t, 33);
+        fx_canvas_flatten(NULL, out);
+        bad += !frame_ok(out, fx_clip_frame_at(fx_clip_at(0), t));
+    }
+    CHECK_EQ_U(bad, 0);
+}
+
+static void test_bad_clips(void)
+{
+    static uint8_t bad[PACK_MAX];
+    const uint32_t c0 = 12u + 16u;
+
+    memcpy(bad, s_pack, s_pack_size);
+    bad[c0] = MATRIX_W + 1u;                         // другой размер кадра
+    CHECK_EQ_U(fx_clip_attach(bad, s_pack_size), ESP_ERR_INVALID_SIZE);
+
+    memcpy(bad, s_pack, s_pack_size);
+    const uint32_t f0 = c0 + 16u + (uint32_t)sizeof(s_pal);
+    const uint32_t ofs0 = (uint32_t)bad[f0] | ((uint32_t)bad[f0 + 1] << 8);
+    bad[c0 + ofs0] = 1;                              // первый кадр — delta
+    CHECK_EQ_U(fx_clip_attach(bad, s_pack_size), ESP_ERR_INVALID_SIZE);
+
+    memcpy(bad, s_pack, s_pack_size);
+    wr32(&bad[f0 + 4u * 5u], 0xFFFFu);               // кадр 5 за концом клипа
+    CHECK_EQ_U(fx_clip_attach(bad, s_pack_size), ESP_ERR_INVALID_SIZE);
+    CHECK_EQ_U(fx_clip_count(), 0);
+    CHECK(fx_clip_find("test") == NULL);
+
+    CHECK_EQ_U(fx_clip_attach(s_pack, s_pack_size), ESP_OK);
+}
+
+/* ============================================================
+ * Цена
+ * ============================================================ */
+
+static void bench_decode(void)
+{
+    double play_us = 0.0, key_us = 0.0, worst_us = 0.0;
+
+    CHECK_EQ_U(fx_clip_attach(s_pack, s_pack_size), ESP_OK);
+    const fx_clip_t *c = fx_clip_at(0);
+    fx_clip_player_open(&s_pl, c);
+
+    // проигрывание подряд: дельта + палитра -> RGB, каждый KEY_EVERY-й — key
+    HOST_BENCH(play_us, BENCH_ITERS, {
+        (void)fx_clip_player_seek(&s_pl, (uint16_t)(it_ % CLIP_FRAMES));
+    });
+    g_host_sink = s_pl.rgb[5];
+
+    // только key: 24 <-> 48, дельт нет
+    HOST_BENCH(key_us, BENCH_ITERS, {
+        (void)fx_clip_player_seek(&s_pl, (uint16_t)(KEY_EVERY * (1 + (it_ & 1))));
+    });
+    g_host_sink = s_pl.rgb[5];
+
+    // худший seek: последний кадр группы из другой группы — key + (KEY_EVERY - 1) дельт
+    HOST_BENCH(worst_us, BENCH_ITERS, {
+        (void)fx_clip_player_seek(&s_pl, (uint16_t)(KEY_EVERY * (1 + (it_ & 1)) - 1));
+    });
+    g_host_sink = s_pl.rgb[5];
+
+    printf("clip decode: playback %.3f us/frame, key %.3f us, worst seek (key + %d deltas) %.3f us\n",
+           play_us, key_us, KEY_EVERY - 1, worst_us);
+    printf("clip size: %u bytes for %d frames (%.1f B/frame, %.1f%% of raw RGB)\n",
+           (unsigned)s_pack_size, CLIP_FRAMES, (double)s_pack_size / CLIP_FRAMES,
+           100.0 * s_pack_size / ((double)CLIP_FRAMES * FRAME_BYTES));
+    CHECK(s_pack_size * 4u < (uint32_t)CLIP_FRAMES * FRAME_BYTES);
+    // даже худший seek на кадр — малая доля бюджета кадра (45 ms, user-019)
+    CHECK(worst_us * 50.0 < 45000.0);
+}
+
+int main(void)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+
+    make_frames();
+    pack_build();
+
+    test_seek();
+    test_effect();
+    test_bad_clips();
+    bench_decode();
+    return host_test_done("test_fx_clip");
+}
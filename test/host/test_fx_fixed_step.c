@@ -0,0 +1,147 @@
+/*
+ * test_fx_fixed_step.c — фиксированный шаг симуляции fx_fixed_step_* (user-023)
+ *
+ *   - дробный dt (кадр 25 ms, шаг 40 ms): шагов за N кадров ровно floor(N*25/40), 0/1 на кадр;
+ *   - остаток < step_ms переходит в следующий кадр и виден в alpha;
+ *   - потолок max_steps: лишние целые шаги выбрасываются в dropped_ms, остаток сохраняется;
+ *   - alpha_q8 внутри шага не убывает и падает только на кадре, где прошёл шаг;
+ *   - dt = 0 (pause): 0 шагов, accum и alpha не меняются.
+ */
+#include "host_test.h"
+
+#include "fx_engine.h"
+
+#define STEP_MS         40u     // FIRE: симуляция 25 Hz
+#define DT_MS           25u     // кадр 40 fps
+#define MAX_STEPS       3u
+
+static void test_fractional_dt(void)
+{
+    fx_fixed_step_t fs;
+    fx_fixed_step_init(&fs, STEP_MS, MAX_STEPS);
+
+    // 25 -> 0, 50 -> 1 (10), 35 -> 0, 60 -> 1 (20), 45 -> 1 (5), 30 -> 0, 55 -> 1 (15), 40 -> 1 (0)
+    static const uint8_t first[] = { 0, 1, 0, 1, 1, 0, 1, 1 };
+    uint32_t total = 0;
+    for (uint32_t f = 1; f <= 1000u; f++) {
+        const uint8_t n = fx_fixed_step_advance(&fs, DT_MS);
+        if (f <= sizeof(first)) CHECK_EQ_U(n, first[f - 1u]);
+        CHECK(n <= 1u);
+        total += n;
+        CHECK_EQ_U(total, f * DT_MS / STEP_MS);
+        CHECK_EQ_U(fs.accum_ms, f * DT_MS % STEP_MS);
+    }
+    CHECK_EQ_U(fs.dropped_ms, 0);
+}
+
+static void test_remainder_kept(void)
+{
+    fx_fixed_step_t fs;
+    fx_fixed_step_init(&fs, STEP_MS, MAX_STEPS);
+
+    CHECK_EQ_U(fx_fixed_step_advance(&fs, 25), 0);
+    CHECK_EQ_U(fs.accum_ms, 25);
+    CHECK_EQ_U(fx_fixed_step_alpha_q8(&fs), 25u * 256u / STEP_MS);   // 160
+
+    // 25 + 95 = 120 = 3 шага ровно, остатка нет
+    CHECK_EQ_U(fx_fixed_step_advance(&fs, 95), 3);
+    CHECK_EQ_U(fs.accum_ms, 0);
+    CHECK_EQ_U(fx_fixed_step_alpha_q8(&fs), 0);
+
+    // 39 — ещё не шаг, +1 — шаг, остаток 0
+    CHECK_EQ_U(fx_fixed_step_advance(&fs, 39), 0);
+    CHECK_EQ_U(fx_fixed_step_alpha_q8(&fs), 39u * 256u / STEP_MS);   // 249
+    CHECK_EQ_U(fx_fixed_step_advance(&fs, 1), 1);
+    CHECK_EQ_U(fs.accum_ms, 0);
+    CHECK_EQ_U(fs.dropped_ms, 0);
+}
+
+static void test_max_steps_cap(void)
+{
+    fx_fixed_step_t fs;
+    fx_fixed_step_init(&fs, STEP_MS, MAX_STEPS);
+
+    // подвисание 1010 ms: 25 целых шагов, 3 выполняются, 22 выброшены, 10 ms остатка живут дальше
+    CHECK_EQ_U(fx_fixed_step_advance(&fs, 1010), MAX_STEPS);
+    CHECK_EQ_U(fs.dropped_ms, (1010u / STEP_MS - MAX_STEPS) * STEP_MS);   // 880
+    CHECK_EQ_U(fs.accum_ms, 1010u % STEP_MS);
+    CHECK_EQ_U(fx_fixed_step_alpha_q8(&fs), (1010u % STEP_MS) * 256u / STEP_MS);
+
+    // ровно на потолке — ничего не выбрасывается; dropped_ms копится
+    CHECK_EQ_U(fx_fixed_step_advance(&fs, MAX_STEPS * STEP_MS), MAX_STEPS);
+    CHECK_EQ_U(fs.dropped_ms, 880);
+    CHECK_EQ_U(fx_fixed_step_advance(&fs, 200), MAX_STEPS);              // 210 -> 5 шагов, 2 лишних
+    CHECK_EQ_U(fs.dropped_ms, 880u + 2u * STEP_MS);
+    CHECK_EQ_U(fs.accum_ms, 10);
+
+    // без подвисаний время симуляции + выброшенное + остаток == сумма dt
+    fx_fixed_step_init(&fs, STEP_MS, MAX_STEPS);
+    uint32_t sum_dt = 0, steps = 0;
+    for (uint32_t f = 0; f < 500u; f++) {
+        const uint32_t dt = (f % 7u == 0u) ? 333u : 17u;
+        sum_dt += dt;
+        steps += fx_fixed_step_advance(&fs, dt);
+        CHECK(fs.accum_ms < STEP_MS);
+    }
+    CHECK_EQ_U(steps * STEP_MS + fs.dropped_ms + fs.accum_ms, sum_dt);
+    CHECK(fs.dropped_ms > 0u);
+
+    // max_steps = 0 в init -> 1
+    fx_fixed_step_init(&fs, STEP_MS, 0);
+    CHECK_EQ_U(fx_fixed_step_advance(&fs, 10u * STEP_MS), 1);
+}
+
+static void test_alpha_monotonic(void)
+{
+    fx_fixed_step_t fs;
+    fx_fixed_step_init(&fs, STEP_MS, MAX_STEPS);
+
+    uint8_t prev = fx_fixed_step_alpha_q8(&fs);
+    CHECK_EQ_U(prev, 0);
+    uint32_t steps = 0, drops = 0;
+    for (uint32_t ms = 1; ms <= 10u * STEP_MS; ms++) {
+        const uint8_t n = fx_fixed_step_advance(&fs, 1);
+        const uint8_t a = fx_fixed_step_alpha_q8(&fs);
+        if (n == 0) {
+            CHECK(a > prev);               // шаг 40 ms: 6.4 единицы Q8 на ms
+        } else {
+            CHECK(a < prev);
+            drops++;
+        }
+        steps += n;
+        prev = a;
+    }
+    CHECK_EQ_U(steps, 10);
+    CHECK_EQ_U(drops, 10);
+}
+
+static void test_pause(void)
+{
+    fx_fixed_step_t fs;
+    fx_fixed_step_init(&fs, STEP_MS, MAX_STEPS);
+
+    (void)fx_fixed_step_advance(&fs, 70);
+    const uint32_t accum = fs.accum_ms;
+    const uint8_t alpha = fx_fixed_step_alpha_q8(&fs);
+    CHECK_EQ_U(accum, 30);
+
+    for (int i = 0; i < 100; i++) {
+        CHECK_EQ_U(fx_fixed_step_advance(&fs, 0), 0);
+    }
+    CHECK_EQ_U(fs.accum_ms, accum);
+    CHECK_EQ_U(fx_fixed_step_alpha_q8(&fs), alpha);
+    CHECK_EQ_U(fs.dropped_ms, 0);
+
+    CHECK_EQ_U(fx_fixed_step_advance(NULL, 25), 0);
+    CHECK_EQ_U(fx_fixed_step_alpha_q8(NULL), 255);
+}
+
+int main(void)
+{
+    test_fractional_dt();
+    test_remainder_kept();
+    test_max_steps_cap();
+    test_alpha_monotonic();
+    test_pause();
+    return host_test_done("test_fx_fixed_step");
+}
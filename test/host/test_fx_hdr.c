@@ -0,0 +1,184 @@
+/*
+ * test_fx_hdr.c — HDR-накопитель fx_canvas против clamp на каждой записи (user-016)
+ *
+ *   - tone-map: в пределах 8 бит — тождество (как насыщающее сложение), при переполнении —
+ *     максимум 255, сумма r+g+b сохраняется, порядок каналов тот же; >= 765 — белый;
+ *   - FIRE: us/кадр (render + present) с HDR и в сборке FX_CANVAS_HDR_ENABLE=0, где искры и
+ *     лепестки идут насыщающим fx_layer_add в слой частиц (путь до user-016).
+ *
+ * Один исходник, две сборки: test_fx_hdr_clamp (HDR выключен) только печатает us/кадр FIRE,
+ * test_fx_hdr запускает её (HOST_FIRE_CLAMP_BIN) и сравнивает со своим прогоном.
+ */
+#include "host_test.h"
+#include "esp_random.h"
+
+#include "fx_engine.h"
+#include "fx_canvas.h"
+#include "matrix_ws2812.h"
+
+#define ROW_BYTES       ((uint32_t)MATRIX_W * 3u)
+#define FRAME_BYTES     (ROW_BYTES * MATRIX_H)
+#define FIRE_ID         0xCA01u
+#define FIRE_DT_MS      25u
+#define FIRE_WARMUP     200
+#define FIRE_FRAMES     1000
+
+/* ============================================================
+ * FIRE: render + present, us/кадр
+ * ============================================================ */
+
+static double fire_us_per_frame(void)
+{
+    static uint32_t t = 0;
+    double us = 0.0;
+
+    host_random_seed(0x0F12E16u);
+    fx_engine_set_frame_budget_us(10000000u);   // tier не меняется от времени хоста
+    fx_engine_set_effect(FIRE_ID);
+    fx_engine_set_brightness(255);
+    fx_engine_set_speed_pct(100);
+
+    // разгон: искры и лепестки успевают появиться
+    for (int f = 0; f < FIRE_WARMUP; f++) {
+        t += FIRE_DT_MS;
+        fx_engine_render(fx_engine_get_effect(), t, FIRE_DT_MS, t, FIRE_DT_MS);
+        fx_canvas_present();
+    }
+
+    HOST_BENCH(us, FIRE_FRAMES, {
+        t += FIRE_DT_MS;
+        fx_engine_render(fx_engine_get_effect(), t, FIRE_DT_MS, t, FIRE_DT_MS);
+        fx_canvas_present();
+    });
+    return us;
+}
+
+#if FX_CANVAS_HDR_ENABLE
+
+/* ============================================================
+ * Tone-map
+ * ============================================================ */
+
+static void pixel_of(const uint8_t *frame, uint16_t x, uint16_t y, uint8_t *c)
+{
+    memcpy(c, &frame[(uint32_t)y * ROW_BYTES + (uint32_t)x * 3u], 3);
+}
+
+static void test_tonemap_identity(void)
+{
+    static uint8_t base[FRAME_BYTES], out[FRAME_BYTES];
+
+    // база + HDR в пределах 8 бит: ровно сумма, и вне искр база не меняется
+    host_random_seed(0x1D3Au);
+    for (uint32_t i = 0; i < FRAME_BYTES; i++) base[i] = (uint8_t)(esp_random() % 128u);
+    fx_canvas_load(base);
+
+    for (uint16_t y = 2; y < MATRIX_H - 2u; y += 3) {
+        for (uint16_t x = 5; x < MATRIX_W; x += 7) {
+            fx_canvas_hdr_add(x, y, 40, 60, 80);
+            fx_canvas_hdr_add(x, y, 20, 10, 0);
+        }
+    }
+    fx_canvas_flatten(NULL, out);
+
+    uint32_t bad = 0, added = 0;
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const bool hit = (y >= 2 && y < MATRIX_H - 2u && (y - 2u) % 3u == 0) && (x >= 5 && (x - 5u) % 7u == 0);
+            uint8_t b[3], o[3];
+            pixel_of(base, x, y, b);
+            pixel_of(out, x, y, o);
+            const uint8_t e[3] = {
+                (uint8_t)(b[0] + (hit ? 60 : 0)), (uint8_t)(b[1] + (hit ? 70 : 0)), (uint8_t)(b[2] + (hit ? 80 : 0))
+            };
+            bad += (memcmp(o, e, 3) != 0);
+            added += hit;
+        }
+    }
+    CHECK_EQ_U(bad, 0);
+    CHECK(added > 0);
+}
+
+static void test_tonemap_overflow(void)
+{
+    static uint8_t out[FRAME_BYTES];
+    uint8_t o[3];
+
+    fx_canvas_clear(0, 0, 0);
+
+    // (200,100,0) + (200,100,50) = (400,200,50): clamp дал бы (255,200,50), сумма 505
+    fx_canvas_set(3, 4, 200, 100, 0);
+    fx_canvas_hdr_add(3, 4, 200, 100, 50);
+    // сумма >= 765: белый
+    fx_canvas_set(10, 4, 250, 250, 250);
+    fx_canvas_hdr_add(10, 4, 100, 100, 100);
+    // одиночный канал: (0,0,300) -> синий уходит в белый поровну по r/g
+    fx_canvas_hdr_add(12, 4, 0, 0, 150);
+    fx_canvas_hdr_add(12, 4, 0, 0, 150);
+    fx_canvas_flatten(NULL, out);
+
+    pixel_of(out, 3, 4, o);
+    const int sum = o[0] + o[1] + o[2];
+    CHECK_EQ_U(o[0], 255);
+    CHECK(sum >= 650 && sum <= 650 + 2);   // dn округляется вниз: канал вверх, не больше 1 на канал
+    CHECK(o[0] >= o[1] && o[1] >= o[2]);
+    printf("tonemap: (400,200,50) -> (%u,%u,%u), clamp (255,200,50)\n", o[0], o[1], o[2]);
+
+    pixel_of(out, 10, 4, o);
+    CHECK(o[0] == 255 && o[1] == 255 && o[2] == 255);
+
+    pixel_of(out, 12, 4, o);
+    CHECK_EQ_U(o[2], 255);
+    CHECK_EQ_U(o[0], o[1]);
+    CHECK(o[0] + o[1] + o[2] >= 300 && o[0] + o[1] + o[2] <= 300 + 2);
+
+    // flatten очистил HDR: следующий кадр — чистая база
+    fx_canvas_flatten(NULL, out);
+    pixel_of(out, 12, 4, o);
+    CHECK(o[0] == 0 && o[1] == 0 && o[2] == 0);
+}
+
+/* ============================================================
+ * FIRE: HDR против clamp-сборки
+ * ============================================================ */
+
+static double clamp_fire_us(void)
+{
+    FILE *p = popen(HOST_FIRE_CLAMP_BIN, "r");
+    if (!p) return -1.0;
+    double us = -1.0;
+    if (fscanf(p, "%lf", &us) != 1) us = -1.0;
+    if (pclose(p) != 0) us = -1.0;
+    return us;
+}
+
+static void bench_fire(void)
+{
+    const double old_us = clamp_fire_us();
+    const double new_us = fire_us_per_frame();
+    CHECK(old_us > 0.0);
+    host_bench_report("fire frame (clamp -> hdr)", old_us, new_us);
+}
+
+int main(void)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+
+    test_tonemap_identity();
+    test_tonemap_overflow();
+    bench_fire();
+
+    return host_test_done("test_fx_hdr");
+}
+
+#else
+
+/* Clamp-сборка: только замер, результат — в stdout для test_fx_hdr */
+int main(void)
+{
+    if (matrix_ws2812_init(0) != ESP_OK) return 1;
+    printf("%.3f\n", fire_us_per_frame());
+    return 0;
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * test_fx_noise.c — fBm fx_noise: корректность и цена полного кадра (user-019)
+ *
+ *   - fx_noise3_row (столбец на ячейку, lerp на пиксель) побайтно равен fx_noise3 по точкам;
+ *   - кэш октав во времени без скачков: на кадре пересборки ключа поле меняется не сильнее,
+ *     чем на обычном кадре;
+ *   - us на полный кадр 16x48: fBm без кэша (все октавы живые) против кэша нижних октав,
+ *     PLASMA/LAVA целиком (fx_engine_render + present, один поток) — средний кадр и худший
+ *     (пересборка обоих ключей) против бюджета кадра 45 ms.
+ */
+#include <stdlib.h>
+
+#include "host_test.h"
+
+#include "fx_engine.h"
+#include "fx_canvas.h"
+#include "fx_noise.h"
+#include "matrix_ws2812.h"
+
+#define PLASMA_ID       0xCA02u
+#define LAVA_ID         0xCA03u
+#define FRAME_DT_MS     25u
+#define RUN_FRAMES      2000
+
+/* Бюджет кадра на таргете. Хост в разы быстрее ESP32-S3 @240 MHz: худший кадр на хосте должен
+ * влезать в бюджет с множителем HOST_TARGET_FACTOR (заведомо больше реального отношения
+ * хост/таргет). Цифры на железе — ANIM_PERF (гистограмма render). */
+#define FRAME_BUDGET_US     45000.0
+#define HOST_TARGET_FACTOR  50.0
+
+static void test_row_equals_points(void)
+{
+    static const uint32_t k_dx[] = { 7, 40, 128, 255, 256, 300, 700 };
+    uint8_t row[MATRIX_W];
+    uint32_t bad = 0;
+
+    for (size_t d = 0; d < sizeof(k_dx) / sizeof(k_dx[0]); d++) {
+        for (uint32_t k = 0; k < 64; k++) {
+            const uint32_t x0 = k * 0x1F3u, y = k * 97u + 13u, z = k * 0x2A1u;
+            fx_noise3_row(x0, k_dx[d], y, z, row, MATRIX_W);
+            for (uint16_t i = 0; i < MATRIX_W; i++) {
+                bad += (row[i] != fx_noise3(x0 + i * k_dx[d], y, z));
+            }
+        }
+    }
+    CHECK_EQ_U(bad, 0);
+}
+
+/* Кадр fBm целиком: prep + все строки */
+static void fbm_frame(fx_fbm_t *f, uint32_t z, uint8_t *out)
+{
+    fx_fbm_prep(f, z);
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        fx_fbm_row(f, y, z, &out[(uint32_t)y * MATRIX_W]);
+    }
+}
+
+static void test_key_continuity(void)
+{
+    static fx_fbm_t f;
+    static uint8_t prev[MATRIX_W * MATRIX_H], cur[MATRIX_W * MATRIX_H];
+
+    // как PLASMA: 3 октавы, 1 в кэше, ключ раз в 512 ед. z, 25 ед. z на кадр
+    fx_fbm_init(&f, 3, 1, 40, 512, 0);
+    fbm_frame(&f, 0, prev);
+
+    int max_key = 0, max_plain = 0;
+    uint32_t keys = 0;
+    for (uint32_t i = 1; i < 800; i++) {
+        const uint32_t z = i * 25u;
+        const uint32_t key_before = f.key_z_q8;
+        fbm_frame(&f, z, cur);
+        const bool rebuilt = (f.key_z_q8 != key_before);
+
+        int m = 0;
+        for (uint32_t p = 0; p < sizeof(cur); p++) {
+            const int d = abs((int)cur[p] - (int)prev[p]);
+            if (d > m) m = d;
+        }
+        if (rebuilt) {
+            keys++;
+            if (m > max_key) max_key = m;
+        } else if (m > max_plain) {
+            max_plain = m;
+        }
+        memcpy(prev, cur, sizeof(cur));
+    }
+    printf("fbm continuity: max |dframe| %d on %u key rebuilds, %d otherwise\n",
+           max_key, (unsigned)keys, max_plain);
+    CHECK(keys > 10);
+    CHECK(max_key <= max_plain + 2);
+}
+
+typedef struct {
+    uint16_t    id;
+    const char *name;
+    uint8_t     octaves, cached;
+    uint16_t    scale_q8, drift_q8;
+    uint32_t    key_dz_q8;
+} noise_case_t;
+
+/* Параметры — как в fx_effects_noise.c */
+static const noise_case_t k_cases[] = {
+    { PLASMA_ID, "plasma", 3, 1, 40,  0, 512 },
+    { LAVA_ID,   "lava",   3, 2, 28, 96, 384 },
+};
+
+static void bench_case(const noise_case_t *c)
+{
+    static fx_fbm_t live, cached;
+    static uint8_t out[MATRIX_W * MATRIX_H];
+    double live_us = 0.0, cached_us = 0.0, rebuild_us = 0.0, eff_us = 0.0;
+    char name[64];
+
+    // fBm: все октавы живые против кэша нижних (обычный кадр, 25 ед. z)
+    fx_fbm_init(&live,   c->octaves, 0,         c->scale_q8, c->key_dz_q8, c->drift_q8);
+    fx_fbm_init(&cached, c->octaves, c->cached, c->scale_q8, c->key_dz_q8, c->drift_q8);
+    HOST_BENCH(live_us, RUN_FRAMES, { fbm_frame(&live, (uint32_t)it_ * 25u, out); });
+    g_host_sink = out[3];
+    HOST_BENCH(cached_us, RUN_FRAMES, { fbm_frame(&cached, (uint32_t)it_ * 25u, out); });
+    g_host_sink = out[3];
+    snprintf(name, sizeof(name), "%s fbm frame (live -> %u cached)", c->name, (unsigned)c->cached);
+    host_bench_report(name, live_us, cached_us);
+
+    // худший кадр: z прыгает дальше пары ключей — пересобираются оба
+    HOST_BENCH(rebuild_us, RUN_FRAMES, { fbm_frame(&cached, (uint32_t)it_ * c->key_dz_q8 * 4u, out); });
+    g_host_sink = out[3];
+
+    // эффект целиком (render + present), обычные кадры
+    fx_engine_set_effect(c->id);
+    HOST_BENCH(eff_us, RUN_FRAMES, {
+        const uint32_t t = (uint32_t)(it_ + 1) * FRAME_DT_MS;
+        fx_engine_render(fx_engine_get_effect(), t, FRAME_DT_MS, t, FRAME_DT_MS);
+        fx_canvas_present();
+    });
+
+    const double worst = eff_us + (rebuild_us - cached_us);
+    printf("%s frame: avg %.3f us, worst (2 key rebuilds) %.3f us, x%.0f -> %.2f ms of %.0f ms budget\n",
+           c->name, eff_us, worst, HOST_TARGET_FACTOR, worst * HOST_TARGET_FACTOR / 1000.0,
+           FRAME_BUDGET_US / 1000.0);
+    CHECK(worst * HOST_TARGET_FACTOR < FRAME_BUDGET_US);
+}
+
+int main(void)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    fx_engine_set_frame_budget_us(10000000u);   // tier HIGH: все октавы
+    fx_engine_set_speed_pct(100);
+    fx_engine_set_brightness(102);
+
+    test_row_equals_points();
+    test_key_continuity();
+    for (size_t i = 0; i < sizeof(k_cases) / sizeof(k_cases[0]); i++) {
+        bench_case(&k_cases[i]);
+    }
+    return host_test_done("test_fx_noise");
+}
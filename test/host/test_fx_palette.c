@@ -0,0 +1,137 @@
+/*
+ * test_fx_palette.c — LUT-палитры против hsv_to_rgb на пиксель (user-018)
+ *
+ *   - RAINBOW: LUT(scale = v) побайтно равен baseline hsv_to_rgb(h, 255, v) для всех h и v;
+ *   - градиент: в опорных точках — ровно цвет точки (scale 255), scale — x/255 от него;
+ *   - кэш: повторный get того же ключа — тот же LUT без пересборки, LRU на FX_PAL_CACHE_SLOTS,
+ *     set_custom сбрасывает только custom;
+ *   - бенчмарк: кадр 16x48 цветов по индексу (hsv_to_rgb на пиксель против fx_pal_rgb),
+ *     цена промаха кэша (пересборка LUT).
+ */
+#include "host_test.h"
+
+#include "fx_palette.h"
+#include "matrix_ws2812.h"
+#include "ref/ref_fx_simple.h"
+
+#define FRAME_PX        ((uint32_t)MATRIX_W * MATRIX_H)
+#define BENCH_FRAMES    20000
+
+static void test_rainbow_exact(void)
+{
+    uint32_t bad = 0;
+
+    for (uint32_t v = 0; v < 256u; v++) {
+        const uint8_t *lut = fx_palette_get(FX_PAL_RAINBOW, (uint8_t)v);
+        for (uint32_t h = 0; h < 256u; h++) {
+            uint8_t r, g, b;
+            ref_hsv_to_rgb((uint8_t)h, 255, (uint8_t)v, &r, &g, &b);
+            bad += (lut[h * 3u] != r || lut[h * 3u + 1u] != g || lut[h * 3u + 2u] != b);
+        }
+    }
+    CHECK_EQ_U(bad, 0);
+    printf("rainbow: LUT == hsv_to_rgb(h, 255, v) for 256 x 256 (h, v), %u mismatches\n", (unsigned)bad);
+}
+
+static void test_gradient(void)
+{
+    static const fx_pal_stop_t stops[] = {
+        {   0,  10,  20,  30 },
+        { 100, 200,   0, 100 },
+        { 255, 255, 255,   0 },
+    };
+    static uint8_t lut[256 * 3], half[256 * 3];
+
+    fx_palette_build(stops, 3, 255, lut);
+    fx_palette_build(stops, 3, 128, half);
+
+    uint32_t bad = 0;
+    for (int i = 0; i < 3; i++) {
+        const uint8_t *p = &lut[(uint32_t)stops[i].pos * 3u];
+        bad += (p[0] != stops[i].r || p[1] != stops[i].g || p[2] != stops[i].b);
+    }
+    CHECK_EQ_U(bad, 0);
+
+    // между точками — монотонно (R растёт 10 -> 200 на [0..100])
+    uint32_t non_mono = 0;
+    for (uint32_t i = 1; i <= 100u; i++) non_mono += (lut[i * 3u] < lut[(i - 1u) * 3u]);
+    CHECK_EQ_U(non_mono, 0);
+
+    uint32_t bad_scale = 0;
+    for (uint32_t i = 0; i < sizeof(lut); i++) {
+        bad_scale += (half[i] != (uint8_t)((lut[i] * 128u) / 255u));
+    }
+    CHECK_EQ_U(bad_scale, 0);
+}
+
+static void test_cache(void)
+{
+    const uint8_t *a = fx_palette_get(FX_PAL_HEAT, 200);
+    const uint8_t *b = fx_palette_get(FX_PAL_HEAT, 200);
+    CHECK(a == b);
+
+    const uint8_t *c = fx_palette_get(FX_PAL_HEAT, 100);
+    CHECK(c != a);
+    CHECK(fx_palette_get(FX_PAL_HEAT, 200) == a);   // оба в кэше
+
+    // custom в своём слоте; set_custom пересобирает его, HEAT не трогает
+    static const fx_pal_stop_t bw[] = { { 0, 0, 0, 0 }, { 255, 255, 255, 255 } };
+    static const fx_pal_stop_t wb[] = { { 0, 255, 255, 255 }, { 255, 0, 0, 0 } };
+    CHECK(fx_palette_set_custom(bw, 2));
+    const uint8_t *cu = fx_palette_get(FX_PAL_CUSTOM, 255);
+    CHECK_EQ_U(cu[0], 0);
+    CHECK(fx_palette_set_custom(wb, 2));
+    cu = fx_palette_get(FX_PAL_CUSTOM, 255);
+    CHECK_EQ_U(cu[0], 255);
+    CHECK(fx_palette_get(FX_PAL_HEAT, 200) == a);
+
+    static const fx_pal_stop_t bad_pos[] = { { 5, 0, 0, 0 }, { 255, 255, 255, 255 } };
+    CHECK(!fx_palette_set_custom(bad_pos, 2));
+    CHECK(fx_palette_get(FX_PAL_COUNT, 255) == NULL);
+}
+
+/* Кадр "цвет по индексу": как DIAG RAINBOW — hue от x, y и фазы */
+static void bench_frame(void)
+{
+    double old_us = 0.0, new_us = 0.0;
+    static uint8_t frame[FRAME_PX * 3u];
+
+    HOST_BENCH(old_us, BENCH_FRAMES, {
+        const uint32_t phase = (uint32_t)it_;
+        for (uint32_t i = 0; i < FRAME_PX; i++) {
+            uint8_t *d = &frame[i * 3u];
+            ref_hsv_to_rgb((uint8_t)(phase + (i % MATRIX_W) * 7u + (i / MATRIX_W) * 9u), 255, 210, &d[0], &d[1], &d[2]);
+        }
+    });
+    g_host_sink = frame[5];
+
+    HOST_BENCH(new_us, BENCH_FRAMES, {
+        const uint32_t phase = (uint32_t)it_;
+        const uint8_t *lut = fx_palette_get(FX_PAL_RAINBOW, 210);
+        for (uint32_t i = 0; i < FRAME_PX; i++) {
+            uint8_t *d = &frame[i * 3u];
+            fx_pal_rgb(lut, (uint8_t)(phase + (i % MATRIX_W) * 7u + (i / MATRIX_W) * 9u), &d[0], &d[1], &d[2]);
+        }
+    });
+    g_host_sink = frame[5];
+    host_bench_report("rainbow frame (hsv_to_rgb -> LUT)", old_us, new_us);
+
+    // промах кэша: значение меняется каждый вызов (хуже, чем бывает у эффектов)
+    double miss_rb = 0.0, miss_grad = 0.0;
+    HOST_BENCH(miss_rb, 2000, {
+        g_host_sink += fx_palette_get(FX_PAL_RAINBOW, (uint8_t)(1u + (it_ & 127)))[3];
+    });
+    HOST_BENCH(miss_grad, 2000, {
+        g_host_sink += fx_palette_get(FX_PAL_LAVA, (uint8_t)(1u + (it_ & 127)))[3];
+    });
+    printf("palette rebuild (cache miss): rainbow %.3f us, gradient %.3f us\n", miss_rb, miss_grad);
+}
+
+int main(void)
+{
+    test_rainbow_exact();
+    test_gradient();
+    test_cache();
+    bench_frame();
+    return host_test_done("test_fx_palette");
+}
@@ -0,0 +1,210 @@
+/*
+ * test_fx_parallel.c — fork/join fx_engine_parallel_rows (user-011)
+ *
+ *   - каждая строка считается ровно один раз при любом rows, и вызывающим, и worker'ом;
+ *   - join ограничен: worker, застрявший в своём куске, держит вызывающего не дольше этого куска,
+ *     остальные строки вызывающий забирает сам;
+ *   - FIRE, посчитанный параллельно (worker на pthread), бит-в-бит совпадает с последовательным.
+ *     Последовательный прогон — в fork()-потомке до fx_engine_init() (worker'а нет), чтобы оба
+ *     прогона стартовали с одинакового статического состояния эффекта.
+ */
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "host_test.h"
+#include "esp_random.h"
+
+#include "fx_engine.h"
+#include "fx_canvas.h"
+#include "matrix_ws2812.h"
+
+#define FRAME_BYTES     ((uint32_t)MATRIX_W * MATRIX_H * 3u)
+#define FIRE_ID         0xCA01u
+#define FIRE_FRAMES     300
+#define FIRE_DT_MS      25u
+
+static pthread_t s_main_th;
+
+static void spin_us(double us)
+{
+    const double t0 = host_now_us();
+    while (host_now_us() - t0 < us) { }
+}
+
+/* ============================================================
+ * Синтетическая полоса: счётчик визитов строки + кто считал
+ * ============================================================ */
+
+#define ROWS_MAX    64
+
+typedef struct {
+    uint32_t visits[ROWS_MAX];
+    uint32_t worker_rows;
+    double   row_us;          // стоимость строки (чтобы worker успевал проснуться)
+    int      stall_worker;    // 1 — первый кусок worker'а "застревает" (core 0 под аудио)
+    double   stall_us;
+} band_job_t;
+
+static void band_fn(void *arg, int y0, int y1)
+{
+    band_job_t *j = (band_job_t *)arg;
+    const bool on_worker = !pthread_equal(pthread_self(), s_main_th);
+
+    if (on_worker && __atomic_exchange_n(&j->stall_worker, 0, __ATOMIC_ACQ_REL)) {
+        spin_us(j->stall_us);
+    }
+    for (int y = y0; y < y1; y++) {
+        __atomic_add_fetch(&j->visits[y], 1u, __ATOMIC_RELAXED);
+        if (on_worker) __atomic_add_fetch(&j->worker_rows, 1u, __ATOMIC_RELAXED);
+        spin_us(j->row_us);
+    }
+}
+
+static void test_every_row_once(void)
+{
+    static band_job_t j;
+    uint32_t bad = 0, helped = 0;
+
+    for (int iter = 0; iter < 400; iter++) {
+        const int rows = 1 + (iter % ROWS_MAX);
+        memset(&j, 0, sizeof(j));
+        j.row_us = 2.0;
+        fx_engine_parallel_rows(rows, band_fn, &j);
+        for (int y = 0; y < ROWS_MAX; y++) {
+            if (j.visits[y] != (y < rows ? 1u : 0u)) bad++;
+        }
+        if (j.worker_rows) helped++;
+    }
+    CHECK_EQ_U(bad, 0);
+    CHECK(helped > 0);   // worker реально участвует
+    printf("every_row_once: worker helped in %u/400 jobs\n", (unsigned)helped);
+}
+
+static void test_join_bounded(void)
+{
+    static band_job_t j;
+    const int rows = 48;
+    const double row_us = 50.0;
+    const double stall_us = 200000.0;   // "worker вытеснен" на 200 ms
+    bool seen = false;
+
+    for (int attempt = 0; attempt < 20 && !seen; attempt++) {
+        memset(&j, 0, sizeof(j));
+        j.row_us = row_us;
+        j.stall_worker = 1;
+        j.stall_us = stall_us;
+
+        const double t0 = host_now_us();
+        fx_engine_parallel_rows(rows, band_fn, &j);
+        const double dt = host_now_us() - t0;
+
+        if (j.stall_worker != 0) continue;   // worker не проснулся за время задачи: serial, ок
+
+        seen = true;
+        uint32_t bad = 0;
+        for (int y = 0; y < rows; y++) bad += (j.visits[y] != 1u);
+        CHECK_EQ_U(bad, 0);
+        // застрявший worker досчитал только свой кусок, остальное — вызывающий
+        CHECK(j.worker_rows <= 8u);
+        // ожидание — один застрявший кусок, а не половина кадра после него
+        CHECK(dt < stall_us + (double)rows * row_us + 50000.0);
+        printf("join_bounded: worker rows %u, join %.1f ms (stall %.0f ms)\n",
+               (unsigned)j.worker_rows, dt / 1000.0, stall_us / 1000.0);
+    }
+    CHECK(seen);
+}
+
+/* ============================================================
+ * FIRE: параллельно == последовательно
+ * ============================================================ */
+
+static uint64_t fnv64(const uint8_t *p, uint32_t n)
+{
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (uint32_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+static void fire_run(uint64_t *hashes)
+{
+    static uint8_t frame[FRAME_BYTES];
+
+    host_random_seed(0x5EEDF12Eu);
+    fx_engine_set_frame_budget_us(10000000u);   // tier не меняется от времени хоста
+    fx_engine_set_effect(FIRE_ID);
+    fx_engine_set_brightness(102);
+    fx_engine_set_speed_pct(100);
+
+    for (uint32_t f = 0; f < FIRE_FRAMES; f++) {
+        const uint32_t t = (f + 1u) * FIRE_DT_MS;
+        fx_engine_render(fx_engine_get_effect(), t, FIRE_DT_MS, t, FIRE_DT_MS);
+        fx_canvas_flatten(NULL, frame);
+        hashes[f] = fnv64(frame, FRAME_BYTES);
+    }
+}
+
+static void test_fire_parallel_bit_identical(void)
+{
+    static uint64_t h_serial[FIRE_FRAMES], h_par[FIRE_FRAMES];
+
+    int fd[2];
+    CHECK(pipe(fd) == 0);
+    const pid_t pid = fork();
+    if (pid == 0) {
+        // потомок: worker'а нет (fx_engine_init не звали) -> fx_engine_parallel_rows serial
+        close(fd[0]);
+        fire_run(h_serial);
+        const ssize_t n = write(fd[1], h_serial, sizeof(h_serial));
+        _exit(n == (ssize_t)sizeof(h_serial) ? 0 : 1);
+    }
+    close(fd[1]);
+    size_t got = 0;
+    while (got < sizeof(h_serial)) {
+        const ssize_t n = read(fd[0], (uint8_t *)h_serial + got, sizeof(h_serial) - got);
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    close(fd[0]);
+    int st = 0;
+    waitpid(pid, &st, 0);
+    CHECK_EQ_U(got, sizeof(h_serial));
+    CHECK(WIFEXITED(st) && WEXITSTATUS(st) == 0);
+
+    // родитель: worker на pthread, тот же FIRE с того же состояния
+    fx_engine_init();
+    uint32_t jobs0 = 0, stolen0 = 0;
+    fx_engine_get_parallel_stats(&jobs0, &stolen0);
+
+    fire_run(h_par);
+
+    uint32_t jobs = 0, stolen = 0;
+    fx_engine_get_parallel_stats(&jobs, &stolen);
+
+    uint32_t diff = 0, moving = 0;
+    for (uint32_t f = 0; f < FIRE_FRAMES; f++) {
+        diff += (h_serial[f] != h_par[f]);
+        if (f) moving += (h_serial[f] != h_serial[f - 1u]);
+    }
+    CHECK_EQ_U(diff, 0);
+    CHECK(moving > FIRE_FRAMES / 2);   // огонь живой, сравнивали не пустые кадры
+    CHECK(jobs > jobs0);
+    CHECK((jobs - jobs0) > (stolen - stolen0));   // хоть в одной задаче строки считал worker
+    printf("fire: %u frames identical, parallel jobs %u, worker idle in %u\n",
+           (unsigned)FIRE_FRAMES, (unsigned)(jobs - jobs0), (unsigned)(stolen - stolen0));
+}
+
+int main(void)
+{
+    s_main_th = pthread_self();
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+
+    test_fire_parallel_bit_identical();   // первым: fork до старта worker'а
+    test_every_row_once();
+    test_join_bounded();
+
+    return host_test_done("test_fx_parallel");
+}
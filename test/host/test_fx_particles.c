@@ -0,0 +1,271 @@
+/*
+ * test_fx_particles.c — SoA-пул fx_particles против массива struct с флагом alive (user-020)
+ *
+ *   - пул: после любой последовательности spawn/integrate/clear count + nfree == cap, живые
+ *     индексы уникальны и в [0, cap), координаты живых в поле;
+ *   - кадр: при тех же искрах (те же spawn, тот же ветер) fx_psys_integrate + splat в HDR +
+ *     flatten побайтно равен baseline sparks_step_and_render в canvas (яркость без насыщения);
+ *   - бенчмарк (clear + тик + отрисовка + кадр в буфер) против baseline: цена ёмкости при том же
+ *     числе живых (12 -> 1200 слотов), полная загрузка 120 живых, цена на частицу.
+ */
+#include "host_test.h"
+
+#include "fx_canvas.h"
+#include "fx_particles.h"
+#include "matrix_ws2812.h"
+#include "ref/ref_canvas.h"
+#include "ref/ref_sparks.h"
+
+#define FRAME_BYTES     ((uint32_t)MATRIX_W * MATRIX_H * 3u)
+#define LIFE_MIN        30          // как FIRE_SPARK_LIFE_*
+#define LIFE_MAX        75
+#define FADE_MIN        80
+#define CAP_OLD         12          // FIRE_SPARKS_MAX в baseline (и снова сейчас)
+#define CAP_NEW         (CAP_OLD * 10)
+#define CAP_FIRE_X8     (CAP_OLD * 8)  // ёмкость, которую просил user-020 для FIRE
+#define CAP_BIG         (CAP_OLD * 100) // только для цены ёмкости
+#define EQ_FRAMES       3000
+#define BENCH_FRAMES    20000
+
+FX_PSYS_DEFINE(s_ps, CAP_BIG);
+static ref_spark_t s_old[CAP_BIG];
+static uint8_t     s_frame[FRAME_BYTES];
+
+/* Детерминированный ГСЧ теста: одинаковые искры в обе реализации */
+static uint32_t s_lcg = 1u;
+
+static uint8_t lcg_u8(void)
+{
+    s_lcg = s_lcg * 1664525u + 1013904223u;
+    return (uint8_t)(s_lcg >> 24);
+}
+
+typedef struct {
+    int16_t x_q8, y_q8, vx_q8, vy_q8;
+    uint8_t r, g, b, life, tail;
+} spark_init_t;
+
+/* Параметры как в FIRE sparks_spawn */
+static spark_init_t spark_rand(void)
+{
+    static const uint8_t k_col[3][3] = { { 10, 40, 220 }, { 10, 170, 200 }, { 10, 220, 50 } };
+    spark_init_t s;
+    const int x = (int)(lcg_u8() % MATRIX_W);
+    s.x_q8  = (int16_t)(x * 256 + ((int)(lcg_u8() & 0x7F) - 64));
+    s.y_q8  = (int16_t)((int)(lcg_u8() % 3) * 256);
+    s.vy_q8 = (int16_t)(140 + lcg_u8() % 121);
+    s.vx_q8 = (int16_t)((int)(lcg_u8() % 101) - 50);
+    const uint8_t *c = k_col[lcg_u8() % 3];
+    s.r = c[0]; s.g = c[1]; s.b = c[2];
+    s.life = (uint8_t)(LIFE_MIN + lcg_u8() % (LIFE_MAX - LIFE_MIN + 1));
+    s.tail = (uint8_t)((lcg_u8() & 1) ? 0 : 1 + (lcg_u8() & 1));
+    return s;
+}
+
+static void new_spawn(const spark_init_t *s)
+{
+    const int i = fx_psys_spawn(&s_ps);
+    if (i < 0) return;
+    s_ps.x_q8[i] = s->x_q8; s_ps.y_q8[i] = s->y_q8;
+    s_ps.vx_q8[i] = s->vx_q8; s_ps.vy_q8[i] = s->vy_q8;
+    s_ps.r[i] = s->r; s_ps.g[i] = s->g; s_ps.b[i] = s->b;
+    s_ps.life[i] = s->life; s_ps.tail[i] = s->tail;
+}
+
+/* baseline: первый свободный слот */
+static void old_spawn(int cap, const spark_init_t *s)
+{
+    for (int i = 0; i < cap; i++) {
+        ref_spark_t *o = &s_old[i];
+        if (o->alive) continue;
+        o->alive = true;
+        o->x_q8 = s->x_q8; o->y_q8 = s->y_q8;
+        o->vx_q8 = s->vx_q8; o->vy_q8 = s->vy_q8;
+        o->r = s->r; o->g = s->g; o->b = s->b;
+        o->life = s->life; o->tail = s->tail;
+        return;
+    }
+}
+
+static int old_alive(int cap)
+{
+    int n = 0;
+    for (int i = 0; i < cap; i++) n += s_old[i].alive;
+    return n;
+}
+
+static void reset_both(uint16_t cap_new)
+{
+    s_ps.cap = cap_new;
+    fx_psys_init(&s_ps, MATRIX_W, MATRIX_H, true, LIFE_MAX, FADE_MIN);
+    memset(s_old, 0, sizeof(s_old));
+    s_lcg = 0x5A7Au;
+}
+
+/* ============================================================
+ * Инварианты пула
+ * ============================================================ */
+
+static void check_pool(void)
+{
+    static uint8_t seen[CAP_BIG];
+    memset(seen, 0, sizeof(seen));
+
+    CHECK_EQ_U((uint32_t)s_ps.count + s_ps.nfree, s_ps.cap);
+    for (uint16_t p = 0; p < s_ps.count; p++) {
+        const uint16_t i = s_ps.live[p];
+        CHECK(i < s_ps.cap);
+        if (i >= s_ps.cap) return;
+        CHECK_EQ_U(seen[i], 0);
+        seen[i] = 1;
+        CHECK(s_ps.x_q8[i] >= 0 && s_ps.x_q8[i] < (int)MATRIX_W * 256);
+        CHECK(s_ps.y_q8[i] >= 0 && s_ps.y_q8[i] < (int)MATRIX_H * 256);
+    }
+    for (uint16_t f = 0; f < s_ps.nfree; f++) {
+        const uint16_t i = s_ps.free[f];
+        CHECK(i < s_ps.cap);
+        if (i >= s_ps.cap) return;
+        CHECK_EQ_U(seen[i], 0);
+        seen[i] = 1;
+    }
+}
+
+static void test_pool_invariants(void)
+{
+    reset_both(CAP_NEW);
+    uint32_t full = 0;
+
+    for (uint32_t f = 0; f < EQ_FRAMES; f++) {
+        const uint8_t n = lcg_u8() & 15u;          // переполнение пула тоже проверяется
+        for (uint8_t k = 0; k < n; k++) {
+            const spark_init_t s = spark_rand();
+            if (s_ps.nfree == 0) full++;
+            new_spawn(&s);
+        }
+        fx_psys_integrate(&s_ps, (int16_t)((int)(lcg_u8() & 63) - 32), 0, 256u);
+        if ((f % 997u) == 996u) fx_psys_clear(&s_ps);
+        check_pool();
+    }
+    CHECK(full > 0);
+}
+
+/* ============================================================
+ * Кадр против baseline
+ * ============================================================ */
+
+static void test_equivalence(void)
+{
+    // 220*40/255 = 35 на канал: до 7 наложений без насыщения, clamp на записи == HDR
+    const uint8_t bri = 40;
+    uint32_t bad_frames = 0, live_max = 0;
+
+    reset_both(CAP_NEW);
+    for (uint32_t f = 0; f < EQ_FRAMES; f++) {
+        const int16_t wind = (int16_t)(((int)(f % 400u) - 200) * 4);
+        const int want = (f / 500u) % 2u ? CAP_NEW : 24;
+
+        while (s_ps.count < want) {
+            const spark_init_t s = spark_rand();
+            new_spawn(&s);
+            old_spawn(CAP_NEW, &s);
+        }
+
+        ref_canvas_clear(0, 0, 0);
+        ref_sparks_step_and_render(s_old, CAP_NEW, LIFE_MAX, bri, wind);
+
+        fx_canvas_clear(0, 0, 0);
+        fx_psys_integrate(&s_ps, (int16_t)(wind / 60), 0, 256u);
+        fx_psys_splat(&s_ps, NULL, bri, FX_PSYS_SPLAT_HDR_ADD);
+        fx_canvas_flatten(NULL, s_frame);
+
+        bad_frames += (memcmp(s_frame, ref_canvas_buf(), FRAME_BYTES) != 0);
+        bad_frames += ((int)s_ps.count != old_alive(CAP_NEW));
+        if (s_ps.count > live_max) live_max = s_ps.count;
+    }
+    printf("sparks: %u/%u frames differ from baseline (up to %u live)\n",
+           (unsigned)bad_frames, (unsigned)EQ_FRAMES, (unsigned)live_max);
+    CHECK_EQ_U(bad_frames, 0);
+}
+
+/* ============================================================
+ * Бенчмарк
+ * ============================================================ */
+
+/* us/кадр: держим live живых (добор каждый кадр теми же искрами); clear кадра — memset у обоих */
+static double bench_old(int cap, int live)
+{
+    double us = 0.0;
+    reset_both(CAP_BIG);
+    HOST_BENCH(us, BENCH_FRAMES, {
+        for (int n = old_alive(cap); n < live; n++) {
+            const spark_init_t s = spark_rand();
+            old_spawn(cap, &s);
+        }
+        memset(ref_canvas_buf(), 0, FRAME_BYTES);
+        ref_sparks_step_and_render(s_old, cap, LIFE_MAX, 102, 120);
+        memcpy(s_frame, ref_canvas_buf(), FRAME_BYTES);
+    });
+    g_host_sink = s_frame[7];
+    return us;
+}
+
+static double bench_new(uint16_t cap, int live)
+{
+    double us = 0.0;
+    reset_both(cap);
+    HOST_BENCH(us, BENCH_FRAMES, {
+        while (s_ps.count < live) {
+            const spark_init_t s = spark_rand();
+            new_spawn(&s);
+        }
+        fx_canvas_clear(0, 0, 0);
+        fx_psys_integrate(&s_ps, 2, 0, 256u);
+        fx_psys_splat(&s_ps, NULL, 102, FX_PSYS_SPLAT_HDR_ADD);
+        fx_canvas_flatten(NULL, s_frame);
+    });
+    g_host_sink = s_frame[7];
+    return us;
+}
+
+static void bench_sparks(void)
+{
+    const double old_empty = bench_old(CAP_OLD, 0);
+    const double new_empty = bench_new(CAP_OLD, 0);
+
+    // цена ёмкости при тех же 12 живых: baseline проходит все слоты, пул — только живые
+    const double old_12   = bench_old(CAP_OLD, CAP_OLD);
+    const double old_12b  = bench_old(CAP_BIG, CAP_OLD);
+    const double new_12   = bench_new(CAP_OLD, CAP_OLD);
+    const double new_12b  = bench_new(CAP_BIG, CAP_OLD);
+    printf("capacity %d -> %d at %d live: old %.3f -> %.3f us, new %.3f -> %.3f us\n",
+           CAP_OLD, CAP_BIG, CAP_OLD, old_12, old_12b, new_12, new_12b);
+    host_bench_report("sparks frame, 12 live, cap 12", old_12, new_12);
+
+    // полная загрузка; у нового пути сюда входит tone-map HDR тронутых пикселей (у baseline —
+    // clamp на каждой записи), это цена user-016, а не пула
+    const double old_120 = bench_old(CAP_NEW, CAP_NEW);
+    const double new_120 = bench_new(CAP_NEW, CAP_NEW);
+    host_bench_report("sparks frame, 120 live, cap 120", old_120, new_120);
+    printf("per particle: old %.4f us, new %.4f us (empty frame %.3f / %.3f us)\n",
+           (old_120 - old_empty) / CAP_NEW, (new_120 - new_empty) / CAP_NEW, old_empty, new_empty);
+
+    // нагрузка FIRE (BURST 1 раз в 2.5..8 s -> 0..2 живых): цена стадии искр без пустого кадра,
+    // baseline с ёмкостью 12 против пула с ёмкостью x8
+    const double old_2 = bench_old(CAP_OLD, 2) - old_empty;
+    const double new_2 = bench_new(CAP_FIRE_X8, 2) - bench_new(CAP_FIRE_X8, 0);
+    host_bench_report("sparks stage, 2 live, cap 12 vs 96", old_2, new_2);
+
+    // ёмкость бесплатна только у пула; цена на частицу — того же порядка, x5..10 живых она не даёт
+    CHECK(old_12b > old_12 * 2.0);
+    CHECK(new_12b < new_12 * 1.5);
+}
+
+int main(void)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+
+    test_pool_invariants();
+    test_equivalence();
+    bench_sparks();
+    return host_test_done("test_fx_particles");
+}
@@ -0,0 +1,112 @@
+/*
+ * test_fx_shader.c — row shader против per-pixel render (user-012)
+ *
+ *   - DIAG RAINBOW / GLITTER RAINBOW / RADIAL RIPPLE: кадр shader-формы (fx_engine -> canvas)
+ *     совпадает с baseline render (hsv_to_rgb + set_pixel_xy) побайтно;
+ *   - бенчмарк: us на кадр baseline render (per-pixel set_pixel_xy с яркостью) против
+ *     fx_engine_render (shader по строкам, один поток) + fx_canvas_present (bulk в back-буфер).
+ *     Яркость/гамма в новом пути — выходной каскад submit (test_ws2812_output).
+ */
+#include <stdlib.h>
+
+#include "host_test.h"
+
+#include "fx_engine.h"
+#include "fx_canvas.h"
+#include "matrix_ws2812.h"
+#include "ref/ref_ws2812.h"
+#include "ref/ref_fx_simple.h"
+
+#define FRAME_BYTES     ((uint32_t)MATRIX_W * MATRIX_H * 3u)
+#define BENCH_FRAMES    2000
+
+typedef struct {
+    uint16_t    id;
+    const char *name;
+    void      (*ref)(fx_ctx_t *ctx);
+    int         max_diff;   // допуск против baseline (RAINBOW LUT == hsv_to_rgb побайтно)
+} shader_case_t;
+
+static const shader_case_t k_cases[] = {
+    { 0xEA03, "diag_rainbow",   ref_fx_diag_rainbow_render,   0 },
+    { 0xEA04, "glitter_rainbow", ref_fx_glitter_rainbow_render, 0 },
+    { 0xEA05, "radial_ripple",  ref_fx_radial_ripple_render,  0 },
+};
+
+static uint8_t s_frame[FRAME_BYTES];
+
+static fx_ctx_t ref_ctx(uint32_t t)
+{
+    fx_ctx_t c = {
+        .effect_id = 0, .brightness = 255, .speed_pct = 100, .paused = false,
+        .wall_ms = t, .wall_dt_ms = 25, .anim_ms = t, .anim_dt_ms = 25, .tier = FX_TIER_HIGH,
+    };
+    return c;
+}
+
+static void test_equivalence(const shader_case_t *c)
+{
+    ref_ws2812_set_brightness(255);   // scale_bri = identity: в strip — то, что дал эффект
+    fx_engine_set_effect(c->id);
+
+    int max_diff = 0;
+    for (uint32_t f = 0; f < 64; f++) {
+        const uint32_t t = 1000u + f * 97u;
+        fx_engine_render(fx_engine_get_effect(), t, 25, t, 25);
+        fx_canvas_flatten(NULL, s_frame);
+
+        fx_ctx_t rc = ref_ctx(t);
+        c->ref(&rc);
+        const uint8_t *strip = ref_ws2812_strip();
+
+        for (uint16_t y = 0; y < MATRIX_H; y++) {
+            for (uint16_t x = 0; x < MATRIX_W; x++) {
+                const uint8_t *n = &s_frame[((uint32_t)y * MATRIX_W + x) * 3u];
+                const uint8_t *o = &strip[(uint32_t)ref_ws2812_xy_to_index(x, y) * 3u];
+                const int d[3] = { abs(n[0] - o[1]), abs(n[1] - o[0]), abs(n[2] - o[2]) };
+                for (int k = 0; k < 3; k++) if (d[k] > max_diff) max_diff = d[k];
+            }
+        }
+    }
+    printf("%s: max |shader - baseline| = %d\n", c->name, max_diff);
+    CHECK(max_diff <= c->max_diff);
+}
+
+static void bench(const shader_case_t *c)
+{
+    double old_us = 0.0, new_us = 0.0;
+
+    ref_ws2812_set_brightness(102);
+    HOST_BENCH(old_us, BENCH_FRAMES, {
+        fx_ctx_t rc = ref_ctx((uint32_t)it_ * 25u);
+        c->ref(&rc);
+    });
+    g_host_sink = ref_ws2812_strip()[7];
+
+    fx_engine_set_effect(c->id);
+    HOST_BENCH(new_us, BENCH_FRAMES, {
+        const uint32_t t = (uint32_t)it_ * 25u;
+        fx_engine_render(fx_engine_get_effect(), t, 25, t, 25);
+        fx_canvas_present();
+    });
+
+    char name[64];
+    snprintf(name, sizeof(name), "shader %s us/frame", c->name);
+    host_bench_report(name, old_us, new_us);
+}
+
+int main(void)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    matrix_ws2812_set_brightness(102);
+    fx_engine_set_frame_budget_us(10000000u);   // tier HIGH при любом времени хоста
+    fx_engine_set_speed_pct(100);
+    fx_engine_set_brightness(102);
+    // fx_engine_init() не зовём: без worker'а fx_engine_parallel_rows идёт serial (один core)
+
+    for (size_t i = 0; i < sizeof(k_cases) / sizeof(k_cases[0]); i++) {
+        test_equivalence(&k_cases[i]);
+        bench(&k_cases[i]);
+    }
+    return host_test_done("test_fx_shader");
+}
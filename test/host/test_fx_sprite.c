@@ -0,0 +1,327 @@
+/*
+ * test_fx_sprite.c — RLE-спрайты fx_sprite (user-021)
+ *
+ *   - пакет собирается здесь же по формату fx_sprite.h (как tools/fx_sprite_pack.py);
+ *   - blit побайтно равен попиксельной отрисовке исходной картинки (a=0 пропуск, a=255 замена,
+ *     иначе lerp; bri через fx_scale8_video) при случайных размерах, позициях за краями,
+ *     с FX_SPR_WRAP_X и без;
+ *   - битые пакеты отклоняются (magic/version, total_size, таблица строк);
+ *   - бенчмарк: полноэкранный спрайт 16x48 — fx_sprite_blit против попиксельного
+ *     fx_canvas_set() из RGBA-массива (единственный примитив до user-021).
+ */
+#include "host_test.h"
+#include "esp_random.h"
+
+#include "fx_canvas.h"
+#include "fx_math.h"
+#include "fx_sprite.h"
+#include "matrix_ws2812.h"
+
+#define FRAME_BYTES     ((uint32_t)MATRIX_W * MATRIX_H * 3u)
+#define SPR_MAX_W       40
+#define SPR_MAX_H       64
+#define PACK_MAX        (64u * 1024u)
+#define BLIT_CASES      4000
+#define BENCH_FRAMES    20000
+
+/* Картинка-источник: индексы сверху вниз + палитра RGBA */
+typedef struct {
+    char    name[FX_SPRITE_NAME_LEN];
+    uint8_t w, h;
+    uint16_t pal_n;
+    uint8_t pal[256][4];
+    uint8_t idx[SPR_MAX_H][SPR_MAX_W];
+} spr_src_t;
+
+static uint8_t s_pack[PACK_MAX];
+static uint8_t s_base[FRAME_BYTES], s_exp[FRAME_BYTES], s_out[FRAME_BYTES];
+
+static uint32_t rnd(uint32_t n)
+{
+    return esp_random() % n;
+}
+
+static void wr16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void wr32(uint8_t *p, uint32_t v) { wr16(p, (uint16_t)v); wr16(p + 2, (uint16_t)(v >> 16)); }
+
+/* ============================================================
+ * Пакет
+ * ============================================================ */
+
+/* RLE строки: повтор от 3 одинаковых, иначе литералы; токены до 128 */
+static uint32_t rle_row(const uint8_t *src, int w, uint8_t *out)
+{
+    uint32_t o = 0;
+    int i = 0;
+    while (i < w) {
+        int run = 1;
+        while (i + run < w && run < 128 && src[i + run] == src[i]) run++;
+        if (run >= 3) {
+            out[o++] = (uint8_t)(0x80u | (run - 1));
+            out[o++] = src[i];
+            i += run;
+            continue;
+        }
+        int lit = 0;
+        while (i + lit < w && lit < 128) {
+            if (i + lit + 2 < w && src[i + lit] == src[i + lit + 1] && src[i + lit] == src[i + lit + 2]) break;
+            lit++;
+        }
+        out[o++] = (uint8_t)(lit - 1);
+        memcpy(&out[o], &src[i], (size_t)lit);
+        o += (uint32_t)lit;
+        i += lit;
+    }
+    return o;
+}
+
+static uint32_t pack_build(const spr_src_t *spr, int n)
+{
+    uint32_t o = 12u + (uint32_t)n * 16u;
+
+    memset(s_pack, 0, sizeof(s_pack));
+    memcpy(s_pack, "JSPK", 4);
+    wr16(s_pack + 4, 1);
+    wr16(s_pack + 6, (uint16_t)n);
+
+    for (int k = 0; k < n; k++) {
+        const spr_src_t *s = &spr[k];
+        uint8_t *e = &s_pack[12u + (uint32_t)k * 16u];
+        memcpy(e, s->name, FX_SPRITE_NAME_LEN);
+        wr32(e + FX_SPRITE_NAME_LEN, o);
+
+        uint8_t *h = &s_pack[o];
+        h[0] = s->w; h[1] = s->h; h[2] = (uint8_t)(s->pal_n & 0xFFu); h[3] = 0;
+        o += 4u;
+        memcpy(&s_pack[o], s->pal, (size_t)s->pal_n * 4u);
+        o += (uint32_t)s->pal_n * 4u;
+
+        uint8_t *rowofs = &s_pack[o];
+        o += (uint32_t)s->h * 2u;
+        const uint32_t rle0 = o;
+        for (int y = 0; y < s->h; y++) {
+            wr16(rowofs + y * 2, (uint16_t)(o - rle0));
+            o += rle_row(s->idx[y], s->w, &s_pack[o]);
+        }
+    }
+    wr32(s_pack + 8, o);
+    return o;
+}
+
+/* ============================================================
+ * Эталон: попиксельно по исходной картинке
+ * ============================================================ */
+
+static void ref_blit(uint8_t *frame, const spr_src_t *s, int x, int y, uint8_t bri, bool wrap)
+{
+    for (int sy = 0; sy < s->h; sy++) {
+        const int cy = y + s->h - 1 - sy;
+        if (cy < 0 || cy >= (int)MATRIX_H) continue;
+        for (int sx = 0; sx < s->w; sx++) {
+            int cx = x + sx;
+            if (wrap) {
+                cx %= (int)MATRIX_W;
+                if (cx < 0) cx += (int)MATRIX_W;
+            } else if (cx < 0 || cx >= (int)MATRIX_W) {
+                continue;
+            }
+            const uint8_t *c = s->pal[s->idx[sy][sx]];
+            if (c[3] == 0) continue;
+            uint8_t *d = &frame[((uint32_t)cy * MATRIX_W + (uint32_t)cx) * 3u];
+            for (int i = 0; i < 3; i++) {
+                const uint8_t v = fx_scale8_video(c[i], bri);
+                d[i] = (c[3] == 255) ? v : fx_lerp8(d[i], v, c[3]);
+            }
+        }
+    }
+}
+
+/* Случайная картинка: отрезки одного цвета (RLE-повторы) вперемешку с шумом (литералы) */
+static void spr_random(spr_src_t *s, const char *name)
+{
+    memset(s, 0, sizeof(*s));
+    strncpy(s->name, name, FX_SPRITE_NAME_LEN);
+    s->w = (uint8_t)(1 + rnd(SPR_MAX_W));
+    s->h = (uint8_t)(1 + rnd(SPR_MAX_H));
+    s->pal_n = (uint16_t)(1 + rnd(256));
+    for (int i = 0; i < s->pal_n; i++) {
+        const uint32_t a = rnd(4);
+        s->pal[i][0] = (uint8_t)rnd(256);
+        s->pal[i][1] = (uint8_t)rnd(256);
+        s->pal[i][2] = (uint8_t)rnd(256);
+        s->pal[i][3] = (a == 0) ? 0 : (a == 1) ? (uint8_t)(1 + rnd(254)) : 255;
+    }
+    for (int y = 0; y < s->h; y++) {
+        int x = 0;
+        while (x < s->w) {
+            const int len = 1 + (int)rnd(rnd(2) ? 12 : 2);
+            const uint8_t v = (uint8_t)rnd(s->pal_n);
+            for (int k = 0; k < len && x < s->w; k++, x++) {
+                s->idx[y][x] = rnd(3) ? v : (uint8_t)rnd(s->pal_n);
+            }
+        }
+    }
+}
+
+static void test_blit_matches_ref(void)
+{
+    static spr_src_t spr[4];
+    uint32_t bad = 0;
+
+    host_random_seed(0x5B217u);
+    for (uint32_t c = 0; c < BLIT_CASES; c++) {
+        if (c % 200u == 0) {
+            char name[FX_SPRITE_NAME_LEN];
+            for (int k = 0; k < 4; k++) {
+                snprintf(name, sizeof(name), "s%u_%d", (unsigned)c, k);
+                spr_random(&spr[k], name);
+            }
+            const uint32_t size = pack_build(spr, 4);
+            CHECK_EQ_U(fx_sprite_attach(s_pack, size), ESP_OK);
+            CHECK_EQ_U(fx_sprite_count(), 4);
+        }
+
+        const spr_src_t *src = &spr[rnd(4)];
+        const fx_sprite_t *s = fx_sprite_find(src->name);
+        if (!s) { bad++; continue; }
+
+        const int x = (int)rnd(MATRIX_W + SPR_MAX_W * 2) - SPR_MAX_W;
+        const int y = (int)rnd(MATRIX_H + SPR_MAX_H * 2) - SPR_MAX_H;
+        const uint8_t bri = (uint8_t)(rnd(4) ? rnd(256) : 255);
+        const bool wrap = rnd(2) != 0;
+
+        for (uint32_t i = 0; i < FRAME_BYTES; i++) s_base[i] = (uint8_t)rnd(256);
+        memcpy(s_exp, s_base, FRAME_BYTES);
+        ref_blit(s_exp, src, x, y, bri, wrap);
+
+        fx_canvas_load(s_base);
+        fx_sprite_blit(s, x, y, bri, wrap ? FX_SPR_WRAP_X : FX_SPR_NONE);
+        fx_canvas_flatten(NULL, s_out);
+        bad += (memcmp(s_out, s_exp, FRAME_BYTES) != 0);
+    }
+    printf("blit: %u/%u random blits differ from per-pixel reference\n", (unsigned)bad, (unsigned)BLIT_CASES);
+    CHECK_EQ_U(bad, 0);
+}
+
+static void test_bad_packs(void)
+{
+    static spr_src_t spr;
+    host_random_seed(0xBAD5u);
+    spr_random(&spr, "one");
+    const uint32_t size = pack_build(&spr, 1);
+    CHECK_EQ_U(fx_sprite_attach(s_pack, size), ESP_OK);
+
+    CHECK_EQ_U(fx_sprite_attach(s_pack, size - 1u), ESP_ERR_INVALID_SIZE);   // total > size
+
+    s_pack[0] ^= 0xFFu;
+    CHECK_EQ_U(fx_sprite_attach(s_pack, size), ESP_ERR_INVALID_VERSION);
+    s_pack[0] ^= 0xFFu;
+
+    // последняя строка указывает за конец пакета
+    const uint32_t ofs = 12u + 16u;
+    const uint32_t rowofs = ofs + 4u + (uint32_t)spr.pal_n * 4u + (uint32_t)(spr.h - 1) * 2u;
+    const uint8_t keep0 = s_pack[rowofs], keep1 = s_pack[rowofs + 1];
+    wr16(&s_pack[rowofs], 0xFFFFu);
+    CHECK_EQ_U(fx_sprite_attach(s_pack, size), ESP_ERR_INVALID_SIZE);
+    CHECK_EQ_U(fx_sprite_count(), 0);
+    CHECK(fx_sprite_find("one") == NULL);
+    s_pack[rowofs] = keep0; s_pack[rowofs + 1] = keep1;
+    CHECK_EQ_U(fx_sprite_attach(s_pack, size), ESP_OK);
+}
+
+/* ============================================================
+ * Бенчмарк: полноэкранный спрайт
+ * ============================================================ */
+
+/* "Лицо": фон-ключ, овал с плавной заливкой, глаза/рот, немного шума — как нарисованная иконка */
+static void spr_face(spr_src_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    strncpy(s->name, "face", FX_SPRITE_NAME_LEN);
+    s->w = MATRIX_W;
+    s->h = MATRIX_H;
+    s->pal_n = 32;
+    for (int i = 1; i < 32; i++) {
+        s->pal[i][0] = (uint8_t)(20 + i * 7);
+        s->pal[i][1] = (uint8_t)(40 + i * 5);
+        s->pal[i][2] = (uint8_t)(200 - i * 3);
+        s->pal[i][3] = (i == 31) ? 128 : 255;   // 31 — полупрозрачное свечение
+    }
+    for (int y = 0; y < s->h; y++) {
+        for (int x = 0; x < s->w; x++) {
+            const int dx = 2 * x - ((int)MATRIX_W - 1), dy = 2 * y - ((int)MATRIX_H - 1);
+            const int r2 = dx * dx * 9 + dy * dy;   // эллипс 16x48
+            uint8_t v = 0;
+            if (r2 < 48 * 48) v = (uint8_t)(1 + (y * 24) / (int)MATRIX_H + ((x ^ y) & 1) * (y > 30));
+            else if (r2 < 52 * 52) v = 31;
+            if ((y == 16 || y == 17) && (x == 4 || x == 5 || x == 10 || x == 11)) v = 28;
+            if (y == 32 && x >= 5 && x <= 10) v = 29;
+            s->idx[y][x] = v;
+        }
+    }
+}
+
+/* До user-021: картинка RGBA в RAM, пиксель за пикселем через fx_canvas_get/set */
+static void draw_rgba(const uint8_t (*rgba)[MATRIX_W][4], uint8_t bri)
+{
+    for (int sy = 0; sy < (int)MATRIX_H; sy++) {
+        const uint16_t cy = (uint16_t)(MATRIX_H - 1 - sy);
+        for (int x = 0; x < (int)MATRIX_W; x++) {
+            const uint8_t *c = rgba[sy][x];
+            if (c[3] == 0) continue;
+            uint8_t r = fx_scale8_video(c[0], bri);
+            uint8_t g = fx_scale8_video(c[1], bri);
+            uint8_t b = fx_scale8_video(c[2], bri);
+            if (c[3] != 255) {
+                uint8_t br, bg, bb;
+                fx_canvas_get((uint16_t)x, cy, &br, &bg, &bb);
+                r = fx_lerp8(br, r, c[3]);
+                g = fx_lerp8(bg, g, c[3]);
+                b = fx_lerp8(bb, b, c[3]);
+            }
+            fx_canvas_set((uint16_t)x, cy, r, g, b);
+        }
+    }
+}
+
+static void bench_full_screen(void)
+{
+    static spr_src_t face;
+    static uint8_t rgba[MATRIX_H][MATRIX_W][4];
+    double old_us = 0.0, new_us = 0.0;
+
+    spr_face(&face);
+    const uint32_t size = pack_build(&face, 1);
+    CHECK_EQ_U(fx_sprite_attach(s_pack, size), ESP_OK);
+    const fx_sprite_t *s = fx_sprite_find("face");
+    CHECK(s != NULL);
+    if (!s) return;
+
+    for (int y = 0; y < (int)MATRIX_H; y++) {
+        for (int x = 0; x < (int)MATRIX_W; x++) memcpy(rgba[y][x], face.pal[face.idx[y][x]], 4);
+    }
+
+    const uint8_t bri = 200;
+    HOST_BENCH(old_us, BENCH_FRAMES, { draw_rgba(rgba, bri); });
+    fx_canvas_flatten(NULL, s_exp);
+
+    HOST_BENCH(new_us, BENCH_FRAMES, {
+        fx_sprite_blit(s, 0, 0, bri, FX_SPR_NONE);
+    });
+    fx_canvas_flatten(NULL, s_out);
+    CHECK_MEM(s_out, s_exp, FRAME_BYTES);
+
+    host_bench_report("full-screen sprite 16x48 (get/set per px -> RLE blit)", old_us, new_us);
+    printf("face: %u bytes in pack vs %u RGBA (%u RGB)\n",
+           (unsigned)(size - 12u - 16u), (unsigned)(MATRIX_W * MATRIX_H * 4u), (unsigned)FRAME_BYTES);
+}
+
+int main(void)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+
+    test_blit_matches_ref();
+    test_bad_packs();
+    bench_full_screen();
+    return host_test_done("test_fx_sprite");
+}
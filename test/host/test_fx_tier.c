@@ -0,0 +1,166 @@
+/*
+ * test_fx_tier.c — tier-контроллер fx_engine (user-009)
+ *
+ * Стоимость render задаётся шаговыми часами (host_timer_step_us): fx_engine меряет render парой
+ * esp_timer_get_time(), shader-эффект часы сам не трогает -> render_us == шаг. Бюджет кадра 10 ms:
+ * промах > 7000 us (70%), запас < 4000 us (40%).
+ *   - leaky bucket: промах +2, кадр в бюджете -1, понижение при score >= 6 — ровно на том кадре;
+ *     "промах через кадр" понижает, "промах раз в три кадра" — никогда; ниже LOW не падаем;
+ *   - повышение после up_hold кадров с запасом подряд (кадр без запаса сбрасывает серию);
+ *   - понижение раньше up_hold кадров после повышения удваивает up_hold (64 -> ... -> 512, дальше нет),
+ *     прижившееся повышение — не удваивает.
+ */
+#include "host_test.h"
+
+#include "esp_timer.h"
+#include "fx_engine.h"
+#include "matrix_ws2812.h"
+
+#define FX_A            0xEA03u
+#define FX_B            0xEA05u
+#define BUDGET_US       10000u
+
+// Стоимости кадра против бюджета 10 ms (дефолты fx_engine.c: 70% / 40%)
+#define COST_MISS       9000u   // > 7000: промах
+#define COST_MID        5000u   // в бюджете, но без запаса: score -1, серия сбрасывается
+#define COST_OK         2000u   // < 4000: запас, серия растёт
+
+// Дефолты fx_engine.c
+#define DOWN_SCORE      6u
+#define UP_HOLD_MIN     64u
+#define UP_HOLD_MAX     512u
+
+static uint32_t s_anim_ms;
+
+static fx_tier_stats_t feed(uint16_t id, uint32_t cost_us)
+{
+    host_timer_step_us(cost_us);
+    s_anim_ms += 25u;
+    fx_engine_render(id, s_anim_ms, 25u, s_anim_ms, 25u);
+    host_timer_step_us(0);
+
+    fx_tier_stats_t st;
+    fx_engine_get_tier_stats(&st);
+    return st;
+}
+
+// Смена эффекта -> tier_reset: следующий кадр FX_A — первый кадр с HIGH и up_hold = MIN
+static void fresh(void)
+{
+    (void)feed(FX_B, COST_MID);
+}
+
+static fx_tier_stats_t feed_n(uint32_t n, uint32_t cost_us)
+{
+    fx_tier_stats_t st = { 0 };
+    for (uint32_t i = 0; i < n; i++) st = feed(FX_A, cost_us);
+    return st;
+}
+
+static void test_leaky_bucket(void)
+{
+    // промах через кадр: score 2,1,3,2,4,3,5,4,6 -> понижение на 9-м кадре
+    fresh();
+    fx_tier_stats_t st = { 0 };
+    for (uint32_t f = 1; f <= 8; f++) {
+        st = feed(FX_A, (f & 1u) ? COST_MISS : COST_MID);
+        CHECK_EQ_U(st.tier, FX_TIER_HIGH);
+    }
+    CHECK_EQ_U(st.miss_score, DOWN_SCORE - 2u);
+    CHECK_EQ_U(st.render_us, COST_MID);
+    CHECK_EQ_U(st.budget_us, BUDGET_US * 70u / 100u);
+    const uint32_t down0 = st.downgrades;
+    st = feed(FX_A, COST_MISS);
+    CHECK_EQ_U(st.tier, FX_TIER_MID);
+    CHECK_EQ_U(st.downgrades, down0 + 1u);
+    CHECK_EQ_U(st.miss_score, 0);
+
+    // промах раз в три кадра: score 2,1,0 — bucket утекает, понижения нет
+    fresh();
+    for (uint32_t f = 0; f < 300; f++) {
+        st = feed(FX_A, (f % 3u) == 0 ? COST_MISS : COST_MID);
+        CHECK_EQ_U(st.tier, FX_TIER_HIGH);
+    }
+
+    // промахи подряд: по tier на каждые три кадра, LOW — пол
+    fresh();
+    const uint32_t down1 = feed(FX_A, COST_MID).downgrades;
+    st = feed_n(2, COST_MISS);
+    CHECK_EQ_U(st.tier, FX_TIER_HIGH);
+    st = feed_n(1, COST_MISS);
+    CHECK_EQ_U(st.tier, FX_TIER_MID);
+    st = feed_n(3, COST_MISS);
+    CHECK_EQ_U(st.tier, FX_TIER_LOW);
+    st = feed_n(30, COST_MISS);
+    CHECK_EQ_U(st.tier, FX_TIER_LOW);
+    CHECK_EQ_U(st.downgrades, down1 + 2u);
+    CHECK(st.miss_score >= DOWN_SCORE);   // на полу bucket копится, но понижать некуда
+}
+
+// HIGH -> MID тремя промахами; up_hold решается на кадре понижения
+static fx_tier_stats_t drop_to_mid(void)
+{
+    const fx_tier_stats_t st = feed_n(3, COST_MISS);
+    CHECK_EQ_U(st.tier, FX_TIER_MID);
+    return st;
+}
+
+// Ровно hold кадров с запасом: на hold-1 ещё MID, на hold — HIGH
+static void climb(uint32_t hold)
+{
+    fx_tier_stats_t st = feed_n(hold - 1u, COST_OK);
+    CHECK_EQ_U(st.tier, FX_TIER_MID);
+    CHECK_EQ_U(st.ok_streak, hold - 1u);
+    st = feed(FX_A, COST_OK);
+    CHECK_EQ_U(st.tier, FX_TIER_HIGH);
+    CHECK_EQ_U(st.ok_streak, 0);
+}
+
+static void test_up_hold(void)
+{
+    fresh();
+    fx_tier_stats_t st = drop_to_mid();
+    CHECK_EQ_U(st.up_hold, UP_HOLD_MIN);   // первое понижение: повышения ещё не было
+
+    // кадр без запаса посреди серии сбрасывает её
+    st = feed_n(UP_HOLD_MIN - 1u, COST_OK);
+    st = feed(FX_A, COST_MID);
+    CHECK_EQ_U(st.ok_streak, 0);
+    st = feed_n(UP_HOLD_MIN - 1u, COST_OK);
+    CHECK_EQ_U(st.tier, FX_TIER_MID);
+
+    // повышение, сразу понижение -> up_hold x2, и так до MAX
+    const uint32_t up0 = st.upgrades;
+    st = feed(FX_A, COST_OK);
+    CHECK_EQ_U(st.tier, FX_TIER_HIGH);
+    CHECK_EQ_U(st.upgrades, up0 + 1u);
+    uint32_t hold = UP_HOLD_MIN;
+    for (int round = 0; round < 4; round++) {
+        st = drop_to_mid();
+        if (hold < UP_HOLD_MAX) hold *= 2u;
+        CHECK_EQ_U(st.up_hold, hold);
+        climb(hold);
+    }
+    CHECK_EQ_U(hold, UP_HOLD_MAX);
+
+    // прижившееся повышение (>= up_hold кадров до промаха) up_hold не трогает
+    fresh();
+    (void)drop_to_mid();
+    climb(UP_HOLD_MIN);
+    st = feed_n(UP_HOLD_MIN, COST_MID);
+    CHECK_EQ_U(st.tier, FX_TIER_HIGH);
+    st = drop_to_mid();
+    CHECK_EQ_U(st.up_hold, UP_HOLD_MIN);
+}
+
+int main(void)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    fx_engine_init();
+    fx_engine_set_brightness(255);
+    fx_engine_set_frame_budget_us(BUDGET_US);
+
+    test_leaky_bucket();
+    test_up_hold();
+    return host_test_done("test_fx_tier");
+}
@@ -0,0 +1,122 @@
+/*
+ * test_fx_transition.c — переход между эффектами (user-025)
+ *
+ *   - effect_id кадра — снимок matrix_anim: fx_engine_render рисует переданный id, даже если
+ *     ctrl_bus уже сменил эффект (fx_engine_set_effect) посреди кадра;
+ *   - кадр begin() — прогрев: на экране ровно кадр уходящего (без смешивания), стоимость
+ *     входящего не попадает в tier;
+ *   - после окна перехода — ровно кадр входящего.
+ * Эффекты — shader DIAG RAINBOW / RADIAL RIPPLE: кадр зависит только от anim_ms.
+ * Сборка с переходами как в прошивке (lamp_host_trans: FX_TRANS_MODE / FX_TRANS_MS по умолчанию).
+ */
+#include "host_test.h"
+
+#include "fx_canvas.h"
+#include "fx_engine.h"
+#include "fx_transition.h"
+#include "matrix_ws2812.h"
+
+#define FX_A            0xEA03u
+#define FX_B            0xEA05u
+#define FRAME_BYTES     ((uint32_t)MATRIX_W * MATRIX_H * 3u)
+#define DT_MS           25u
+#define TRANS_MS        ((uint32_t)FX_TRANS_MS)
+#define SWITCH_FRAME    10u
+
+static uint8_t s_out[FRAME_BYTES];
+
+/* Кадр как в matrix_anim: render -> compose -> то, что уйдёт в present */
+static const uint8_t *frame(uint16_t id, uint32_t wall_ms, uint32_t anim_ms)
+{
+    fx_engine_render(id, wall_ms, DT_MS, anim_ms, DT_MS);
+    const uint8_t *src = fx_transition_compose(NULL);
+    if (src) return src;
+    fx_canvas_flatten(NULL, s_out);
+    return s_out;
+}
+
+/* Кадр эффекта id при anim_ms без перехода: если id — смена, её окно прогоняется до конца заранее */
+static void ref_frame(uint16_t id, uint32_t anim_ms, uint8_t *dst)
+{
+    fx_engine_set_effect(id);
+    do {
+        (void)frame(id, 0, anim_ms);
+    } while (fx_transition_active());
+
+    fx_engine_render(id, anim_ms, DT_MS, anim_ms, DT_MS);
+    fx_canvas_flatten(NULL, dst);
+}
+
+static void test_snapshot_and_warm(void)
+{
+    static uint8_t ref_a[FRAME_BYTES], ref_out[FRAME_BYTES], ref_b[FRAME_BYTES];
+
+    // anim: A — f * DT до смены; на кадре смены уходящий продолжает (+DT), входящий — с нуля (+DT)
+    const uint32_t a_last  = (SWITCH_FRAME - 1u) * DT_MS;
+    const uint32_t out_ms  = a_last + DT_MS;
+    const uint32_t end_f   = TRANS_MS / DT_MS + 2u;            // кадров после смены до проверки
+    const uint32_t b_end   = (end_f + 1u) * DT_MS;
+
+    // эталоны заранее: shader зависит только от anim_ms
+    ref_frame(FX_A, a_last, ref_a);
+    ref_frame(FX_A, out_ms, ref_out);
+    ref_frame(FX_B, b_end, ref_b);
+
+    // старт с A, переход на него уже отыгран
+    ref_frame(FX_A, 0, s_out);
+
+    uint32_t wall = 0;
+    for (uint32_t f = 1; f < SWITCH_FRAME; f++) {
+        wall += DT_MS;
+        uint16_t id = fx_engine_get_effect();
+        if (f == SWITCH_FRAME - 1u) fx_engine_set_effect(FX_B);   // ctrl_bus посреди кадра: снимок — A
+        const uint8_t *o = frame(id, wall, f * DT_MS);
+        CHECK(!fx_transition_active());
+        if (f == SWITCH_FRAME - 1u) CHECK_MEM(o, ref_a, FRAME_BYTES);
+    }
+
+    // кадр смены: matrix_anim видит B
+    CHECK_EQ_U(fx_engine_get_effect(), FX_B);
+    fx_tier_stats_t tier_before, tier_after;
+    fx_engine_get_tier_stats(&tier_before);
+
+    wall += DT_MS;
+    const uint8_t *o = frame(FX_B, wall, DT_MS);
+    CHECK(fx_transition_active());
+
+    // прогрев: на экране уходящий A своего anim-времени, без смешивания; стоимость — не в tier
+    CHECK_MEM(o, ref_out, FRAME_BYTES);
+    fx_transition_stats_t st;
+    fx_transition_get_stats(&st);
+    CHECK_EQ_U(st.progress, 0);
+    CHECK_EQ_U(st.mode, FX_TRANS_ALPHA);
+    fx_engine_get_tier_stats(&tier_after);
+    CHECK_EQ_U(tier_after.render_us, tier_before.render_us);
+    CHECK_EQ_U(tier_after.ok_streak, 0);   // tier_reset входящего, tier_update на прогреве не было
+
+    // дальше — смесь (smoothstep: прогресс > 0 через пару кадров), tier входящего считается
+    for (uint32_t f = 1; f <= end_f; f++) {
+        wall += DT_MS;
+        o = frame(FX_B, wall, (f + 1u) * DT_MS);
+        if (f == 4u) {
+            fx_transition_get_stats(&st);
+            CHECK(st.progress > 0u);
+            fx_engine_get_tier_stats(&tier_after);
+            CHECK_EQ_U(tier_after.ok_streak, 4);
+        }
+    }
+
+    // окно прошло: ровно входящий
+    CHECK(!fx_transition_active());
+    CHECK_MEM(o, ref_b, FRAME_BYTES);
+}
+
+int main(void)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    fx_engine_init();
+    fx_engine_set_brightness(255);
+
+    test_snapshot_and_warm();
+    return host_test_done("test_fx_transition");
+}
@@ -0,0 +1,208 @@
+/*
+ * test_matrix_anim_stats.c — always-on статистика кадров matrix_anim (user-010)
+ *
+ *   - log2-гистограмма: границы bucket'ов (0..1, 2^k, насыщение в последнем), отрицательные — в 0;
+ *   - запись кадра раскладывает длительности по своим гистограммам: post — только прошедшие
+ *     проходы (+ превышение бюджета), переход — только при trans_us >= 0, interval — со второго кадра;
+ *   - счётчики по эффектам: слот на effect_id, переполнение таблицы не теряет общих счётчиков;
+ *   - seqlock: читатель параллельно с writer-потоком видит только согласованные снимки
+ *     (frames == сумма любой гистограммы кадра == сумма по эффектам).
+ */
+#include <pthread.h>
+#include <unistd.h>
+
+#include "host_test.h"
+
+#include "fx_post.h"
+#include "matrix_anim.h"
+#include "matrix_anim_stats.h"
+
+#define FX_1            0x1001u
+#define FX_2            0x1002u
+#define FX_SEQ          0x2001u
+#define FRAME_US        45454
+
+static uint32_t hist_sum(const matrix_anim_hist_t *h)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < MATRIX_ANIM_HIST_BUCKETS; i++) n += h->b[i];
+    return n;
+}
+
+static const matrix_anim_fx_stats_t *fx_slot(const matrix_anim_stats_t *st, uint16_t id)
+{
+    for (uint32_t i = 0; i < MATRIX_ANIM_STATS_FX_MAX; i++) {
+        if (st->fx[i].effect_id == id) return &st->fx[i];
+    }
+    return NULL;
+}
+
+static void test_bucket_edges(void)
+{
+    static const struct { uint32_t us, bucket; } cases[] = {
+        { 0, 0 }, { 1, 0 }, { 2, 1 }, { 3, 1 }, { 4, 2 }, { 7, 2 }, { 8, 3 },
+        { 1023, 9 }, { 1024, 10 }, { 65535, 15 }, { 65536, 16 }, { 131071, 16 },
+        { 131072, MATRIX_ANIM_HIST_BUCKETS - 1u }, { UINT32_MAX, MATRIX_ANIM_HIST_BUCKETS - 1u },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        CHECK_EQ_U(matrix_anim_hist_bucket(cases[i].us), cases[i].bucket);
+    }
+}
+
+static void test_record_placement(void)
+{
+    matrix_anim_stats_t st;
+    CHECK(matrix_anim_stats_read(&st));
+    CHECK_EQ_U(st.frames, 0);
+
+    // кадр 1: blur сверх бюджета, bloom не шёл, без перехода; show отрицательный -> bucket 0
+    fx_post_timing_t post = { 0 };
+    post.ran = 1u << FX_POST_PASS_BLUR;
+    post.us[FX_POST_PASS_BLUR] = fx_post_budget_us(FX_POST_PASS_BLUR) + 1u;
+    matrix_anim_stats_record(FX_1, false, 0, 1000, 1500, &post, -1, 0, -5, 20000);
+
+    // кадр 2: промах, переход, post не шёл; interval = период
+    const fx_post_timing_t none = { 0 };
+    matrix_anim_stats_record(FX_2, true, 3, 1000 + FRAME_US, 3, &none, 700, 40, 150, 9);
+
+    CHECK(matrix_anim_stats_read(&st));
+    CHECK_EQ_U(st.frames, 2);
+    CHECK_EQ_U(st.misses, 1);
+    CHECK_EQ_U(st.drops, 3);
+
+    CHECK_EQ_U(st.render.b[10], 1);                      // 1500
+    CHECK_EQ_U(st.render.b[1], 1);                       // 3
+    CHECK_EQ_U(hist_sum(&st.render), 2);
+    CHECK_EQ_U(st.overlay.b[0], 1);                      // 0
+    CHECK_EQ_U(st.overlay.b[5], 1);                      // 40
+    CHECK_EQ_U(st.show.b[0], 1);                         // -5
+    CHECK_EQ_U(st.show.b[7], 1);                         // 150
+    CHECK_EQ_U(st.fence.b[14], 1);                       // 20000
+    CHECK_EQ_U(st.fence.b[3], 1);                        // 9
+
+    const uint32_t blur_b = matrix_anim_hist_bucket(post.us[FX_POST_PASS_BLUR]);
+    CHECK_EQ_U(st.post[FX_POST_PASS_BLUR].b[blur_b], 1);
+    CHECK_EQ_U(hist_sum(&st.post[FX_POST_PASS_BLUR]), 1);
+    CHECK_EQ_U(st.post_over[FX_POST_PASS_BLUR], 1);
+    CHECK_EQ_U(hist_sum(&st.post[FX_POST_PASS_BLOOM]), 0);
+    CHECK_EQ_U(st.post_over[FX_POST_PASS_BLOOM], 0);
+
+    CHECK_EQ_U(st.trans_frames, 1);
+    CHECK_EQ_U(st.trans_misses, 1);
+    CHECK_EQ_U(st.transition.b[9], 1);                   // 700
+    CHECK_EQ_U(hist_sum(&st.transition), 1);
+
+    CHECK_EQ_U(hist_sum(&st.interval), 1);               // первый кадр интервала не даёт
+    CHECK_EQ_U(st.interval.b[15], 1);                    // 45454
+
+    const matrix_anim_fx_stats_t *e1 = fx_slot(&st, FX_1);
+    const matrix_anim_fx_stats_t *e2 = fx_slot(&st, FX_2);
+    CHECK(e1 && e2);
+    if (e1 && e2) {
+        CHECK_EQ_U(e1->frames, 1);
+        CHECK_EQ_U(e1->misses, 0);
+        CHECK_EQ_U(e2->frames, 1);
+        CHECK_EQ_U(e2->misses, 1);
+    }
+}
+
+/* ---- seqlock: writer-поток против читателя ---- */
+
+static volatile int s_stop;
+
+static void *writer_main(void *arg)
+{
+    (void)arg;
+    const fx_post_timing_t none = { 0 };
+    int64_t tick = 1000000;
+    uint32_t n = 0;
+    while (!__atomic_load_n(&s_stop, __ATOMIC_ACQUIRE)) {
+        tick += FRAME_US;
+        n++;
+        // каждый кадр — промах и переход: misses/trans_* идут вместе с frames
+        matrix_anim_stats_record(FX_SEQ, true, n, tick, 100 + (n & 1023u), &none, 200, 50, 30, n & 4095u);
+        // writer непрерывно без пауз не даст читателю ни одной целой копии за 8 попыток
+        // (в лампе кадр раз в ~45 ms); 20 us — всё ещё тысячи пересечений с копией
+        usleep(20);
+    }
+    return NULL;
+}
+
+static void test_seqlock_snapshot(void)
+{
+    matrix_anim_stats_t base;
+    CHECK(matrix_anim_stats_read(&base));
+
+    pthread_t th;
+    s_stop = 0;
+    CHECK_EQ_U(pthread_create(&th, NULL, writer_main, NULL), 0);
+
+    uint32_t ok = 0, bad = 0;
+    uint32_t last_frames = base.frames;
+    static matrix_anim_stats_t st;
+    for (int i = 0; i < 200000; i++) {
+        if (!matrix_anim_stats_read(&st)) continue;
+        ok++;
+
+        const uint32_t frames = st.frames - base.frames;
+        const matrix_anim_fx_stats_t *e = fx_slot(&st, FX_SEQ);
+        const uint32_t fx_frames = e ? e->frames : 0u;
+        const uint32_t fx_misses = e ? e->misses : 0u;
+        if (hist_sum(&st.render)     != st.frames ||
+            hist_sum(&st.overlay)    != st.frames ||
+            hist_sum(&st.show)       != st.frames ||
+            hist_sum(&st.fence)      != st.frames ||
+            hist_sum(&st.interval)   != st.frames - 1u ||
+            st.misses - base.misses  != frames ||
+            st.trans_frames - base.trans_frames != frames ||
+            hist_sum(&st.transition) != st.trans_frames ||
+            fx_frames != frames || fx_misses != frames ||
+            st.drops != (frames ? frames : base.drops) ||
+            st.frames < last_frames) {
+            if (bad < 3) printf("  torn snapshot: frames=%u render=%u fx=%u drops=%u\n",
+                                (unsigned)st.frames, (unsigned)hist_sum(&st.render),
+                                (unsigned)fx_frames, (unsigned)st.drops);
+            bad++;
+        }
+        last_frames = st.frames;
+    }
+
+    __atomic_store_n(&s_stop, 1, __ATOMIC_RELEASE);
+    pthread_join(th, NULL);
+
+    CHECK(matrix_anim_stats_read(&st));
+    printf("seqlock: %u snapshots, writer %u frames\n", (unsigned)ok, (unsigned)(st.frames - base.frames));
+    CHECK(ok > 0u);
+    CHECK_EQ_U(bad, 0);
+}
+
+static void test_fx_table_full(void)
+{
+    matrix_anim_stats_t st0, st;
+    CHECK(matrix_anim_stats_read(&st0));
+
+    // таблица эффектов конечна: лишние id не получают слот, общие счётчики идут
+    for (uint16_t i = 0; i < MATRIX_ANIM_STATS_FX_MAX + 4u; i++) {
+        matrix_anim_stats_record((uint16_t)(0x3000u + i), false, st0.drops, 5000000000LL + i, 10, NULL,
+                                 -1, 10, 10, 10);
+    }
+    CHECK(matrix_anim_stats_read(&st));
+    CHECK_EQ_U(st.frames - st0.frames, MATRIX_ANIM_STATS_FX_MAX + 4u);
+
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < MATRIX_ANIM_STATS_FX_MAX; i++) {
+        if (st.fx[i].effect_id != 0) used++;
+    }
+    CHECK_EQ_U(used, MATRIX_ANIM_STATS_FX_MAX);
+    CHECK(fx_slot(&st, FX_1) != NULL);                  // старые слоты не вытесняются
+    CHECK(fx_slot(&st, 0x3000u + MATRIX_ANIM_STATS_FX_MAX + 3u) == NULL);
+}
+
+int main(void)
+{
+    test_bucket_edges();
+    test_record_placement();
+    test_seqlock_snapshot();
+    test_fx_table_full();
+    return host_test_done("test_matrix_anim_stats");
+}
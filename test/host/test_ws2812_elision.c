@@ -0,0 +1,179 @@
+/*
+ * test_ws2812_elision.c — static-frame elision при включённом dithering (user-005)
+ *
+ *   - статичный кадр (каждый кадр blit тех же байт) после одного округлённого вывода даёт
+ *     одинаковые байты в линии, и submit() перестаёт трогать RMT;
+ *   - округлённый вывод = ближайший 8-битный уровень 12-битной цели (не случайная фаза dithering);
+ *   - изменение одного пикселя или яркости снова запускает каскад;
+ *   - ниже MATRIX_WS2812_STATIC_DITHER_BRI статичный кадр продолжает dithering: в линию уходит
+ *     каждый кадр, среднее совпадает с 12-битной целью; на яркости 0 линия всё равно молчит.
+ */
+#include <math.h>
+
+#include "host_test.h"
+#include "host_rmt.h"
+
+#include "matrix_ws2812.h"
+
+#define FRAME_BYTES     ((uint32_t)MATRIX_W * MATRIX_H * 3u)
+#define WIRE_BYTES      (MATRIX_LEDS_TOTAL * 3u)
+#define N_FRAMES        64u
+
+static uint8_t s_rgb[FRAME_BYTES];
+
+static uint16_t target_g12(uint8_t v, uint8_t bri)
+{
+    const float lin = powf((float)v / 255.0f, 2.2f);
+    return (uint16_t)(lin * (float)bri * 16.0f + 0.5f);
+}
+
+static uint8_t rounded_out(uint8_t v, uint8_t bri)
+{
+    return (uint8_t)((target_g12(v, bri) + 8u) >> 4);
+}
+
+static void test_static_frame_is_stable(void)
+{
+    const uint8_t bri = 100;   // >= MATRIX_WS2812_STATIC_DITHER_BRI
+    for (uint32_t i = 0; i < FRAME_BYTES; i++) s_rgb[i] = (uint8_t)(i * 5u);
+
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    matrix_ws2812_set_brightness(bri);
+
+    // кадр 1: новый -> dithering; кадр 2: тот же -> округление (может уйти префикс); дальше тишина
+    matrix_ws2812_blit(s_rgb);
+    CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    matrix_ws2812_blit(s_rgb);
+    CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+
+    uint32_t sent = 0, skipped = 0;
+    matrix_ws2812_get_frame_counters(&sent, &skipped);
+    host_rmt_reset();
+    for (int f = 0; f < 50; f++) {
+        matrix_ws2812_blit(s_rgb);
+        CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    }
+    CHECK_EQ_U(g_host_rmt.transmits, 0);
+    uint32_t sent2 = 0, skipped2 = 0;
+    matrix_ws2812_get_frame_counters(&sent2, &skipped2);
+    CHECK_EQ_U(sent2, sent);
+    CHECK_EQ_U(skipped2 - skipped, 50);
+
+    // явный refresh статичного кадра: байты одинаковые и равны округлённой цели
+    static uint8_t first[WIRE_BYTES];
+    CHECK_EQ_U(matrix_ws2812_show(), ESP_OK);
+    memcpy(first, g_host_rmt.bytes, WIRE_BYTES);
+    uint32_t bad = 0;
+    for (int f = 0; f < 8; f++) {
+        matrix_ws2812_blit(s_rgb);
+        CHECK_EQ_U(matrix_ws2812_show(), ESP_OK);
+        if (memcmp(first, g_host_rmt.bytes, WIRE_BYTES) != 0) bad++;
+    }
+    CHECK_EQ_U(bad, 0);
+
+    bad = 0;
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const uint8_t *src = &s_rgb[((uint32_t)y * MATRIX_W + x) * 3u];
+            const uint8_t *w = &first[(uint32_t)matrix_ws2812_xy_to_index(x, y) * 3u];
+            if (w[0] != rounded_out(src[1], bri)) bad++;
+            if (w[1] != rounded_out(src[0], bri)) bad++;
+            if (w[2] != rounded_out(src[2], bri)) bad++;
+        }
+    }
+    CHECK_EQ_U(bad, 0);
+
+    // один пиксель изменился -> каскад снова идёт, уходит префикс до него
+    const uint16_t x = 3, y = 1;
+    const uint32_t led = matrix_ws2812_xy_to_index(x, y);
+    s_rgb[((uint32_t)y * MATRIX_W + x) * 3u] ^= 0x80u;
+    matrix_ws2812_blit(s_rgb);
+    host_rmt_reset();
+    CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    CHECK_EQ_U(g_host_rmt.transmits, 1);
+    CHECK(g_host_rmt.n_bytes >= (led + 1u) * 3u);
+
+    // и снова успокаивается
+    for (int f = 0; f < 2; f++) {
+        matrix_ws2812_blit(s_rgb);
+        CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    }
+    host_rmt_reset();
+    matrix_ws2812_blit(s_rgb);
+    CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    CHECK_EQ_U(g_host_rmt.transmits, 0);
+
+    // яркость на статичном кадре -> новый выход
+    matrix_ws2812_set_brightness(200);
+    host_rmt_reset();
+    matrix_ws2812_blit(s_rgb);
+    CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    CHECK_EQ_U(g_host_rmt.transmits, 1);
+
+    matrix_ws2812_deinit();
+}
+
+static void test_static_frame_low_bri_dithers(void)
+{
+    static uint32_t sum[WIRE_BYTES];
+    const uint8_t bri = 16;   // < MATRIX_WS2812_STATIC_DITHER_BRI
+    for (uint32_t i = 0; i < FRAME_BYTES; i++) s_rgb[i] = (uint8_t)(i * 5u);
+
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    matrix_ws2812_set_brightness(bri);
+    matrix_ws2812_blit(s_rgb);
+    CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+
+    // статичный кадр: каждый submit уходит в линию, wire-буфер — накопленное среднее
+    host_rmt_reset();
+    memset(sum, 0, sizeof(sum));
+    for (uint32_t f = 0; f < N_FRAMES; f++) {
+        matrix_ws2812_blit(s_rgb);
+        CHECK_EQ_U(matrix_ws2812_show(), ESP_OK);
+        for (uint32_t i = 0; i < WIRE_BYTES; i++) sum[i] += g_host_rmt.bytes[i];
+    }
+    CHECK_EQ_U(g_host_rmt.transmits, N_FRAMES);
+
+    uint32_t bad = 0;
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const uint8_t *src = &s_rgb[((uint32_t)y * MATRIX_W + x) * 3u];
+            const uint32_t *w = &sum[(uint32_t)matrix_ws2812_xy_to_index(x, y) * 3u];
+            const uint8_t v[3] = { src[1], src[0], src[2] };   // GRB
+            for (int c = 0; c < 3; c++) {
+                const int32_t want = (int32_t)N_FRAMES * target_g12(v[c], bri);
+                if (abs((int32_t)w[c] * 16 - want) >= 16) bad++;
+            }
+        }
+    }
+    CHECK_EQ_U(bad, 0);
+
+    // submit() без show(): "дышащий" кадр не пропускается
+    host_rmt_reset();
+    for (int f = 0; f < 8; f++) {
+        matrix_ws2812_blit(s_rgb);
+        CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    }
+    CHECK_EQ_U(g_host_rmt.transmits, 8);
+
+    // яркость 0 (пауза с погашенной матрицей): выход нулевой и не меняется -> тишина
+    matrix_ws2812_set_brightness(0);
+    matrix_ws2812_blit(s_rgb);
+    CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    host_rmt_reset();
+    for (int f = 0; f < 8; f++) {
+        matrix_ws2812_blit(s_rgb);
+        CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    }
+    CHECK_EQ_U(g_host_rmt.transmits, 0);
+
+    matrix_ws2812_deinit();
+}
+
+int main(void)
+{
+    g_host_rmt.no_encode = true;
+    test_static_frame_is_stable();
+    test_static_frame_low_bri_dithers();
+    return host_test_done("test_ws2812_elision");
+}
@@ -0,0 +1,206 @@
+/*
+ * test_ws2812_enc.c — RMT-энкодер WS2812 (user-003)
+ *
+ * Эталонный битстрим строится здесь независимо от энкодера: по битам байта от старшего
+ * к младшему, '1' = 0.9 us HIGH + 0.3 us LOW, '0' = 0.3 us HIGH + 0.9 us LOW, в конце
+ * reset = 280 us LOW. Проверяется:
+ *   - тайминги T0H/T0L/T1H/T1L и reset в тиках для разных resolution_hz;
+ *   - раскладка символа совпадает с rmt_symbol_word_t;
+ *   - порядок бит MSB first, байты в порядке буфера (GRB);
+ *   - ISR-callback при любой нарезке памяти канала даёт ровно эталон + один reset;
+ *   - драйвер: в линию уходит wire-буфер без копии, префикс — до старшего изменившегося LED.
+ */
+#include "host_test.h"
+#include "host_rmt.h"
+
+#include "matrix_ws2812.h"
+#include "matrix_ws2812_enc.h"
+#include "driver/rmt_tx.h"
+
+#define RES_HZ      (10u * 1000u * 1000u)
+
+typedef struct {
+    uint16_t d0; uint8_t l0;
+    uint16_t d1; uint8_t l1;
+} sym_t;
+
+static sym_t sym_of(uint32_t v)
+{
+    rmt_symbol_word_t w = { .val = v };
+    const sym_t s = { w.duration0, w.level0, w.duration1, w.level1 };
+    return s;
+}
+
+/* Эталон: длительности в десятых долях us -> тики */
+static uint32_t ref_symbol(uint32_t res_hz, uint32_t high_x10us, uint32_t low_x10us)
+{
+    rmt_symbol_word_t w = { .val = 0 };
+    w.duration0 = (uint16_t)(high_x10us * (res_hz / 100000u) / 100u);
+    w.level0 = 1;
+    w.duration1 = (uint16_t)(low_x10us * (res_hz / 100000u) / 100u);
+    w.level1 = 0;
+    return w.val;
+}
+
+static size_t ref_bitstream(uint32_t res_hz, const uint8_t *src, size_t n, uint32_t *out)
+{
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (int bit = 7; bit >= 0; bit--) {
+            out[k++] = ((src[i] >> bit) & 1u) ? ref_symbol(res_hz, 9, 3) : ref_symbol(res_hz, 3, 9);
+        }
+    }
+    return k;
+}
+
+static void test_timing(void)
+{
+    matrix_ws2812_enc_timing_t t;
+
+    matrix_ws2812_enc_timing_init(&t, RES_HZ);
+    sym_t b0 = sym_of(t.bit0), b1 = sym_of(t.bit1), rs = sym_of(t.reset);
+    // 10 MHz: тик 0.1 us
+    CHECK_EQ_U(b0.d0, 3);  CHECK_EQ_U(b0.l0, 1);  CHECK_EQ_U(b0.d1, 9);  CHECK_EQ_U(b0.l1, 0);   // T0H/T0L
+    CHECK_EQ_U(b1.d0, 9);  CHECK_EQ_U(b1.l0, 1);  CHECK_EQ_U(b1.d1, 3);  CHECK_EQ_U(b1.l1, 0);   // T1H/T1L
+    CHECK_EQ_U(rs.l0, 0);  CHECK_EQ_U(rs.l1, 0);
+    CHECK_EQ_U(rs.d0 + rs.d1, 2800);                                                           // 280 us LOW
+    // бит = 1.25 us при любой комбинации
+    CHECK_EQ_U(b0.d0 + b0.d1, 12);
+    CHECK_EQ_U(b1.d0 + b1.d1, 12);
+
+    matrix_ws2812_enc_timing_init(&t, 40u * 1000u * 1000u);
+    b0 = sym_of(t.bit0); b1 = sym_of(t.bit1); rs = sym_of(t.reset);
+    CHECK_EQ_U(b0.d0, 12); CHECK_EQ_U(b0.d1, 36);
+    CHECK_EQ_U(b1.d0, 36); CHECK_EQ_U(b1.d1, 12);
+    CHECK_EQ_U(rs.d0 + rs.d1, 11200);
+    CHECK(rs.d0 <= 0x7FFFu && rs.d1 <= 0x7FFFu);   // половины reset влезают в 15 бит
+}
+
+static void test_pack_layout(void)
+{
+    const uint32_t v = matrix_ws2812_enc_pack(0x1234, 1, 0x0567, 0);
+    const sym_t s = sym_of(v);
+    CHECK_EQ_U(s.d0, 0x1234); CHECK_EQ_U(s.l0, 1);
+    CHECK_EQ_U(s.d1, 0x0567); CHECK_EQ_U(s.l1, 0);
+    CHECK_EQ_U(matrix_ws2812_enc_pack(0x7FFF, 1, 0x7FFF, 1), 0xFFFFFFFFu);
+    CHECK_EQ_U(matrix_ws2812_enc_pack(0xFFFF, 0, 0, 0), 0x7FFFu);   // лишний бит не лезет в level0
+}
+
+static void test_bit_order(void)
+{
+    matrix_ws2812_enc_timing_t t;
+    matrix_ws2812_enc_timing_init(&t, RES_HZ);
+
+    uint32_t out[8];
+    matrix_ws2812_enc_byte(&t, 0x80, out);
+    CHECK_EQ_U(out[0], t.bit1);
+    for (int i = 1; i < 8; i++) CHECK_EQ_U(out[i], t.bit0);
+
+    matrix_ws2812_enc_byte(&t, 0x01, out);
+    for (int i = 0; i < 7; i++) CHECK_EQ_U(out[i], t.bit0);
+    CHECK_EQ_U(out[7], t.bit1);
+
+    // 0xA5 = 1010 0101
+    static const uint8_t want[8] = { 1, 0, 1, 0, 0, 1, 0, 1 };
+    matrix_ws2812_enc_byte(&t, 0xA5, out);
+    for (int i = 0; i < 8; i++) CHECK_EQ_U(out[i], want[i] ? t.bit1 : t.bit0);
+
+    // все 256 байт против эталона
+    uint8_t all[256];
+    for (int i = 0; i < 256; i++) all[i] = (uint8_t)i;
+    static uint32_t got[256 * 8], ref[256 * 8];
+    CHECK_EQ_U(matrix_ws2812_enc_bytes(&t, all, 256, got), 256 * 8);
+    CHECK_EQ_U(ref_bitstream(RES_HZ, all, 256, ref), 256 * 8);
+    CHECK_MEM(got, ref, sizeof(ref));
+}
+
+/* Callback энкодера через RMT: нарезка памяти канала не должна влиять на битстрим */
+static void test_isr_callback(void)
+{
+    static const uint8_t grb[] = { 0x00, 0xFF, 0x55, 0xAA, 0x0F, 0xF0, 0x81, 0x7E, 0x01 };
+    const size_t n = sizeof(grb);
+    static uint32_t ref[sizeof(grb) * 8u + 1u];
+    ref_bitstream(RES_HZ, grb, n, ref);
+
+    matrix_ws2812_enc_timing_t t;
+    matrix_ws2812_enc_timing_init(&t, RES_HZ);
+    ref[n * 8u] = t.reset;
+
+    rmt_channel_handle_t chan = NULL;
+    rmt_encoder_handle_t enc = NULL;
+    const rmt_tx_channel_config_t cc = { .resolution_hz = RES_HZ };
+    CHECK_EQ_U(rmt_new_tx_channel(&cc, &chan), ESP_OK);
+    CHECK_EQ_U(matrix_ws2812_enc_new(RES_HZ, &enc), ESP_OK);
+    const rmt_transmit_config_t tc = { 0 };
+
+    static const size_t chunks[] = { 8, 9, 15, 16, 17, 48, 64, 1024 };
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        g_host_rmt.chunk_symbols = chunks[c];
+        host_rmt_reset();
+        CHECK_EQ_U(rmt_transmit(chan, enc, grb, n, &tc), ESP_OK);
+        CHECK_EQ_U(g_host_rmt.n_symbols, n * 8u + 1u);
+        CHECK_MEM(g_host_rmt.symbols, ref, sizeof(ref));
+    }
+    g_host_rmt.chunk_symbols = 0;
+
+    // reset — последний и единственный LOW-LOW символ
+    const sym_t last = sym_of(g_host_rmt.symbols[n * 8u]);
+    CHECK_EQ_U(last.l0 | last.l1, 0);
+    CHECK_EQ_U(last.d0 + last.d1, 2800);
+
+    CHECK_EQ_U(matrix_ws2812_enc_new(0, &enc), ESP_ERR_INVALID_ARG);
+    (void)rmt_del_encoder(enc);
+    (void)rmt_del_channel(chan);
+}
+
+/* Драйвер: пиксель (x,y) -> LED xy_to_index, байты G R B, символы = эталон wire-буфера */
+static void test_driver_stream(void)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    matrix_ws2812_set_brightness(255);
+
+    const uint16_t x = 5, y = 20;
+    const uint32_t led = matrix_ws2812_xy_to_index(x, y);
+    matrix_ws2812_clear();
+    matrix_ws2812_set_pixel_xy(x, y, 0xFF, 0x00, 0x80);   // R G B; 0x80 -> 896 = 56*16, без остатка dithering
+    host_rmt_reset();
+    CHECK_EQ_U(matrix_ws2812_show(), ESP_OK);
+
+    CHECK_EQ_U(g_host_rmt.n_bytes, MATRIX_LEDS_TOTAL * 3u);
+    const uint8_t *p = &g_host_rmt.bytes[led * 3u];
+    CHECK_EQ_U(p[0], 0x00);           // G
+    CHECK_EQ_U(p[1], 0xFF);           // R
+    CHECK(p[2] > 0 && p[2] < 0x80);   // B после гаммы 2.2
+
+    static uint32_t ref[MATRIX_LEDS_TOTAL * 3u * 8u];
+    ref_bitstream(RES_HZ, g_host_rmt.bytes, g_host_rmt.n_bytes, ref);
+    CHECK_EQ_U(g_host_rmt.n_symbols, MATRIX_LEDS_TOTAL * 3u * 8u + 1u);
+    CHECK_MEM(g_host_rmt.symbols, ref, sizeof(ref));
+
+    // тот же кадр через submit: в цепочке уже он -> RMT не трогаем
+    host_rmt_reset();
+    CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    CHECK_EQ_U(g_host_rmt.transmits, 0);
+
+    // изменился один LED -> уходит префикс ровно до него
+    const uint16_t x2 = 9, y2 = 3;
+    const uint32_t led2 = matrix_ws2812_xy_to_index(x2, y2);
+    matrix_ws2812_set_pixel_xy(x2, y2, 0, 255, 0);
+    host_rmt_reset();
+    CHECK_EQ_U(matrix_ws2812_submit(), ESP_OK);
+    CHECK_EQ_U(g_host_rmt.transmits, 1);
+    CHECK_EQ_U(g_host_rmt.n_bytes, (led2 + 1u) * 3u);
+    CHECK_EQ_U(g_host_rmt.bytes[led2 * 3u + 0u], 255);
+
+    matrix_ws2812_deinit();
+}
+
+int main(void)
+{
+    test_timing();
+    test_pack_layout();
+    test_bit_order();
+    test_isr_callback();
+    test_driver_stream();
+    return host_test_done("test_ws2812_enc");
+}
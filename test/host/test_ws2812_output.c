@@ -0,0 +1,128 @@
+/*
+ * test_ws2812_output.c — выходной каскад gamma + яркость + temporal dithering (user-004)
+ *
+ *   - среднее выхода за N кадров совпадает с 12-битной целью gamma(v)*bri*16:
+ *     |16*sum - N*target| < 16 для каждого байта (error diffusion теряет меньше одного младшего бита);
+ *   - на ночной яркости различимых средних уровней больше, чем ступеней после простого округления;
+ *   - бенчмарк: scale_bri() baseline (деление на байт) против выходного каскада в submit().
+ */
+#include <math.h>
+
+#include "host_test.h"
+#include "host_rmt.h"
+
+#include "matrix_ws2812.h"
+#include "ref/ref_ws2812.h"
+
+#define FRAME_BYTES     (MATRIX_LEDS_TOTAL * 3u)
+#define N_FRAMES        64u
+
+/* Та же формула, что bri_lut_rebuild() (MATRIX_WS2812_GAMMA_X10 = 22) */
+static uint16_t target_g12(uint8_t v, uint8_t bri)
+{
+    const float lin = powf((float)v / 255.0f, 2.2f);
+    return (uint16_t)(lin * (float)bri * 16.0f + 0.5f);
+}
+
+/* LED 0 — "часовой": меняется каждый кадр, чтобы кадр не был статичным */
+#define SENTINEL_X      0
+#define SENTINEL_Y      0
+
+static uint32_t s_sum[FRAME_BYTES];
+
+static void run_average(uint8_t bri)
+{
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    matrix_ws2812_set_brightness(bri);
+
+    // байт цепочки i несёт значение (i*7) % 256: все уровни, на разных каналах/LED
+    const uint16_t s_idx = matrix_ws2812_xy_to_index(SENTINEL_X, SENTINEL_Y);
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const uint32_t i = (uint32_t)matrix_ws2812_xy_to_index(x, y) * 3u;
+            // set_pixel_xy(r, g, b) -> в цепочке G R B
+            matrix_ws2812_set_pixel_xy(x, y, (uint8_t)((i + 1u) * 7u), (uint8_t)(i * 7u), (uint8_t)((i + 2u) * 7u));
+        }
+    }
+
+    memset(s_sum, 0, sizeof(s_sum));
+    for (uint32_t f = 0; f < N_FRAMES; f++) {
+        matrix_ws2812_set_pixel_xy(SENTINEL_X, SENTINEL_Y, (uint8_t)(f * 37u), 0, 0);
+        CHECK_EQ_U(matrix_ws2812_show(), ESP_OK);
+        for (uint32_t i = 0; i < FRAME_BYTES; i++) s_sum[i] += g_host_rmt.bytes[i];
+    }
+
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < FRAME_BYTES; i++) {
+        if (i / 3u == s_idx) continue;
+        const int32_t want = (int32_t)N_FRAMES * target_g12((uint8_t)(i * 7u), bri);
+        const int32_t got  = (int32_t)s_sum[i] * 16;
+        if (abs(got - want) >= 16) {
+            if (bad < 5) printf("  bri=%u byte %u v=%u: sum*16=%d want=%d\n", (unsigned)bri, (unsigned)i,
+                                (unsigned)(uint8_t)(i * 7u), (int)got, (int)want);
+            bad++;
+        }
+    }
+    CHECK_EQ_U(bad, 0);
+
+    matrix_ws2812_deinit();
+}
+
+static void test_average_matches_target(void)
+{
+    static const uint8_t bris[] = { 4, 16, 32, 100, 255 };
+    for (size_t b = 0; b < sizeof(bris); b++) run_average(bris[b]);
+}
+
+static void test_low_brightness_levels(void)
+{
+    // ночная яркость: сколько разных уровней на 0..255 без dithering и в среднем с ним
+    const uint8_t bri = 16;
+    uint32_t rounded = 0, dithered = 0;
+    int last_r = -1, last_d = -1;
+    for (int v = 0; v < 256; v++) {
+        const uint16_t t = target_g12((uint8_t)v, bri);
+        const int r = (t + 8) >> 4;
+        if (r != last_r) { rounded++; last_r = r; }
+        if ((int)t != last_d) { dithered++; last_d = t; }
+    }
+    printf("bri=%u: levels rounded=%u dithered=%u\n", (unsigned)bri, (unsigned)rounded, (unsigned)dithered);
+    CHECK(dithered > rounded * 4u);
+}
+
+static void bench_output_stage(void)
+{
+    static uint8_t src[FRAME_BYTES], dst[FRAME_BYTES];
+    for (uint32_t i = 0; i < FRAME_BYTES; i++) src[i] = (uint8_t)(i * 13u);
+
+    CHECK_EQ_U(matrix_ws2812_init(0), ESP_OK);
+    matrix_ws2812_set_brightness(32);
+    ref_ws2812_set_brightness(32);
+    for (uint16_t y = 0; y < MATRIX_H; y++) {
+        for (uint16_t x = 0; x < MATRIX_W; x++) {
+            const uint8_t *p = &src[((uint32_t)y * MATRIX_W + x) * 3u];
+            matrix_ws2812_set_pixel_xy(x, y, p[0], p[1], p[2]);
+        }
+    }
+
+    g_host_rmt.no_encode = true;
+    double old_us, new_us;
+    HOST_BENCH(old_us, 2000, ref_ws2812_scale_bytes(src, dst, FRAME_BYTES); g_host_sink += dst[it_ & 255]);
+    // часовой в LED 0: каскад идёт по всему кадру, в "линию" — один LED
+    HOST_BENCH(new_us, 2000,
+               matrix_ws2812_set_pixel_xy(SENTINEL_X, SENTINEL_Y, (uint8_t)it_, 0, 0);
+               (void)matrix_ws2812_submit());
+    host_bench_report("brightness: scale_bri -> gamma12+dither", old_us, new_us);
+    g_host_rmt.no_encode = false;
+
+    matrix_ws2812_deinit();
+}
+
+int main(void)
+{
+    g_host_rmt.no_encode = true;
+    test_average_matches_target();
+    test_low_brightness_levels();
+    bench_output_stage();
+    return host_test_done("test_ws2812_output");
+}
@@ -0,0 +1,414 @@
+#!/usr/bin/env python3
+"""
+fx_clip_encode.py — PNG/GIF -> пакет клипов для раздела "anim" (main/fx_clip.h).
+
+    python tools/fx_clip_encode.py -o anim.bin fluid=render/fluid_*.png intro=intro.gif
+    python -m esptool --chip esp32s3 --port COM12 --baud 921600 write_flash 0x7C0000 anim.bin
+
+Каждый аргумент name=источник — один клип (имя до 11 символов, эффект CLIP играет первый).
+Источник — GIF или PNG-последовательность (glob, сортировка по имени). Кадры строго 16x48.
+Цвета клипа сводятся к общей палитре до 256 (median cut, если больше). Кадры — key (RLE)
+или delta к предыдущему (skip/run/literal), keyframe не реже --key-every.
+
+Отчёт: сжатие относительно сырого RGB и цена декода (байт/токенов на кадр — это то,
+что лампа прочитает из flash и обработает при смене кадра). После сборки пакет
+декодируется обратно и сверяется с исходными кадрами.
+"""
+
+import argparse
+import glob
+import os
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from fx_sprite_pack import read_png  # noqa: E402
+
+PACK_MAGIC = 0x4B50434A  # "JCPK"
+PACK_VERSION = 1
+NAME_LEN = 12
+W, H = 16, 48
+NPIX = W * H
+ANIM_PART_SIZE = 256 * 1024  # partitions/partitions_voice.csv: anim
+
+FRAME_KEY, FRAME_DELTA = 0, 1
+
+
+# ---------------- GIF ----------------
+
+def _lzw_decode(data, min_size, npix):
+    clear, eoi = 1 << min_size, (1 << min_size) + 1
+    size = min_size + 1
+    table = [bytes((i,)) for i in range(clear)] + [b"", b""]
+    out, prev = bytearray(), None
+    bitbuf = nbits = pos = 0
+    while len(out) < npix:
+        while nbits < size and pos < len(data):
+            bitbuf |= data[pos] << nbits
+            nbits += 8
+            pos += 1
+        if nbits < size:
+            break
+        code = bitbuf & ((1 << size) - 1)
+        bitbuf >>= size
+        nbits -= size
+        if code == clear:
+            size = min_size + 1
+            table = table[:clear + 2]
+            prev = None
+            continue
+        if code == eoi:
+            break
+        if code < len(table):
+            entry = table[code]
+            if prev is not None:
+                table.append(prev + entry[:1])
+        elif prev is not None:
+            entry = prev + prev[:1]
+            table.append(entry)
+        else:
+            raise ValueError("bad LZW stream")
+        out += entry
+        prev = entry
+        if len(table) == (1 << size) and size < 12:
+            size += 1
+    return bytes(out[:npix])
+
+
+def read_gif(path):
+    """-> (frames, delays_ms); frame = список h*w (r, g, b), y=0 — верх."""
+    with open(path, "rb") as f:
+        d = f.read()
+    if d[:6] not in (b"GIF87a", b"GIF89a"):
+        raise ValueError(f"{path}: not a GIF")
+    sw, sh, flags, bg, _ = struct.unpack("<HHBBB", d[6:13])
+    pos = 13
+    gct = None
+    if flags & 0x80:
+        n = 2 << (flags & 7)
+        gct = [tuple(d[pos + i * 3:pos + i * 3 + 3]) for i in range(n)]
+        pos += n * 3
+
+    canvas = [(0, 0, 0)] * (sw * sh)
+    frames, delays = [], []
+    gce_delay, gce_trans, gce_disp = 0, None, 0
+    while pos < len(d):
+        b = d[pos]
+        pos += 1
+        if b == 0x3B:
+            break
+        if b == 0x21:
+            label = d[pos]
+            pos += 1
+            blocks = b""
+            while d[pos]:
+                blocks += d[pos + 1:pos + 1 + d[pos]]
+                pos += 1 + d[pos]
+            pos += 1
+            if label == 0xF9 and len(blocks) >= 4:
+                pf, gce_delay, ti = struct.unpack("<BHB", blocks[:4])
+                gce_disp = (pf >> 2) & 7
+                gce_trans = ti if pf & 1 else None
+            continue
+        if b != 0x2C:
+            raise ValueError(f"{path}: bad block 0x{b:02X}")
+
+        ix, iy, iw, ih, pf = struct.unpack("<HHHHB", d[pos:pos + 9])
+        pos += 9
+        ct = gct
+        if pf & 0x80:
+            n = 2 << (pf & 7)
+            ct = [tuple(d[pos + i * 3:pos + i * 3 + 3]) for i in range(n)]
+            pos += n * 3
+        min_size = d[pos]
+        pos += 1
+        data = b""
+        while d[pos]:
+            data += d[pos + 1:pos + 1 + d[pos]]
+            pos += 1 + d[pos]
+        pos += 1
+
+        idx = _lzw_decode(data, min_size, iw * ih)
+        rows = list(range(ih))
+        if pf & 0x40:  # interlace
+            rows = list(range(0, ih, 8)) + list(range(4, ih, 8)) + list(range(2, ih, 4)) + list(range(1, ih, 2))
+
+        saved = list(canvas)
+        for n, y in enumerate(rows):
+            for x in range(iw):
+                i = n * iw + x
+                if i >= len(idx) or idx[i] == gce_trans:
+                    continue
+                cx, cy = ix + x, iy + y
+                if cx < sw and cy < sh:
+                    canvas[cy * sw + cx] = ct[idx[i]]
+
+        frames.append(list(canvas))
+        delays.append(gce_delay * 10)
+
+        if gce_disp == 2:
+            for y in range(iy, min(iy + ih, sh)):
+                for x in range(ix, min(ix + iw, sw)):
+                    canvas[y * sw + x] = (0, 0, 0)
+        elif gce_disp == 3:
+            canvas = saved
+        gce_delay, gce_trans, gce_disp = 0, None, 0
+
+    if (sw, sh) != (W, H):
+        raise ValueError(f"{path}: size {sw}x{sh}, need {W}x{H}")
+    return frames, delays
+
+
+def read_source(spec):
+    if spec.lower().endswith(".gif"):
+        return read_gif(spec)
+    paths = sorted(glob.glob(spec)) or [spec]
+    frames = []
+    for p in paths:
+        w, h, rows = read_png(p)
+        if (w, h) != (W, H):
+            raise ValueError(f"{p}: size {w}x{h}, need {W}x{H}")
+        frames.append([(r, g, b) if a else (0, 0, 0) for row in rows for (r, g, b, a) in row])
+    return frames, None
+
+
+# ---------------- palette ----------------
+
+def median_cut(counts, n):
+    boxes = [list(counts.items())]
+    while len(boxes) < n:
+        # делим самый "широкий" бокс с >1 цветом
+        best, best_rng, best_ch = None, -1, 0
+        for bi, box in enumerate(boxes):
+            if len(box) < 2:
+                continue
+            for ch in range(3):
+                vals = [c[ch] for c, _ in box]
+                rng = max(vals) - min(vals)
+                if rng > best_rng:
+                    best, best_rng, best_ch = bi, rng, ch
+        if best is None:
+            break
+        box = sorted(boxes.pop(best), key=lambda e: e[0][best_ch])
+        total = sum(w for _, w in box)
+        acc, cut = 0, 1
+        for i, (_, w) in enumerate(box):
+            acc += w
+            if acc * 2 >= total:
+                cut = min(max(i + 1, 1), len(box) - 1)
+                break
+        boxes += [box[:cut], box[cut:]]
+    pal = []
+    for box in boxes:
+        tw = sum(w for _, w in box)
+        pal.append(tuple(round(sum(c[ch] * w for c, w in box) / tw) for ch in range(3)))
+    return pal
+
+
+def build_palette(frames):
+    counts = {}
+    for fr in frames:
+        for c in fr:
+            counts[c] = counts.get(c, 0) + 1
+    if len(counts) <= 256:
+        pal = sorted(counts)
+        return pal, {c: i for i, c in enumerate(pal)}, False
+
+    pal = median_cut(counts, 256)
+    lut = {}
+    for c in counts:
+        lut[c] = min(range(len(pal)), key=lambda i: sum((c[k] - pal[i][k]) ** 2 for k in range(3)))
+    return pal, lut, True
+
+
+# ---------------- coding ----------------
+
+def enc_key(idx):
+    out, i = bytearray(), 0
+    while i < NPIX:
+        run = 1
+        while i + run < NPIX and run < 128 and idx[i + run] == idx[i]:
+            run += 1
+        if run >= 2:
+            out += bytes((0x80 | (run - 1), idx[i]))
+            i += run
+            continue
+        j = i + 1
+        while j < NPIX and j - i < 128 and not (j + 1 < NPIX and idx[j] == idx[j + 1]):
+            j += 1
+        out += bytes((j - i - 1,)) + bytes(idx[i:j])
+        i = j
+    return bytes(out)
+
+
+def enc_delta(prev, idx):
+    out, i = bytearray(), 0
+    while i < NPIX:
+        if idx[i] == prev[i]:
+            n = 1
+            while i + n < NPIX and n < 128 and idx[i + n] == prev[i + n]:
+                n += 1
+            if i + n < NPIX:  # хвост без изменений не пишем
+                out += bytes((n - 1,))
+            i += n
+            continue
+        run = 1
+        while i + run < NPIX and run < 64 and idx[i + run] == idx[i]:
+            run += 1
+        if run >= 3:
+            out += bytes((0x80 | (run - 1), idx[i]))
+            i += run
+            continue
+        j = i + 1
+        while (j < NPIX and j - i < 64 and idx[j] != prev[j]
+               and not (j + 2 < NPIX and idx[j] == idx[j + 1] == idx[j + 2])):
+            j += 1
+        out += bytes((0xC0 | (j - i - 1),)) + bytes(idx[i:j])
+        i = j
+    return bytes(out)
+
+
+def dec_frame(prev, blob):
+    """Эталонный декодер (как fx_clip.c) -> (индексы, число токенов)."""
+    idx, i, p, tokens = bytearray(prev), 0, 1, 0
+    if blob[0] == FRAME_KEY:
+        while i < NPIX and p < len(blob):
+            c = blob[p]
+            p += 1
+            tokens += 1
+            n = (c & 0x7F) + 1
+            if c & 0x80:
+                idx[i:i + n] = bytes((blob[p],)) * n
+                p += 1
+            else:
+                idx[i:i + n] = blob[p:p + n]
+                p += n
+            i += n
+    else:
+        while i < NPIX and p < len(blob):
+            c = blob[p]
+            p += 1
+            tokens += 1
+            if c < 0x80:
+                i += c + 1
+                continue
+            n = (c & 0x3F) + 1
+            if c < 0xC0:
+                idx[i:i + n] = bytes((blob[p],)) * n
+                p += 1
+            else:
+                idx[i:i + n] = blob[p:p + n]
+                p += n
+            i += n
+    return bytes(idx[:NPIX]), tokens
+
+
+def encode_clip(frames, fps, key_every):
+    pal, lut, quantized = build_palette(frames)
+    img = [bytes(lut[c] for c in fr) for fr in frames]
+
+    blobs, prev, since_key = [], None, 0
+    for fi, idx in enumerate(img):
+        key = bytes((FRAME_KEY,)) + enc_key(idx)
+        if prev is None or since_key + 1 >= key_every:
+            blob = key
+        else:
+            delta = bytes((FRAME_DELTA,)) + enc_delta(prev, idx)
+            blob = delta if len(delta) < len(key) else key
+        since_key = 0 if blob[0] == FRAME_KEY else since_key + 1
+        blobs.append(blob)
+        prev = idx
+
+    hdr_size = 16 + len(pal) * 3 + len(blobs) * 4
+    table, ofs = bytearray(), hdr_size
+    for b in blobs:
+        table += struct.pack("<I", ofs)
+        ofs += len(b)
+    size = ofs
+
+    out = bytearray(struct.pack("<BBHHHHHI", W, H, len(blobs), int(round(fps * 10)),
+                                len(pal), key_every, 0, size))
+    for c in pal:
+        out += bytes(c)
+    out += table
+    for b in blobs:
+        out += b
+    return bytes(out), pal, img, blobs, quantized
+
+
+def report(name, frames, pal, img, blobs, quantized, size, fps):
+    raw = NPIX * 3 * len(frames)
+
+    # сверка + цена декода (последовательное проигрывание: один кадр на смену)
+    prev, toks = bytes(NPIX), []
+    t0 = time.perf_counter()
+    for fi, b in enumerate(blobs):
+        prev, t = dec_frame(prev, b)
+        if prev != img[fi]:
+            sys.exit(f"{name}: frame {fi} does not round-trip")
+        toks.append(t)
+    dt = time.perf_counter() - t0
+
+    keys = sum(1 for b in blobs if b[0] == FRAME_KEY)
+    fb = [len(b) for b in blobs]
+    print(f"{name}: {len(frames)} frames @ {fps:g} fps, palette {len(pal)}{' (quantized)' if quantized else ''}, "
+          f"{keys} key")
+    print(f"  size {size} B vs raw RGB {raw} B -> ratio {raw / size:.1f}:1, {size * fps / len(frames) / 1024:.1f} KB/s")
+    print(f"  decode per frame: {sum(fb) / len(fb):.0f} B avg / {max(fb)} B max, "
+          f"{sum(toks) / len(toks):.0f} tokens avg / {max(toks)} max "
+          f"(+ {NPIX} px palette expand); host ref decoder {dt / len(blobs) * 1e6:.0f} us/frame")
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Encode GIF/PNG sequences into a clip pack for the anim partition")
+    ap.add_argument("clips", nargs="+", help="name=source (GIF or PNG glob)")
+    ap.add_argument("-o", "--output", required=True, help="output .bin")
+    ap.add_argument("--fps", type=float, help="frame rate (default: GIF delays, else 20)")
+    ap.add_argument("--key-every", type=int, default=48, help="max frames between keyframes")
+    ap.add_argument("--max-size", type=int, default=ANIM_PART_SIZE, help="partition size, bytes")
+    args = ap.parse_args()
+
+    clips = []
+    for spec in args.clips:
+        if "=" not in spec:
+            sys.exit(f"'{spec}': expected name=source")
+        name, src = spec.split("=", 1)
+        if not name or len(name.encode()) >= NAME_LEN:
+            sys.exit(f"'{name}': name must be 1..{NAME_LEN - 1} chars")
+
+        frames, delays = read_source(src)
+        if not frames:
+            sys.exit(f"{src}: no frames")
+        if len(frames) > 0xFFFF:
+            sys.exit(f"{src}: too many frames")
+
+        fps = args.fps
+        if fps is None:
+            d = [x for x in (delays or []) if x > 0]
+            fps = 1000.0 * len(d) / sum(d) if d else 20.0
+        fps = min(max(fps, 0.1), 6000.0)
+
+        blob, pal, img, blobs, quantized = encode_clip(frames, fps, max(1, args.key_every))
+        report(name, frames, pal, img, blobs, quantized, len(blob), fps)
+        clips.append((name, blob))
+
+    hdr_size = 12 + len(clips) * (NAME_LEN + 4)
+    table, body = bytearray(), bytearray()
+    for name, blob in clips:
+        table += name.encode().ljust(NAME_LEN, b"\0") + struct.pack("<I", hdr_size + len(body))
+        body += blob
+
+    total = hdr_size + len(body)
+    if total > args.max_size:
+        sys.exit(f"pack is {total} B, partition is {args.max_size} B")
+
+    with open(args.output, "wb") as f:
+        f.write(struct.pack("<IHHI", PACK_MAGIC, PACK_VERSION, len(clips), total))
+        f.write(table)
+        f.write(body)
+    print(f"{args.output}: {len(clips)} clips, {total} B")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""
+fx_sprite_pack.py — сборка пакета спрайтов для раздела "gfx" (main/fx_sprite.h).
+
+Вход:  PNG (8 бит/канал: RGB, RGBA, palette, grayscale; без interlace).
+Выход: бинарник пакета, который шьётся в раздел gfx:
+
+    python tools/fx_sprite_pack.py -o gfx.bin --key 000000 art/genie.png art/vol_*.png
+    python -m esptool --chip esp32s3 --port COM12 --baud 921600 write_flash 0x12000 gfx.bin
+
+Имя спрайта — имя файла без расширения (до 11 символов), по нему ищет fx_sprite_find().
+Цвета: каждый спрайт — своя палитра до 256 RGBA. Прозрачность — альфа PNG или --key
+(цвет, который станет a=0). Строки пишутся сверху вниз, RLE — как в fx_sprite.h.
+"""
+
+import argparse
+import glob
+import os
+import struct
+import sys
+import zlib
+
+PACK_MAGIC = 0x4B50534A  # "JSPK"
+PACK_VERSION = 1
+NAME_LEN = 12
+GFX_PART_SIZE = 16 * 1024  # partitions/partitions_voice.csv: gfx
+
+
+# ---------------- PNG ----------------
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    """-> (w, h, rows) где rows[y][x] = (r, g, b, a), y=0 — верх картинки."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError(f"{path}: not a PNG")
+
+    pos, idat, plte, trns = 8, b"", None, None
+    w = h = depth = ctype = interlace = None
+    while pos < len(data):
+        n, tag = struct.unpack(">I4s", data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + n]
+        pos += 12 + n
+        if tag == b"IHDR":
+            w, h, depth, ctype, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif tag == b"PLTE":
+            plte = body
+        elif tag == b"tRNS":
+            trns = body
+        elif tag == b"IDAT":
+            idat += body
+        elif tag == b"IEND":
+            break
+
+    if depth != 8 or interlace != 0 or ctype not in (0, 2, 3, 4, 6):
+        raise ValueError(f"{path}: need 8-bit non-interlaced PNG (got depth={depth} type={ctype})")
+
+    bpp = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[ctype]
+    raw = zlib.decompress(idat)
+    stride = w * bpp
+    prev = bytearray(stride)
+    rows = []
+    p = 0
+    for _ in range(h):
+        ft = raw[p]
+        line = bytearray(raw[p + 1:p + 1 + stride])
+        p += 1 + stride
+        for i in range(stride):
+            a = line[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if ft == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif ft == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif ft == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif ft == 4:
+                line[i] = (line[i] + _paeth(a, b, c)) & 0xFF
+        prev = line
+
+        px = []
+        for x in range(w):
+            s = line[x * bpp:(x + 1) * bpp]
+            if ctype == 0:
+                px.append((s[0], s[0], s[0], 255))
+            elif ctype == 2:
+                px.append((s[0], s[1], s[2], 255))
+            elif ctype == 3:
+                i = s[0]
+                r, g, b_ = plte[i * 3:i * 3 + 3]
+                alpha = trns[i] if trns and i < len(trns) else 255
+                px.append((r, g, b_, alpha))
+            elif ctype == 4:
+                px.append((s[0], s[0], s[0], s[1]))
+            else:
+                px.append((s[0], s[1], s[2], s[3]))
+        rows.append(px)
+    return w, h, rows
+
+
+# ---------------- sprite ----------------
+
+def rle_row(idx):
+    """Индексы строки -> RLE: повтор 0x80|(n-1), idx; литерал (n-1), idx*n. n <= 128."""
+    out = bytearray()
+    i, n = 0, len(idx)
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and idx[i + run] == idx[i]:
+            run += 1
+        if run >= 2:
+            out += bytes((0x80 | (run - 1), idx[i]))
+            i += run
+            continue
+        j = i + 1
+        # литерал до начала повтора из 2+ одинаковых
+        while j < n and j - i < 128 and not (j + 1 < n and idx[j] == idx[j + 1]):
+            j += 1
+        out += bytes((j - i - 1,)) + bytes(idx[i:j])
+        i = j
+    return bytes(out)
+
+
+def build_sprite(path, key):
+    w, h, rows = read_png(path)
+    if not (1 <= w <= 255 and 1 <= h <= 255):
+        raise ValueError(f"{path}: size {w}x{h} out of 1..255")
+
+    pal, lut, img = [], {}, []
+    for row in rows:
+        line = []
+        for (r, g, b, a) in row:
+            if key is not None and (r, g, b) == key:
+                a = 0
+            c = (0, 0, 0, 0) if a == 0 else (r, g, b, a)   # все прозрачные — один индекс
+            if c not in lut:
+                if len(pal) >= 256:
+                    raise ValueError(f"{path}: more than 256 colours")
+                lut[c] = len(pal)
+                pal.append(c)
+            line.append(lut[c])
+        img.append(line)
+
+    data, ofs = bytearray(), []
+    for line in img:
+        ofs.append(len(data))
+        data += rle_row(line)
+    if len(data) > 0xFFFF:
+        raise ValueError(f"{path}: RLE data too large")
+
+    out = bytearray(struct.pack("<BBBB", w, h, len(pal) & 0xFF, 0))
+    for c in pal:
+        out += bytes(c)
+    for o in ofs:
+        out += struct.pack("<H", o)
+    out += data
+    return out, w, h, len(pal)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Pack PNG sprites for the gfx partition")
+    ap.add_argument("inputs", nargs="+", help="PNG files")
+    ap.add_argument("-o", "--output", required=True, help="output .bin")
+    ap.add_argument("--key", help="colour key RRGGBB (becomes transparent)")
+    ap.add_argument("--max-size", type=int, default=GFX_PART_SIZE, help="partition size, bytes")
+    args = ap.parse_args()
+
+    key = None
+    if args.key:
+        k = int(args.key, 16)
+        key = ((k >> 16) & 0xFF, (k >> 8) & 0xFF, k & 0xFF)
+
+    # PowerShell не раскрывает *.png сам
+    paths = []
+    for pat in args.inputs:
+        paths += sorted(glob.glob(pat)) or [pat]
+
+    sprites, names = [], set()
+    for path in paths:
+        name = os.path.splitext(os.path.basename(path))[0]
+        if len(name.encode()) >= NAME_LEN:
+            sys.exit(f"{path}: name '{name}' longer than {NAME_LEN - 1} chars")
+        if name in names:
+            sys.exit(f"{path}: duplicate name '{name}'")
+        names.add(name)
+        blob, w, h, pn = build_sprite(path, key)
+        raw = w * h * 3
+        print(f"{name:<12} {w:3}x{h:<3} pal={pn:3} {len(blob):6} B (raw RGB {raw} B)")
+        sprites.append((name, blob))
+
+    hdr_size = 12 + len(sprites) * (NAME_LEN + 4)
+    table, body, ofs = bytearray(), bytearray(), hdr_size
+    for name, blob in sprites:
+        table += name.encode().ljust(NAME_LEN, b"\0") + struct.pack("<I", ofs + len(body))
+        body += blob
+
+    total = hdr_size + len(body)
+    if total > args.max_size:
+        sys.exit(f"pack is {total} B, partition is {args.max_size} B")
+
+    with open(args.output, "wb") as f:
+        f.write(struct.pack("<IHHI", PACK_MAGIC, PACK_VERSION, len(sprites), total))
+        f.write(table)
+        f.write(body)
+    print(f"{args.output}: {len(sprites)} sprites, {total} B")
+
+
+if __name__ == "__main__":
+    main()